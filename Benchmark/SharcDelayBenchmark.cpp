@@ -0,0 +1,1181 @@
+/*
+  SHARC Echo/Delay Effect Plugin - Offline Kernel Benchmark
+  JUCE 8.0.11 - Console application (juce_core, juce_audio_basics, juce_dsp)
+
+  Drives SharcDelayLine directly, without a host, and times the scalar
+  and SIMD kernels over a sweep of sample rates, block sizes, delay
+  lengths and feedback settings. The SIMD side uses the runtime-dispatched
+  kernel (Auto by default, or forced with --kernel).
+
+  Those runs are compute-bound: one delay line, whose ring mostly stays in
+  cache. --memory adds a memory-bound run of the SIMD kernel per
+  configuration: many delay lines processed round-robin, block by block,
+  like instances in a session, so every block's reads and writes miss.
+
+  "Sample" below always means one stereo frame, matching numSamples in
+  SharcEchoAudioProcessor::processBlock.
+
+  Usage:
+    SharcDelayBenchmark [--quick] [--json] [--output=<file>]
+                        [--seconds=<audio seconds per run>] [--repeats=<n>]
+                        [--kernel=auto|sse2|avx2|avx-512|neon]
+                        [--saturation=hard|soft|soft2x]
+                        [--lowcut=<Hz>] [--highcut=<Hz>]   (feedback filter, off by default)
+                        [--taps=<0..8>]   (output taps, spaced like the plugin defaults;
+                                           0 = feedback head only)
+                        [--memory[=<instances>]]   (memory-bound run, 64 lines by default)
+                        [--streaming=auto|always|never] [--nontemporal]
+                                          (long-delay prefetch threshold, and
+                                           non-temporal ring writes while past it)
+                        [--ring=float|int16]   (delay history format)
+                        [--cross=<0..1>] [--pingpong]   (stereo feedback routing)
+                        [--freeze]   (times the frozen loop, after the warm-up)
+    SharcDelayBenchmark --verify [--quick] [--kernel=...] [--tolerance=<abs>]
+                        [--budget=<kernel>=<ns>[,<kernel>=<ns>...]]
+                        [--seconds=...] [--repeats=...] [--saturation=...] ...
+
+  Output is CSV (default) or JSON, one record per configuration, so two
+  builds can be diffed or fed to a regression script.
+
+  --verify is the regression check. Every vector kernel the CPU supports
+  (or the one --kernel names) runs against the scalar kernel on odd block
+  sizes, delays shorter than a block and either side of the ring's wrap,
+  each interpolation and saturation mode, taps, the feedback filter, the
+  int16 ring, moving delays, cross feedback and ping-pong, a freeze and
+  its release, and unaligned, in-place and double I/O. The same runs on
+  SharcDelayBank (1, 3 and 8 rows, each with its own delay, feedback and
+  ramps) on the bank kernels. Any sample further apart than the tolerance
+  (1e-4 by default) fails. Then a stereo bus split into two one-row banks,
+  as offline renders split it, runs against the interleaved line on each
+  kernel, scalar included; it must match exactly wherever the blocks keep
+  the vector kernels aligned (see sideTolerance). Each
+  --budget then times that kernel ("scalar", "sse2", "avx2", "avx-512",
+  "neon") at 48 kHz, 256-frame blocks and 0.5 s delay, and fails if its
+  best ns/sample is over the limit; kernels the CPU lacks are skipped.
+  The exit code is 1 on any failure.
+*/
+
+#include <JuceHeader.h>
+#include "../SharcDelayBank.h"
+#include "../SharcMemoryPool.h"
+
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <memory>
+
+namespace
+{
+    //==============================================================================
+    struct BenchmarkSettings
+    {
+        bool quick = false;
+        bool json = false;
+        double secondsPerRun = 2.0;
+        int repeats = 5;
+        SharcKernelIsa kernel = SharcKernelIsa::automatic;
+        SharcSaturation saturation = SharcSaturation::hard;
+        float lowCutHz = SharcFeedbackFilter::lowCutOff;
+        float highCutHz = SharcFeedbackFilter::highCutOff;
+        int numTaps = 0;
+        int memoryInstances = 0;    // 0: compute-bound runs only
+        size_t streamingThreshold = SharcDelayLine::defaultStreamingThreshold;
+        bool nonTemporal = false;
+        SharcRingFormat ringFormat = SharcRingFormat::float32;
+        float cross = 0.0f;
+        bool pingPong = false;
+        bool freeze = false;
+        juce::String outputFile;
+    };
+
+    struct BenchmarkConfig
+    {
+        double sampleRate;
+        int blockSize;
+        float delaySeconds;
+        float feedback;
+    };
+
+    struct KernelTiming
+    {
+        double nsPerSample = 0.0;       // best of all repeats
+        double medianNsPerSample = 0.0;
+
+        // SharcMemoryPool while the run's lines were alive (memory-bound
+        // run only: the pool is trimmed first, so this is their rings)
+        size_t mappedBytes = 0;
+        size_t hugePageBytes = 0;
+    };
+
+    struct BenchmarkResult
+    {
+        BenchmarkConfig config;
+        int delaySamples;
+        KernelTiming scalar;
+        KernelTiming simd;
+        KernelTiming memory;        // SIMD, memoryInstances lines round-robin
+        int memoryInstances = 0;
+    };
+
+    enum class Kernel { scalar, simd };
+
+    // Option values, indexed by SharcSaturation
+    const char* const saturationNames[] { "hard", "soft", "soft2x" };
+
+    const char* getSaturationName(SharcSaturation mode)
+    {
+        return saturationNames[static_cast<int>(mode)];
+    }
+
+    //==============================================================================
+    // Sweep axes. Short delays wrap many times inside one block, 5 s is the
+    // plugin's maximum.
+    constexpr int maxBlockSize = 4096;
+
+    const std::vector<double> fullSampleRates { 44100.0, 48000.0, 96000.0, 192000.0 };
+    const std::vector<int> fullBlockSizes { 16, 32, 64, 128, 256, 512, 1024, 2048, maxBlockSize };
+    const std::vector<float> fullDelaySeconds { 0.001f, 0.0107f, 0.05f, 0.5f, 5.0f };
+    const std::vector<float> fullFeedbacks { 0.0f, 0.5f, 0.99f };
+
+    const std::vector<double> quickSampleRates { 48000.0, 192000.0 };
+    const std::vector<int> quickBlockSizes { 16, 256, maxBlockSize };
+    const std::vector<float> quickDelaySeconds { 0.001f, 0.5f, 5.0f };
+    const std::vector<float> quickFeedbacks { 0.5f };
+
+    // Ring memory of a memory-bound run, at most (fewer lines for long delays)
+    constexpr size_t maxMemoryBytes = size_t(1) << 30;
+
+    //==============================================================================
+    // Ring bytes of one line at this configuration's delay
+    size_t ringBytes(const BenchmarkConfig& config, SharcRingFormat format)
+    {
+        const int frames = juce::nextPowerOfTwo(static_cast<int>(std::ceil(config.delaySeconds * config.sampleRate)) + 1);
+        const size_t sampleBytes = format == SharcRingFormat::int16 ? sizeof(int16_t) : sizeof(float);
+        return static_cast<size_t>(frames) * SharcDelayLine::numChannels * sampleBytes;
+    }
+
+    // Taps spaced like the plugin defaults
+    SharcTapTable makeTaps(int numTaps)
+    {
+        SharcTapTable taps;
+        taps.numTaps = numTaps;
+
+        for (int i = 0; i < taps.numTaps; ++i)
+            taps.setTap(i, 1.0f - static_cast<float>(i) / SharcTapTable::maxTaps, 1.0f, 0.0f);
+
+        return taps;
+    }
+
+    // numLines > 1 is the memory-bound run: the lines take turns block by
+    // block, and a run processes the same audio in total as with one line
+    KernelTiming timeKernel(Kernel kernel, const BenchmarkConfig& config,
+        const BenchmarkSettings& settings, const juce::AudioBuffer<float>& input,
+        juce::AudioBuffer<float>& output, int numLines = 1)
+    {
+        const auto taps = makeTaps(settings.numTaps);
+        std::vector<std::unique_ptr<SharcDelayLine>> delayLines;
+
+        // Fresh blocks from the OS, not ones the compute-bound runs cached
+        if (numLines > 1)
+            SharcMemoryPool::trim();
+
+        for (int n = 0; n < numLines; ++n)
+        {
+            auto delayLine = std::make_unique<SharcDelayLine>();
+            delayLine->setKernel(settings.kernel);
+            delayLine->setSaturation(settings.saturation);
+            delayLine->setStreamingThreshold(settings.streamingThreshold);
+            delayLine->setNonTemporalWrites(settings.nonTemporal);
+            delayLine->setRingFormat(settings.ringFormat);
+
+            // The memory-bound run sizes each ring for its delay only
+            delayLine->prepare(config.sampleRate, 5.0f, numLines > 1 ? config.delaySeconds : -1.0f);
+            delayLine->setFeedbackFilter(settings.lowCutHz, settings.highCutHz);
+            delayLine->setTaps(taps);
+            delayLine->setDelaySeconds(config.delaySeconds);
+            delayLine->setFeedback(config.feedback);
+            delayLine->setWetMix(0.5f);
+            delayLine->setDryMix(0.5f);
+            delayLine->setCrossFeedback(settings.cross);
+            delayLine->setPingPong(settings.pingPong);
+            delayLines.push_back(std::move(delayLine));
+        }
+
+        const int inputLength = input.getNumSamples();
+        const int totalSamples = juce::jmax(config.blockSize,
+            static_cast<int>(config.sampleRate * settings.secondsPerRun));
+        const int numBlocks = juce::jmax(1, totalSamples / (config.blockSize * numLines));
+
+        auto runBlocks = [&]
+        {
+            int readPos = 0;
+
+            for (int b = 0; b < numBlocks; ++b)
+            {
+                if (readPos + config.blockSize > inputLength)
+                    readPos = 0;
+
+                const float* inL = input.getReadPointer(0, readPos);
+                const float* inR = input.getReadPointer(1, readPos);
+                float* outL = output.getWritePointer(0);
+                float* outR = output.getWritePointer(1);
+
+                for (auto& delayLine : delayLines)
+                {
+                    if (kernel == Kernel::simd)
+                        delayLine->processBlockSIMD(inL, inR, outL, outR, config.blockSize);
+                    else
+                        delayLine->processBlockScalar(inL, inR, outL, outR, config.blockSize);
+                }
+
+                readPos += config.blockSize;
+            }
+        };
+
+        // Warm-up pass: touches the whole ring and settles the feedback level
+        runBlocks();
+
+        // A frozen run loops what the warm-up left in the ring
+        if (settings.freeze)
+            for (auto& delayLine : delayLines)
+                delayLine->setFreeze(true);
+
+        std::vector<double> nsPerSample;
+        nsPerSample.reserve(static_cast<size_t>(settings.repeats));
+
+        for (int r = 0; r < settings.repeats; ++r)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            runBlocks();
+            const auto end = std::chrono::steady_clock::now();
+
+            const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+            nsPerSample.push_back(ns / (static_cast<double>(numBlocks) * config.blockSize * numLines));
+        }
+
+        std::sort(nsPerSample.begin(), nsPerSample.end());
+
+        KernelTiming timing;
+        timing.nsPerSample = nsPerSample.front();
+        timing.medianNsPerSample = nsPerSample[nsPerSample.size() / 2];
+
+        if (numLines > 1)
+        {
+            const auto pool = SharcMemoryPool::getStats();
+            timing.mappedBytes = pool.mappedBytes;
+            timing.hugePageBytes = pool.hugePageBytes;
+        }
+
+        return timing;
+    }
+
+    //==============================================================================
+    double megaSamplesPerSecond(double nsPerSample)
+    {
+        return nsPerSample > 0.0 ? 1000.0 / nsPerSample : 0.0;
+    }
+
+    double realtimeFactor(double nsPerSample, double sampleRate)
+    {
+        return nsPerSample > 0.0 ? 1.0e9 / (nsPerSample * sampleRate) : 0.0;
+    }
+
+    double speedup(const BenchmarkResult& r)
+    {
+        return r.simd.nsPerSample > 0.0 ? r.scalar.nsPerSample / r.simd.nsPerSample : 0.0;
+    }
+
+    // Memory-bound cost relative to compute-bound, SIMD kernel
+    double memorySlowdown(const BenchmarkResult& r)
+    {
+        return r.simd.nsPerSample > 0.0 ? r.memory.nsPerSample / r.simd.nsPerSample : 0.0;
+    }
+
+    double memoryWorkingSetMb(const BenchmarkResult& r, const BenchmarkSettings& settings)
+    {
+        return static_cast<double>(r.memoryInstances) * static_cast<double>(ringBytes(r.config, settings.ringFormat))
+             / (1024.0 * 1024.0);
+    }
+
+    double megabytes(size_t bytes)
+    {
+        return static_cast<double>(bytes) / (1024.0 * 1024.0);
+    }
+
+    juce::String formatCsv(const std::vector<BenchmarkResult>& results, const juce::String& kernelName,
+        const BenchmarkSettings& settings)
+    {
+        juce::String out = "kernel,saturation,low_cut_hz,high_cut_hz,taps,sample_rate,block_size,delay_s,delay_samples,feedback,"
+                           "scalar_ns_per_sample,scalar_median_ns_per_sample,scalar_msamples_per_s,scalar_realtime_x,"
+                           "simd_ns_per_sample,simd_median_ns_per_sample,simd_msamples_per_s,simd_realtime_x,"
+                           "speedup,"
+                           "memory_lines,memory_working_set_mb,memory_ns_per_sample,memory_median_ns_per_sample,"
+                           "memory_msamples_per_s,memory_slowdown,memory_mapped_mb,memory_huge_page_mb\n";
+
+        for (const auto& r : results)
+        {
+            const auto sr = r.config.sampleRate;
+
+            out << kernelName << ","
+                << getSaturationName(settings.saturation) << ","
+                << juce::String(settings.lowCutHz, 0) << ","
+                << juce::String(settings.highCutHz, 0) << ","
+                << settings.numTaps << ","
+                << juce::String(sr, 0) << ","
+                << r.config.blockSize << ","
+                << juce::String(r.config.delaySeconds, 4) << ","
+                << r.delaySamples << ","
+                << juce::String(r.config.feedback, 2) << ","
+                << juce::String(r.scalar.nsPerSample, 3) << ","
+                << juce::String(r.scalar.medianNsPerSample, 3) << ","
+                << juce::String(megaSamplesPerSecond(r.scalar.nsPerSample), 2) << ","
+                << juce::String(realtimeFactor(r.scalar.nsPerSample, sr), 1) << ","
+                << juce::String(r.simd.nsPerSample, 3) << ","
+                << juce::String(r.simd.medianNsPerSample, 3) << ","
+                << juce::String(megaSamplesPerSecond(r.simd.nsPerSample), 2) << ","
+                << juce::String(realtimeFactor(r.simd.nsPerSample, sr), 1) << ","
+                << juce::String(speedup(r), 3) << ","
+                << r.memoryInstances << ","
+                << juce::String(memoryWorkingSetMb(r, settings), 1) << ","
+                << juce::String(r.memory.nsPerSample, 3) << ","
+                << juce::String(r.memory.medianNsPerSample, 3) << ","
+                << juce::String(megaSamplesPerSecond(r.memory.nsPerSample), 2) << ","
+                << juce::String(memorySlowdown(r), 3) << ","
+                << juce::String(megabytes(r.memory.mappedBytes), 1) << ","
+                << juce::String(megabytes(r.memory.hugePageBytes), 1) << "\n";
+        }
+
+        return out;
+    }
+
+    juce::String formatJson(const std::vector<BenchmarkResult>& results, const juce::String& kernelName,
+        const BenchmarkSettings& settings)
+    {
+        juce::Array<juce::var> records;
+
+        for (const auto& r : results)
+        {
+            const auto sr = r.config.sampleRate;
+
+            auto kernelObject = [sr](const KernelTiming& t)
+            {
+                auto* obj = new juce::DynamicObject();
+                obj->setProperty("ns_per_sample", t.nsPerSample);
+                obj->setProperty("median_ns_per_sample", t.medianNsPerSample);
+                obj->setProperty("msamples_per_s", megaSamplesPerSecond(t.nsPerSample));
+                obj->setProperty("realtime_x", realtimeFactor(t.nsPerSample, sr));
+                return juce::var(obj);
+            };
+
+            auto* record = new juce::DynamicObject();
+            record->setProperty("sample_rate", sr);
+            record->setProperty("block_size", r.config.blockSize);
+            record->setProperty("delay_s", r.config.delaySeconds);
+            record->setProperty("delay_samples", r.delaySamples);
+            record->setProperty("feedback", r.config.feedback);
+            record->setProperty("scalar", kernelObject(r.scalar));
+            record->setProperty("simd", kernelObject(r.simd));
+            record->setProperty("speedup", speedup(r));
+
+            if (r.memoryInstances > 0)
+            {
+                auto memory = kernelObject(r.memory);
+                memory.getDynamicObject()->setProperty("lines", r.memoryInstances);
+                memory.getDynamicObject()->setProperty("working_set_mb", memoryWorkingSetMb(r, settings));
+                memory.getDynamicObject()->setProperty("slowdown", memorySlowdown(r));
+                memory.getDynamicObject()->setProperty("mapped_mb", megabytes(r.memory.mappedBytes));
+                memory.getDynamicObject()->setProperty("huge_page_mb", megabytes(r.memory.hugePageBytes));
+                record->setProperty("memory", memory);
+            }
+
+            records.add(juce::var(record));
+        }
+
+        auto* root = new juce::DynamicObject();
+        root->setProperty("benchmark", "SharcDelayLine");
+        root->setProperty("kernel", kernelName);
+        root->setProperty("saturation", getSaturationName(settings.saturation));
+        root->setProperty("low_cut_hz", settings.lowCutHz);
+        root->setProperty("high_cut_hz", settings.highCutHz);
+        root->setProperty("taps", settings.numTaps);
+        root->setProperty("non_temporal", settings.nonTemporal);
+        root->setProperty("ring", settings.ringFormat == SharcRingFormat::int16 ? "int16" : "float");
+        root->setProperty("cross", settings.cross);
+        root->setProperty("ping_pong", settings.pingPong);
+        root->setProperty("freeze", settings.freeze);
+        root->setProperty("results", records);
+        return juce::JSON::toString(juce::var(root));
+    }
+
+    //==============================================================================
+    std::vector<BenchmarkResult> runSweep(const BenchmarkSettings& settings)
+    {
+        const auto& sampleRates = settings.quick ? quickSampleRates : fullSampleRates;
+        const auto& blockSizes = settings.quick ? quickBlockSizes : fullBlockSizes;
+        const auto& delays = settings.quick ? quickDelaySeconds : fullDelaySeconds;
+        const auto& feedbacks = settings.quick ? quickFeedbacks : fullFeedbacks;
+
+        std::vector<BenchmarkResult> results;
+
+        for (auto sampleRate : sampleRates)
+        {
+            // One second of deterministic noise at -12 dBFS, reused for every run
+            juce::AudioBuffer<float> input(2, static_cast<int>(sampleRate));
+            juce::AudioBuffer<float> output(2, maxBlockSize);
+            juce::Random random(0x5ac);
+
+            for (int ch = 0; ch < input.getNumChannels(); ++ch)
+                for (int i = 0; i < input.getNumSamples(); ++i)
+                    input.setSample(ch, i, (random.nextFloat() * 2.0f - 1.0f) * 0.25f);
+
+            for (auto blockSize : blockSizes)
+                for (auto delaySeconds : delays)
+                    for (auto feedback : feedbacks)
+                    {
+                        BenchmarkConfig config { sampleRate, blockSize, delaySeconds, feedback };
+
+                        BenchmarkResult result;
+                        result.config = config;
+                        result.delaySamples = static_cast<int>(delaySeconds * sampleRate);
+                        result.scalar = timeKernel(Kernel::scalar, config, settings, input, output);
+                        result.simd = timeKernel(Kernel::simd, config, settings, input, output);
+
+                        if (settings.memoryInstances > 0)
+                        {
+                            result.memoryInstances = static_cast<int>(juce::jlimit(size_t(1), static_cast<size_t>(settings.memoryInstances),
+                                maxMemoryBytes / ringBytes(config, settings.ringFormat)));
+                            result.memory = timeKernel(Kernel::simd, config, settings, input, output, result.memoryInstances);
+                        }
+
+                        results.push_back(result);
+
+                        std::fprintf(stderr, "%6.0f Hz  block %4d  delay %7.4f s  fb %.2f  scalar %7.3f ns  simd %7.3f ns  x%.2f",
+                            sampleRate, blockSize, delaySeconds, feedback,
+                            result.scalar.nsPerSample, result.simd.nsPerSample, speedup(result));
+
+                        if (result.memoryInstances > 0)
+                            std::fprintf(stderr, "  memory %7.3f ns (%d lines, %.0f of %.0f MB on huge pages)",
+                                result.memory.nsPerSample, result.memoryInstances,
+                                megabytes(result.memory.hugePageBytes), megabytes(result.memory.mappedBytes));
+
+                        std::fprintf(stderr, "\n");
+                    }
+        }
+
+        return results;
+    }
+
+    //==============================================================================
+    // --verify: each supported vector kernel against the scalar one, on the
+    // cases where they are most likely to part ways, then the ns/sample
+    // budgets given with --budget. Either failing makes the exit code 1.
+    enum class VerifyIo { separate, unaligned, inPlace, doubles };
+
+    const char* const interpolationNames[] { "linear", "hermite", "lagrange", "allpass" };
+    const char* const verifyIoNames[] { "separate", "unaligned", "in place", "double" };
+
+    // What a case runs on: SharcDelayLine, a SharcDelayBank (the offline
+    // render groups), or a stereo bus split into two one-row banks, as an
+    // offline render splits it, against the interleaved line it replaces
+    enum class VerifyEngine { line, bank, stereoSides };
+
+    struct VerifyCase
+    {
+        int blockSize;
+        int delaySamples;
+        float feedback = 0.5f;
+        SharcInterpolation interpolation = SharcInterpolation::linear;
+        SharcSaturation saturation = SharcSaturation::hard;
+        int numTaps = 0;
+        bool filtered = false;
+        SharcRingFormat ringFormat = SharcRingFormat::float32;
+        bool moving = false;        // delay and feedback ramp in every block
+        float cross = 0.0f;         // ramps in every block when set
+        bool pingPong = false;
+        bool frozen = false;        // frozen from 3/8 of the run to 5/8, wet ramping
+        VerifyIo io = VerifyIo::separate;
+        VerifyEngine engine = VerifyEngine::line;
+        int numRows = 0;            // bank only; each row its own delay and feedback
+    };
+
+    struct VerifyResult
+    {
+        double maxError = 0.0;
+        int frame = 0;              // where maxError is
+    };
+
+    // Odd sizes leave a vector remainder in every block and move the host
+    // pointers off alignment; 16, 64 and 256 keep them aligned
+    const std::vector<int> verifyBlockSizes { 1, 3, 7, 16, 17, 31, 33, 64, 127, 129, 256, 509, 1021 };
+    const std::vector<int> quickVerifyBlockSizes { 1, 17, 64, 1021 };
+
+    // In frames, from SharcDelayLine::minDelaySamples up: shorter than most
+    // of the blocks, and either side of powers of two, where the ring and
+    // the read windows wrap
+    const std::vector<int> verifyDelays { 32, 33, 47, 63, 64, 65, 127, 129, 1023, 1024, 1025, 4097, 24000 };
+    const std::vector<int> quickVerifyDelays { 32, 65, 1025, 24000 };
+
+    // Bank sizes: one row, an odd count, and a 7.1 bus
+    const std::vector<int> verifyBankRows { 1, 3, 8 };
+
+    constexpr double verifySampleRate = 48000.0;
+    constexpr float verifyLowCutHz = 80.0f;
+    constexpr float verifyHighCutHz = 6000.0f;
+
+    // The kernels only differ by rounding (FMA, summation order): a few
+    // 1e-7 on the machines measured so far, feedback 0.99 included. An
+    // int16 ring can also store one code apart (1.5e-5 at this wet mix).
+    constexpr double defaultTolerance = 1.0e-4;
+
+    // Every case is one axis away from the base case of its engine
+    std::vector<VerifyCase> makeVerifyCases(const BenchmarkSettings& settings)
+    {
+        std::vector<VerifyCase> cases;
+
+        for (auto blockSize : settings.quick ? quickVerifyBlockSizes : verifyBlockSizes)
+        {
+            for (auto delay : settings.quick ? quickVerifyDelays : verifyDelays)
+            {
+                VerifyCase base { blockSize, delay };
+
+                auto add = [&](auto&& change)
+                {
+                    auto c = base;
+                    change(c);
+                    cases.push_back(c);
+                };
+
+                cases.push_back(base);
+                add([](VerifyCase& c) { c.feedback = 0.0f; });
+                add([](VerifyCase& c) { c.feedback = SharcDelayLine::maxFeedback; });
+
+                for (auto mode : { SharcInterpolation::hermite, SharcInterpolation::lagrange, SharcInterpolation::allpass })
+                    add([mode](VerifyCase& c) { c.interpolation = mode; });
+
+                for (auto mode : { SharcSaturation::soft, SharcSaturation::soft2x })
+                    add([mode](VerifyCase& c) { c.saturation = mode; });
+
+                add([](VerifyCase& c) { c.numTaps = 3; });
+                add([](VerifyCase& c) { c.filtered = true; });
+                add([](VerifyCase& c) { c.ringFormat = SharcRingFormat::int16; });
+                add([](VerifyCase& c) { c.moving = true; });
+                add([](VerifyCase& c) { c.cross = 0.4f; });
+                add([](VerifyCase& c) { c.pingPong = true; });
+                add([](VerifyCase& c) { c.frozen = true; });
+
+                for (auto io : { VerifyIo::unaligned, VerifyIo::inPlace, VerifyIo::doubles })
+                    add([io](VerifyCase& c) { c.io = io; });
+
+                // Banks and split sides: everything but the stereo coupling,
+                // which rows don't have
+                for (auto engine : { VerifyEngine::bank, VerifyEngine::stereoSides })
+                {
+                    base = VerifyCase { blockSize, delay };
+                    base.engine = engine;
+
+                    for (auto rows : engine == VerifyEngine::bank ? verifyBankRows : std::vector<int> { 1 })
+                    {
+                        base.numRows = rows;
+                        cases.push_back(base);
+                    }
+
+                    add([](VerifyCase& c) { c.feedback = SharcDelayLine::maxFeedback; });
+                    add([](VerifyCase& c) { c.interpolation = SharcInterpolation::allpass; });
+
+                    for (auto mode : { SharcSaturation::soft, SharcSaturation::soft2x })
+                        add([mode](VerifyCase& c) { c.saturation = mode; });
+
+                    add([](VerifyCase& c) { c.numTaps = 3; });
+                    add([](VerifyCase& c) { c.filtered = true; });
+                    add([](VerifyCase& c) { c.ringFormat = SharcRingFormat::int16; });
+                    add([](VerifyCase& c) { c.moving = true; });
+                    add([](VerifyCase& c) { c.frozen = true; });
+
+                    for (auto io : { VerifyIo::unaligned, VerifyIo::inPlace, VerifyIo::doubles })
+                        add([io](VerifyCase& c) { c.io = io; });
+                }
+            }
+        }
+
+        return cases;
+    }
+
+    juce::String describe(const VerifyCase& c)
+    {
+        const auto engine = c.engine == VerifyEngine::bank ? juce::String(c.numRows) + "-row bank, "
+                          : c.engine == VerifyEngine::stereoSides ? juce::String("stereo sides, ") : juce::String();
+
+        return engine + "block " + juce::String(c.blockSize) + ", delay " + juce::String(c.delaySamples)
+             + ", fb " + juce::String(c.feedback, 2) + ", " + interpolationNames[static_cast<int>(c.interpolation)]
+             + ", " + getSaturationName(c.saturation) + ", " + juce::String(c.numTaps) + " taps"
+             + (c.filtered ? ", filtered" : "") + (c.ringFormat == SharcRingFormat::int16 ? ", int16 ring" : "")
+             + (c.moving ? ", moving" : "") + (c.cross != 0.0f ? ", cross " + juce::String(c.cross, 2) : juce::String())
+             + (c.pingPong ? ", ping-pong" : "") + (c.frozen ? ", frozen" : "") + ", " + verifyIoNames[static_cast<int>(c.io)] + " I/O";
+    }
+
+    //==============================================================================
+    // One planar buffer per channel, with one spare sample in front: the
+    // unaligned case starts there. Noise for the first three quarters, then
+    // silence, so the tail and the silence tracker's sleep are covered too.
+    template <typename Sample>
+    struct VerifySignals
+    {
+        VerifySignals(const VerifyCase& c, int numChannels)
+            : numFrames(juce::jmax(16384, 8 * c.delaySamples)),
+              offset(c.io == VerifyIo::unaligned ? 1 : 0)
+        {
+            const auto size = static_cast<size_t>(numFrames + 1);
+            input.assign(static_cast<size_t>(numChannels), std::vector<Sample>(size));
+            reference = tested = input;
+
+            juce::Random random(0x5ac + c.delaySamples);
+
+            for (int i = 0; i < numFrames - numFrames / 4; ++i)
+                for (auto& channel : input)
+                    channel[static_cast<size_t>(i + offset)] = static_cast<Sample>((random.nextFloat() * 2.0f - 1.0f) * 0.5f);
+        }
+
+        // Channel pointers at `frame`
+        template <typename Pointer>
+        static std::vector<Pointer> at(std::vector<std::vector<Sample>>& channels, size_t frame)
+        {
+            std::vector<Pointer> pointers;
+
+            for (auto& channel : channels)
+                pointers.push_back(channel.data() + frame);
+
+            return pointers;
+        }
+
+        // In place: the tested output starts as a copy of the input
+        std::vector<Sample*> testedInPlace(size_t frame, int n)
+        {
+            for (size_t ch = 0; ch < input.size(); ++ch)
+                std::copy_n(input[ch].begin() + static_cast<std::ptrdiff_t>(frame), n,
+                            tested[ch].begin() + static_cast<std::ptrdiff_t>(frame));
+
+            return at<Sample*>(tested, frame);
+        }
+
+        VerifyResult compare() const
+        {
+            VerifyResult result;
+
+            for (int i = 0; i < numFrames; ++i)
+            {
+                const auto frame = static_cast<size_t>(i + offset);
+
+                for (size_t ch = 0; ch < input.size(); ++ch)
+                {
+                    const double error = std::abs(static_cast<double>(reference[ch][frame]) - static_cast<double>(tested[ch][frame]));
+
+                    // NaN counts as a failure
+                    if (!(error <= result.maxError))
+                    {
+                        result.maxError = std::isnan(error) ? std::numeric_limits<double>::infinity() : error;
+                        result.frame = i;
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        const int numFrames;
+        const int offset;
+        std::vector<std::vector<Sample>> input, reference, tested;
+    };
+
+    // Moving: a triangle between the delay and half of it (never past
+    // the ring's initial size), with the feedback swinging along
+    constexpr int swingPeriod = 8192;
+
+    double swing(int frame)
+    {
+        const double phase = static_cast<double>(frame % swingPeriod) / swingPeriod;
+        return 1.0 - 2.0 * std::abs(phase - 0.5);
+    }
+
+    // The ramps of the block at `start`; `phase` shifts the swing (bank
+    // rows each take their own)
+    SharcKernelParams verifyRamps(const VerifyCase& c, int start, int n, double delaySamples, float feedback, int phase = 0)
+    {
+        SharcKernelParams params;
+        params.feedback = feedback;
+        params.wet = 0.5f;
+        params.dry = 0.5f;
+        params.delay = delaySamples;
+        params.interpolation = c.interpolation;
+        params.saturation = c.saturation;
+        params.pingPong = c.pingPong;
+
+        const double from = swing(start + phase), to = swing(start + phase + n);
+
+        // Cross: between the setting and twice it; ping-pong at full
+        // cross, constant
+        if (c.cross != 0.0f)
+        {
+            params.cross = c.cross * static_cast<float>(1.0 + from);
+            params.crossStep = c.cross * static_cast<float>((to - from) / n);
+        }
+        else if (c.pingPong)
+        {
+            params.cross = 1.0f;
+        }
+
+        // Frozen: wet between the setting and half of it
+        if (c.frozen)
+        {
+            params.wet = 0.5f * static_cast<float>(1.0 - 0.5 * from);
+            params.wetStep = 0.5f * static_cast<float>(0.5 * (from - to) / n);
+        }
+
+        if (c.moving)
+        {
+            params.delay = delaySamples * (1.0 - 0.5 * from);
+            params.delayStep = delaySamples * 0.5 * (from - to) / n;
+            params.feedback = feedback * static_cast<float>(1.0 - 0.25 * from);
+            params.feedbackStep = feedback * static_cast<float>(0.25 * (from - to) / n);
+        }
+
+        return params;
+    }
+
+    // Taps panned apart, so the two sides of a split bus get different gains
+    SharcTapTable makePannedTaps(int numTaps)
+    {
+        auto taps = makeTaps(numTaps);
+
+        for (int i = 0; i < taps.numTaps; ++i)
+            taps.setTap(i, taps.ratio[i], 1.0f, i % 2 == 0 ? -0.6f : 0.3f);
+
+        return taps;
+    }
+
+    bool isFrozenAt(const VerifyCase& c, int start, int numFrames)
+    {
+        return c.frozen && start >= numFrames * 3 / 8 && start < numFrames * 5 / 8;
+    }
+
+    std::unique_ptr<SharcDelayLine> makeVerifyLine(const VerifyCase& c, SharcKernelIsa kernel, const SharcTapTable& taps)
+    {
+        auto line = std::make_unique<SharcDelayLine>();
+        line->setKernel(kernel);
+        line->setRingFormat(c.ringFormat);
+
+        // A ring sized for the delay, so it wraps many times in a run
+        line->prepare(verifySampleRate, 5.0f, static_cast<float>(c.delaySamples / verifySampleRate));
+
+        if (c.filtered)
+            line->setFeedbackFilter(verifyLowCutHz, verifyHighCutHz);
+
+        line->setTaps(taps);
+        return line;
+    }
+
+    std::unique_ptr<SharcDelayBank> makeVerifyBank(const VerifyCase& c, SharcKernelIsa kernel, int numRows,
+                                                   double longestDelay, const SharcTapTable& taps,
+                                                   SharcDelayBank::StereoSide side = SharcDelayBank::StereoSide::none)
+    {
+        auto bank = std::make_unique<SharcDelayBank>();
+        bank->setKernel(kernel);
+        bank->setRingFormat(c.ringFormat);
+        bank->setStereoSide(side);
+        bank->prepare(verifySampleRate, numRows, 5.0f, static_cast<float>(longestDelay / verifySampleRate));
+
+        if (c.filtered)
+            bank->setFeedbackFilter(verifyLowCutHz, verifyHighCutHz);
+
+        bank->setTaps(taps);
+        return bank;
+    }
+
+    //==============================================================================
+    // The scalar kernel and `isa` on the same input
+    template <typename Sample>
+    VerifyResult runVerifyLineCase(const VerifyCase& c, SharcKernelIsa isa)
+    {
+        const auto taps = makeTaps(c.numTaps);
+        auto reference = makeVerifyLine(c, SharcKernelIsa::scalar, taps);
+        auto tested = makeVerifyLine(c, isa, taps);
+        VerifySignals<Sample> signals(c, SharcDelayLine::numChannels);
+
+        for (int start = 0; start < signals.numFrames; start += c.blockSize)
+        {
+            const int n = juce::jmin(c.blockSize, signals.numFrames - start);
+            const auto at = static_cast<size_t>(start + signals.offset);
+            const auto params = verifyRamps(c, start, n, c.delaySamples, c.feedback);
+            const bool frozen = isFrozenAt(c, start, signals.numFrames);
+            const auto in = signals.template at<const Sample*>(signals.input, at);
+            const auto ref = signals.template at<Sample*>(signals.reference, at);
+
+            reference->setFreeze(frozen);
+            tested->setFreeze(frozen);
+            reference->setParameterRamps(params);
+            reference->processBlockScalar(in[0], in[1], ref[0], ref[1], n);
+
+            tested->setParameterRamps(params);
+
+            if (c.io == VerifyIo::inPlace)
+            {
+                const auto out = signals.testedInPlace(at, n);
+                tested->processBlockSIMD(out[0], out[1], n);
+            }
+            else
+            {
+                const auto out = signals.template at<Sample*>(signals.tested, at);
+                tested->processBlockSIMD(in[0], in[1], out[0], out[1], n);
+            }
+        }
+
+        return signals.compare();
+    }
+
+    // Rows a few frames apart, with their own feedback and swing phase
+    double bankRowDelay(const VerifyCase& c, int row) { return c.delaySamples + 7.0 * row; }
+    float bankRowFeedback(const VerifyCase& c, int row) { return c.feedback * (1.0f - 0.05f * static_cast<float>(row)); }
+
+    template <typename Sample>
+    VerifyResult runVerifyBankCase(const VerifyCase& c, SharcKernelIsa isa)
+    {
+        const auto taps = makeTaps(c.numTaps);
+        const double longest = bankRowDelay(c, c.numRows - 1);
+        auto reference = makeVerifyBank(c, SharcKernelIsa::scalar, c.numRows, longest, taps);
+        auto tested = makeVerifyBank(c, isa, c.numRows, longest, taps);
+        VerifySignals<Sample> signals(c, c.numRows);
+
+        for (int start = 0; start < signals.numFrames; start += c.blockSize)
+        {
+            const int n = juce::jmin(c.blockSize, signals.numFrames - start);
+            const auto at = static_cast<size_t>(start + signals.offset);
+            const bool frozen = isFrozenAt(c, start, signals.numFrames);
+
+            for (int row = 0; row < c.numRows; ++row)
+            {
+                const auto params = verifyRamps(c, start, n, bankRowDelay(c, row), bankRowFeedback(c, row), row * 1000);
+                reference->setChannelParameterRamps(row, params);
+                tested->setChannelParameterRamps(row, params);
+            }
+
+            reference->setFreeze(frozen);
+            tested->setFreeze(frozen);
+            reference->processBlockScalar(signals.template at<const Sample*>(signals.input, at).data(),
+                                          signals.template at<Sample*>(signals.reference, at).data(), n);
+
+            if (c.io == VerifyIo::inPlace)
+                tested->processBlockSIMD(signals.testedInPlace(at, n).data(), n);
+            else
+                tested->processBlockSIMD(signals.template at<const Sample*>(signals.input, at).data(),
+                                         signals.template at<Sample*>(signals.tested, at).data(), n);
+        }
+
+        return signals.compare();
+    }
+
+    // The line and the two side banks on the same kernel, `isa` (scalar
+    // included), as a realtime and an offline render of a stereo bus run
+    template <typename Sample>
+    VerifyResult runStereoSideCase(const VerifyCase& c, SharcKernelIsa isa)
+    {
+        const auto taps = makePannedTaps(c.numTaps);
+        const bool scalar = isa == SharcKernelIsa::scalar;
+        auto line = makeVerifyLine(c, isa, taps);
+        std::unique_ptr<SharcDelayBank> sides[] {
+            makeVerifyBank(c, isa, 1, c.delaySamples, taps, SharcDelayBank::StereoSide::left),
+            makeVerifyBank(c, isa, 1, c.delaySamples, taps, SharcDelayBank::StereoSide::right)
+        };
+        VerifySignals<Sample> signals(c, SharcDelayLine::numChannels);
+
+        for (int start = 0; start < signals.numFrames; start += c.blockSize)
+        {
+            const int n = juce::jmin(c.blockSize, signals.numFrames - start);
+            const auto at = static_cast<size_t>(start + signals.offset);
+            const auto params = verifyRamps(c, start, n, c.delaySamples, c.feedback);
+            const bool frozen = isFrozenAt(c, start, signals.numFrames);
+            const auto in = signals.template at<const Sample*>(signals.input, at);
+            const auto ref = signals.template at<Sample*>(signals.reference, at);
+            const auto out = c.io == VerifyIo::inPlace ? signals.testedInPlace(at, n)
+                                                       : signals.template at<Sample*>(signals.tested, at);
+
+            line->setFreeze(frozen);
+            line->setParameterRamps(params);
+
+            if (scalar)
+                line->processBlockScalar(in[0], in[1], ref[0], ref[1], n);
+            else
+                line->processBlockSIMD(in[0], in[1], ref[0], ref[1], n);
+
+            for (size_t side = 0; side < 2; ++side)
+            {
+                const Sample* sideIn[] { c.io == VerifyIo::inPlace ? out[side] : in[side] };
+                Sample* sideOut[] { out[side] };
+
+                sides[side]->setFreeze(frozen);
+                sides[side]->setParameterRamps(params);
+
+                if (scalar)
+                    sides[side]->processBlockScalar(sideIn, sideOut, n);
+                else
+                    sides[side]->processBlockSIMD(sideIn, sideOut, n);
+            }
+        }
+
+        return signals.compare();
+    }
+
+    // The split sides match the line bit for bit on the scalar kernel, and
+    // on the vector ones while every block starts on a vector boundary (the
+    // plugin's 128-frame sub-blocks do). Past an odd block or a freeze
+    // the line and the bank step different frames one at a time, and those
+    // round differently from the vector steps.
+    constexpr int widestVectorFrames = 16;  // AVX-512 bank rows
+
+    double sideTolerance(const VerifyCase& c, SharcKernelIsa isa, double tolerance)
+    {
+        const bool exact = isa == SharcKernelIsa::scalar || (c.blockSize % widestVectorFrames == 0 && !c.frozen);
+        return exact ? 0.0 : tolerance;
+    }
+
+    template <typename Sample>
+    VerifyResult runVerifyCase(const VerifyCase& c, SharcKernelIsa isa)
+    {
+        switch (c.engine)
+        {
+            case VerifyEngine::bank:        return runVerifyBankCase<Sample>(c, isa);
+            case VerifyEngine::stereoSides: return runStereoSideCase<Sample>(c, isa);
+            case VerifyEngine::line:        break;
+        }
+
+        return runVerifyLineCase<Sample>(c, isa);
+    }
+
+    // Kernel name (as --kernel, or "scalar") -> ns/sample limit
+    using Budgets = std::map<juce::String, double>;
+
+    // Every budget, timed on the sweep's reference configuration with the
+    // other options (saturation, taps, filter, ring) as given. The best of
+    // the repeats is compared, so a noisy machine needs more --repeats
+    // rather than a looser budget.
+    int checkBudgets(const Budgets& budgets, const BenchmarkSettings& settings)
+    {
+        const BenchmarkConfig config { 48000.0, 256, 0.5f, 0.5f };
+
+        juce::AudioBuffer<float> input(2, static_cast<int>(config.sampleRate));
+        juce::AudioBuffer<float> output(2, maxBlockSize);
+        juce::Random random(0x5ac);
+
+        for (int ch = 0; ch < input.getNumChannels(); ++ch)
+            for (int i = 0; i < input.getNumSamples(); ++i)
+                input.setSample(ch, i, (random.nextFloat() * 2.0f - 1.0f) * 0.25f);
+
+        int failures = 0;
+
+        for (const auto& [name, limit] : budgets)
+        {
+            auto kernelSettings = settings;
+            auto kernel = Kernel::scalar;
+
+            if (!name.equalsIgnoreCase("scalar"))
+            {
+                auto isa = SharcKernelIsa::automatic;
+
+                for (auto candidate : { SharcKernelIsa::sse2, SharcKernelIsa::avx2, SharcKernelIsa::avx512, SharcKernelIsa::neon })
+                    if (name.equalsIgnoreCase(SharcDelayKernels::getName(candidate)))
+                        isa = candidate;
+
+                // A budget for a kernel this CPU (or build) lacks is not a failure
+                if (isa == SharcKernelIsa::automatic || !SharcDelayKernels::isSupported(isa))
+                {
+                    std::fprintf(stderr, "budget %-8s skipped (not available)\n", name.toRawUTF8());
+                    continue;
+                }
+
+                kernelSettings.kernel = isa;
+                kernel = Kernel::simd;
+            }
+
+            const auto timing = timeKernel(kernel, config, kernelSettings, input, output);
+            const bool ok = timing.nsPerSample <= limit;
+            failures += ok ? 0 : 1;
+
+            std::fprintf(stderr, "budget %-8s %7.3f ns/sample (limit %.3f)  %s\n", name.toRawUTF8(),
+                timing.nsPerSample, limit, ok ? "ok" : "OVER");
+        }
+
+        return failures;
+    }
+
+    int runVerify(const BenchmarkSettings& settings, const Budgets& budgets, double tolerance)
+    {
+        // Scalar too, but only for the split sides, which compare a kernel
+        // with itself
+        std::vector<SharcKernelIsa> kernels { SharcKernelIsa::scalar };
+
+        for (auto isa : { SharcKernelIsa::sse2, SharcKernelIsa::avx2, SharcKernelIsa::avx512, SharcKernelIsa::neon })
+            if (SharcDelayKernels::isSupported(isa) && (settings.kernel == SharcKernelIsa::automatic || settings.kernel == isa))
+                kernels.push_back(isa);
+
+        const auto cases = makeVerifyCases(settings);
+        int failures = 0;
+
+        for (auto isa : kernels)
+        {
+            double worst = 0.0;
+            int numCases = 0, kernelFailures = 0;
+
+            for (const auto& c : cases)
+            {
+                const bool sides = c.engine == VerifyEngine::stereoSides;
+
+                if (isa == SharcKernelIsa::scalar && !sides)
+                    continue;
+
+                const auto result = c.io == VerifyIo::doubles ? runVerifyCase<double>(c, isa) : runVerifyCase<float>(c, isa);
+                const double limit = sides ? sideTolerance(c, isa, tolerance) : tolerance;
+                ++numCases;
+
+                if (!sides)
+                    worst = juce::jmax(worst, result.maxError);
+
+                if (result.maxError > limit)
+                {
+                    ++kernelFailures;
+                    std::fprintf(stderr, "FAIL %s: %s: error %.3g at frame %d (tolerance %.3g)\n", SharcDelayKernels::getName(isa),
+                        describe(c).toRawUTF8(), result.maxError, result.frame, limit);
+                }
+            }
+
+            std::fprintf(stderr, "%-8s %d cases, %d failed, worst error %.3g\n", SharcDelayKernels::getName(isa),
+                numCases, kernelFailures, worst);
+            failures += kernelFailures;
+        }
+
+        if (kernels.size() == 1)
+            std::fprintf(stderr, "No vector kernel on this CPU: only the split sides were compared\n");
+
+        failures += checkBudgets(budgets, settings);
+        std::printf("%s\n", failures == 0 ? "verify: passed" : "verify: FAILED");
+        return failures == 0 ? 0 : 1;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    BenchmarkSettings settings;
+    settings.quick = args.containsOption("--quick");
+    settings.json = args.containsOption("--json");
+
+    if (args.containsOption("--seconds"))
+        settings.secondsPerRun = juce::jmax(0.01, args.getValueForOption("--seconds").getDoubleValue());
+
+    if (args.containsOption("--repeats"))
+        settings.repeats = juce::jmax(1, args.getValueForOption("--repeats").getIntValue());
+
+    if (args.containsOption("--kernel"))
+    {
+        const auto name = args.getValueForOption("--kernel");
+
+        for (auto isa : { SharcKernelIsa::automatic, SharcKernelIsa::sse2, SharcKernelIsa::avx2,
+                          SharcKernelIsa::avx512, SharcKernelIsa::neon })
+            if (name.equalsIgnoreCase(SharcDelayKernels::getName(isa)))
+                settings.kernel = isa;
+    }
+
+    if (args.containsOption("--saturation"))
+    {
+        const auto name = args.getValueForOption("--saturation");
+
+        for (auto mode : { SharcSaturation::hard, SharcSaturation::soft, SharcSaturation::soft2x })
+            if (name.equalsIgnoreCase(getSaturationName(mode)))
+                settings.saturation = mode;
+    }
+
+    if (args.containsOption("--lowcut"))
+        settings.lowCutHz = static_cast<float>(args.getValueForOption("--lowcut").getDoubleValue());
+
+    if (args.containsOption("--highcut"))
+        settings.highCutHz = static_cast<float>(args.getValueForOption("--highcut").getDoubleValue());
+
+    if (args.containsOption("--taps"))
+        settings.numTaps = juce::jlimit(0, SharcTapTable::maxTaps, args.getValueForOption("--taps").getIntValue());
+
+    if (args.containsOption("--memory"))
+    {
+        const auto lines = args.getValueForOption("--memory").getIntValue();
+        settings.memoryInstances = lines > 0 ? lines : 64;
+    }
+
+    if (args.containsOption("--streaming"))
+    {
+        const auto mode = args.getValueForOption("--streaming");
+
+        if (mode.equalsIgnoreCase("always"))
+            settings.streamingThreshold = 0;
+        else if (mode.equalsIgnoreCase("never"))
+            settings.streamingThreshold = std::numeric_limits<size_t>::max();
+    }
+
+    settings.nonTemporal = args.containsOption("--nontemporal");
+
+    if (args.getValueForOption("--ring").equalsIgnoreCase("int16"))
+        settings.ringFormat = SharcRingFormat::int16;
+
+    if (args.containsOption("--cross"))
+        settings.cross = juce::jlimit(0.0f, 1.0f, static_cast<float>(args.getValueForOption("--cross").getDoubleValue()));
+
+    settings.pingPong = args.containsOption("--pingpong");
+    settings.freeze = args.containsOption("--freeze");
+
+    if (args.containsOption("--output"))
+        settings.outputFile = args.getValueForOption("--output");
+
+    juce::ScopedNoDenormals noDenormals;
+
+    if (args.containsOption("--verify"))
+    {
+        const double tolerance = args.containsOption("--tolerance")
+                                     ? juce::jmax(0.0, args.getValueForOption("--tolerance").getDoubleValue())
+                                     : defaultTolerance;
+
+        Budgets budgets;
+
+        for (const auto& budget : juce::StringArray::fromTokens(args.getValueForOption("--budget"), ",", {}))
+            if (budget.contains("="))
+                budgets[budget.upToFirstOccurrenceOf("=", false, false).trim().toLowerCase()]
+                    = budget.fromFirstOccurrenceOf("=", false, false).getDoubleValue();
+
+        return runVerify(settings, budgets, tolerance);
+    }
+
+    const juce::String kernelName = SharcDelayKernels::getName(SharcDelayKernels::resolve(settings.kernel));
+    std::fprintf(stderr, "SIMD kernel: %s, saturation: %s, feedback filter: %.0f / %.0f Hz, taps: %d, non-temporal writes: %s, ring: %s, "
+                         "cross: %.2f, ping-pong: %s, freeze: %s\n",
+        kernelName.toRawUTF8(), getSaturationName(settings.saturation), settings.lowCutHz, settings.highCutHz, settings.numTaps,
+        settings.nonTemporal ? "on" : "off", settings.ringFormat == SharcRingFormat::int16 ? "int16" : "float",
+        settings.cross, settings.pingPong ? "on" : "off", settings.freeze ? "on" : "off");
+
+    const auto results = runSweep(settings);
+    const auto report = settings.json ? formatJson(results, kernelName, settings)
+                                      : formatCsv(results, kernelName, settings);
+
+    if (settings.outputFile.isNotEmpty())
+    {
+        juce::File file = juce::File::getCurrentWorkingDirectory().getChildFile(settings.outputFile);
+
+        if (!file.replaceWithText(report))
+        {
+            std::fprintf(stderr, "Could not write %s\n", file.getFullPathName().toRawUTF8());
+            return 1;
+        }
+    }
+    else
+    {
+        std::printf("%s\n", report.toRawUTF8());
+    }
+
+    return 0;
+}
@@ -0,0 +1,512 @@
+/*
+  SHARC Echo/Delay Effect Plugin - Headless Batch Processor
+  JUCE 8.0.11 - Console application (juce_core, juce_events, juce_audio_basics,
+  juce_audio_formats, juce_audio_processors, juce_gui_basics, juce_dsp)
+
+  Runs audio files through SharcEchoAudioProcessor without a host: the
+  same parameter layout, state format, sub-block schedule and kernels as
+  the plugin, so the output is what a host bounce of the same settings
+  produces and can be used as a QA reference. Build it with the plugin
+  sources (PluginProcessor.cpp, PluginEditor.cpp, SharcTelemetryView.cpp,
+  SharcDelayKernels*.cpp, SharcMemoryPool.cpp, SharcRealtimeChecker.cpp);
+  the editor is linked but never created.
+
+  Files are read in fixed chunks of --block frames, through a
+  memory-mapped reader where the format has one (WAV, AIFF), and written
+  as WAV. Each file gets its own processor on a thread pool (--jobs).
+  The main thread runs the message loop, which grows delay rings and
+  frees retired memory for every processor, as a host's message thread
+  would.
+
+  Usage:
+    SharcEchoConsole [options] <file or folder>...
+      --output=<folder>       (default: next to each input)
+      --suffix=<text>         (appended to the output name, default "_echo")
+      --state=<file>          (getStateInformation() blob or APVTS XML preset)
+      --set=<id>=<value>[,<id>=<value>...]   (parameter overrides, in the
+                                              parameter's own units)
+      --bpm=<tempo>           (host tempo for "Tempo Sync", default none)
+      --block=<frames>        (host buffer size, default 512)
+      --tail=auto|none|<seconds>   (silence appended after the input;
+                                    auto: until the tail is below "Tail Floor";
+                                    none while frozen, the loop never ends)
+      --bits=16|24|32         (output WAV; 32 is float, the default)
+      --realtime              (the playback path instead of a host bounce,
+                               see SharcEchoAudioProcessor::prepareToPlay)
+      --double                (64-bit host buffers)
+      --jobs=<n>              (files processed at once, default: cores)
+      --list-parameters       (IDs, ranges and defaults, then exit)
+    SharcEchoConsole --verify
+
+  --verify runs the processor-level checks the kernel benchmark can't
+  make: states saved by the first builds load with their meaning intact.
+  One line per check; the exit code is 1 on any failure.
+*/
+
+#include <JuceHeader.h>
+#include "../PluginProcessor.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <utility>
+
+namespace
+{
+    //==============================================================================
+    struct ConsoleSettings
+    {
+        juce::File outputFolder;
+        juce::String suffix = "_echo";
+        juce::MemoryBlock state;
+        juce::StringPairArray overrides;
+        double bpm = 0.0;
+        int blockSize = 512;
+        double tailSeconds = -1.0;  // < 0: the processor's tail
+        int bitsPerSample = 32;
+        bool realtime = false;
+        bool doublePrecision = false;
+    };
+
+    // --bpm: a host tempo for sync; free delay times otherwise
+    class ConsolePlayHead : public juce::AudioPlayHead
+    {
+    public:
+        ConsolePlayHead(double tempo, double sampleRate) : bpm(tempo), rate(sampleRate) {}
+
+        void advance(int numSamples) noexcept { samples += numSamples; }
+
+        juce::Optional<PositionInfo> getPosition() const override
+        {
+            PositionInfo info;
+            info.setIsPlaying(true);
+            info.setTimeInSamples(samples);
+            info.setTimeInSeconds(static_cast<double>(samples) / rate);
+
+            if (bpm > 0.0)
+                info.setBpm(bpm);
+
+            return info;
+        }
+
+    private:
+        double bpm, rate;
+        juce::int64 samples = 0;
+    };
+
+    //==============================================================================
+    // A state file is either a getStateInformation() blob (binary or
+    // XML-in-binary) or a plain APVTS XML preset
+    void applyState(SharcEchoAudioProcessor& processor, const ConsoleSettings& settings)
+    {
+        if (settings.state.getSize() > 0)
+        {
+            const auto* text = static_cast<const char*>(settings.state.getData());
+
+            if (text[0] == '<')
+            {
+                if (auto xml = juce::parseXML(settings.state.toString()))
+                    if (xml->hasTagName(processor.getAPVTS().state.getType()))
+                        processor.getAPVTS().replaceState(juce::ValueTree::fromXml(*xml));
+            }
+            else
+            {
+                processor.setStateInformation(settings.state.getData(), static_cast<int>(settings.state.getSize()));
+            }
+        }
+
+        for (const auto& id : settings.overrides.getAllKeys())
+        {
+            if (auto* parameter = processor.getAPVTS().getParameter(id))
+                parameter->setValueNotifyingHost(parameter->convertTo0to1(settings.overrides[id].getFloatValue()));
+            else
+                std::fprintf(stderr, "Unknown parameter: %s\n", id.toRawUTF8());
+        }
+    }
+
+    std::unique_ptr<juce::AudioFormatReader> openReader(juce::AudioFormatManager& formats, const juce::File& file)
+    {
+        // Memory-mapped where the format supports it: the chunks are then
+        // copies out of the page cache, with no read calls
+        if (auto* format = formats.findFormatForFileExtension(file.getFileExtension()))
+        {
+            std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped(format->createMemoryMappedReader(file));
+
+            if (mapped != nullptr && mapped->mapEntireFile())
+                return mapped;
+        }
+
+        return std::unique_ptr<juce::AudioFormatReader>(formats.createReaderFor(file));
+    }
+
+    template <typename SampleType>
+    bool render(SharcEchoAudioProcessor& processor, ConsolePlayHead& playHead, juce::AudioFormatReader& reader,
+                juce::AudioFormatWriter& writer, const ConsoleSettings& settings)
+    {
+        const int numChannels = static_cast<int>(reader.numChannels);
+        const int blockSize = settings.blockSize;
+
+        juce::AudioBuffer<float> input(numChannels, blockSize);
+        juce::AudioBuffer<SampleType> buffer(numChannels, blockSize);
+        juce::AudioBuffer<float> output(numChannels, blockSize);
+        juce::MidiBuffer midi;
+
+        auto processChunk = [&](int numSamples) -> bool
+        {
+            buffer.setSize(numChannels, numSamples, false, false, true);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int i = 0; i < numSamples; ++i)
+                    buffer.setSample(ch, i, static_cast<SampleType>(input.getSample(ch, i)));
+
+            processor.processBlock(buffer, midi);
+            playHead.advance(numSamples);
+
+            output.setSize(numChannels, numSamples, false, false, true);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int i = 0; i < numSamples; ++i)
+                    output.setSample(ch, i, static_cast<float>(buffer.getSample(ch, i)));
+
+            return writer.writeFromAudioSampleBuffer(output, 0, numSamples);
+        };
+
+        for (juce::int64 position = 0; position < reader.lengthInSamples; position += blockSize)
+        {
+            const int numSamples = static_cast<int>(juce::jmin(static_cast<juce::int64>(blockSize), reader.lengthInSamples - position));
+
+            if (!reader.read(input.getArrayOfWritePointers(), numChannels, position, numSamples))
+                return false;
+
+            if (!processChunk(numSamples))
+                return false;
+        }
+
+        // Echoes after the last input sample (the tail follows the settings
+        // actually in use, e.g. the synced delay). A frozen loop reports an
+        // infinite tail: without an explicit --tail it gets none.
+        double tailSeconds = settings.tailSeconds >= 0.0 ? settings.tailSeconds : processor.getTailLengthSeconds();
+
+        if (!std::isfinite(tailSeconds))
+            tailSeconds = 0.0;
+
+        const auto tailSamples = static_cast<juce::int64>(std::ceil(tailSeconds * reader.sampleRate));
+
+        input.clear();
+
+        for (juce::int64 position = 0; position < tailSamples; position += blockSize)
+            if (!processChunk(static_cast<int>(juce::jmin(static_cast<juce::int64>(blockSize), tailSamples - position))))
+                return false;
+
+        return true;
+    }
+
+    juce::String processFile(const juce::File& inputFile, const ConsoleSettings& settings)
+    {
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+
+        auto reader = openReader(formats, inputFile);
+
+        if (reader == nullptr)
+            return "cannot read " + inputFile.getFullPathName();
+
+        const int numChannels = static_cast<int>(reader->numChannels);
+        ConsolePlayHead playHead(settings.bpm, reader->sampleRate);
+        auto processor = std::make_unique<SharcEchoAudioProcessor>();
+
+        // Matching in / out layout of the file's width, as a host would ask
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+        layout.outputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+
+        if (!processor->setBusesLayout(layout))
+            return juce::String(numChannels) + " channels not supported: " + inputFile.getFullPathName();
+
+        applyState(*processor, settings);
+
+        processor->setProcessingPrecision(settings.doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                                   : juce::AudioProcessor::singlePrecision);
+        processor->setNonRealtime(!settings.realtime);
+        processor->setRateAndBufferSizeDetails(reader->sampleRate, settings.blockSize);
+
+        // Before prepareToPlay, as a host does: a synced delay is prepared
+        // at the --bpm tempo, not the free delay time
+        processor->setPlayHead(&playHead);
+        processor->prepareToPlay(reader->sampleRate, settings.blockSize);
+
+        const auto folder = settings.outputFolder != juce::File() ? settings.outputFolder : inputFile.getParentDirectory();
+        const auto outputFile = folder.getChildFile(inputFile.getFileNameWithoutExtension() + settings.suffix + ".wav");
+
+        if (outputFile == inputFile)
+            return "output would overwrite the input: " + inputFile.getFullPathName();
+
+        outputFile.deleteFile();
+
+        std::unique_ptr<juce::OutputStream> stream(outputFile.createOutputStream());
+
+        if (stream == nullptr)
+            return "cannot write " + outputFile.getFullPathName();
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), reader->sampleRate,
+            static_cast<unsigned int>(numChannels), settings.bitsPerSample, {}, 0));
+
+        if (writer == nullptr)
+            return "cannot write " + outputFile.getFullPathName();
+
+        stream.release(); // owned by the writer now
+
+        const bool ok = settings.doublePrecision ? render<double>(*processor, playHead, *reader, *writer, settings)
+                                                 : render<float>(*processor, playHead, *reader, *writer, settings);
+        processor->releaseResources();
+        processor->setPlayHead(nullptr);
+
+        return ok ? juce::String() : "failed while processing " + inputFile.getFullPathName();
+    }
+
+    void listParameters()
+    {
+        SharcEchoAudioProcessor processor;
+
+        for (auto* parameter : processor.getParameters())
+        {
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            {
+                const auto& range = ranged->getNormalisableRange();
+                std::printf("%-12s %-20s %g .. %g, default %g\n", ranged->paramID.toRawUTF8(), ranged->getName(32).toRawUTF8(),
+                    range.start, range.end, range.convertFrom0to1(ranged->getDefaultValue()));
+            }
+        }
+    }
+
+    //==============================================================================
+    // --verify; returns the number of failed checks
+    int verify()
+    {
+        int failures = 0;
+
+        auto check = [&failures](bool ok, const juce::String& what)
+        {
+            std::printf("%-60s %s\n", what.toRawUTF8(), ok ? "ok" : "FAILED");
+
+            if (!ok)
+                ++failures;
+        };
+
+        auto value = [](SharcEchoAudioProcessor& processor, const char* id)
+        {
+            return processor.getAPVTS().getRawParameterValue(id)->load();
+        };
+
+        // A state as the first builds saved it: the APVTS tree as XML, with
+        // "Use SIMD" (ID "simd", a bool) where "Processing Mode" is now
+        for (const bool useSimd : { true, false })
+        {
+            juce::XmlElement state("PARAMS");
+
+            for (const auto& [id, v] : { std::pair<const char*, float> { "delay", 0.25f }, { "feedback", 0.6f },
+                                         { "wet", 0.4f }, { "dry", 0.8f }, { "bypass", 0.0f },
+                                         { "simd", useSimd ? 1.0f : 0.0f } })
+            {
+                auto* parameter = state.createNewChildElement("PARAM");
+                parameter->setAttribute("id", id);
+                parameter->setAttribute("value", v);
+            }
+
+            juce::MemoryBlock blob;
+            juce::AudioProcessor::copyXmlToBinary(state, blob);
+
+            SharcEchoAudioProcessor processor;
+            processor.setStateInformation(blob.getData(), static_cast<int>(blob.getSize()));
+
+            const auto expected = useSimd ? SharcKernelIsa::automatic : SharcKernelIsa::scalar;
+            check(juce::roundToInt(value(processor, "mode")) == static_cast<int>(expected),
+                  juce::String("first-build state, Use SIMD ") + (useSimd ? "on -> Auto" : "off -> Scalar"));
+            check(std::abs(value(processor, "delay") - 0.25f) < 1.0e-6f && std::abs(value(processor, "feedback") - 0.6f) < 1.0e-6f,
+                  "first-build state, other values");
+        }
+
+        // The current format keeps a forced mode
+        {
+            SharcEchoAudioProcessor saved, loaded;
+            auto* mode = saved.getAPVTS().getParameter("mode");
+            mode->setValueNotifyingHost(mode->convertTo0to1(static_cast<float>(SharcKernelIsa::avx2)));
+
+            juce::MemoryBlock blob;
+            saved.getStateInformation(blob);
+            loaded.setStateInformation(blob.getData(), static_cast<int>(blob.getSize()));
+
+            check(juce::roundToInt(value(loaded, "mode")) == static_cast<int>(SharcKernelIsa::avx2), "current state, forced AVX2");
+        }
+
+        return failures;
+    }
+
+    juce::Array<juce::File> findInputs(const juce::ArgumentList& args)
+    {
+        juce::Array<juce::File> inputs;
+
+        for (const auto& argument : args.arguments)
+        {
+            if (argument.isOption())
+                continue;
+
+            const auto file = argument.resolveAsFile();
+
+            if (file.isDirectory())
+                inputs.addArray(file.findChildFiles(juce::File::findFiles, false, "*.wav;*.aif;*.aiff;*.flac"));
+            else if (file.existsAsFile())
+                inputs.add(file);
+            else
+                std::fprintf(stderr, "Not found: %s\n", argument.text.toRawUTF8());
+        }
+
+        return inputs;
+    }
+
+    //==============================================================================
+    // Runs the files on the pool off the main thread, which stays in the
+    // message loop until every file is done
+    class Batch : public juce::Thread
+    {
+    public:
+        Batch(juce::Array<juce::File> files, ConsoleSettings s, int numJobs)
+            : juce::Thread("SHARC batch"), inputs(std::move(files)), settings(std::move(s)), jobs(numJobs) {}
+
+        void run() override
+        {
+            // Declared before the pool: the last job may still be inside
+            // signal() when wait() returns
+            std::atomic<int> remaining { inputs.size() };
+            juce::WaitableEvent done;
+            juce::ThreadPool pool(jobs);
+
+            for (const auto& file : inputs)
+            {
+                pool.addJob([this, file, &remaining, &done]
+                {
+                    const auto error = processFile(file, settings);
+
+                    if (error.isNotEmpty())
+                    {
+                        std::fprintf(stderr, "Error: %s\n", error.toRawUTF8());
+                        failures.fetch_add(1);
+                    }
+                    else
+                    {
+                        std::fprintf(stderr, "Done: %s\n", file.getFileName().toRawUTF8());
+                    }
+
+                    if (remaining.fetch_sub(1) == 1)
+                        done.signal();
+                });
+            }
+
+            if (!inputs.isEmpty())
+                done.wait(-1);
+
+            juce::MessageManager::getInstance()->stopDispatchLoop();
+        }
+
+        int getFailures() const noexcept { return failures.load(); }
+
+    private:
+        const juce::Array<juce::File> inputs;
+        const ConsoleSettings settings;
+        const int jobs;
+        std::atomic<int> failures { 0 };
+    };
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--list-parameters"))
+    {
+        listParameters();
+        return 0;
+    }
+
+    if (args.containsOption("--verify"))
+        return verify() > 0 ? 1 : 0;
+
+    ConsoleSettings settings;
+
+    if (args.containsOption("--output"))
+    {
+        settings.outputFolder = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output"));
+        settings.outputFolder.createDirectory();
+    }
+
+    if (args.containsOption("--suffix"))
+        settings.suffix = args.getValueForOption("--suffix");
+
+    if (args.containsOption("--state"))
+    {
+        const auto file = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--state"));
+
+        if (!file.loadFileAsData(settings.state))
+        {
+            std::fprintf(stderr, "Cannot read state %s\n", file.getFullPathName().toRawUTF8());
+            return 1;
+        }
+    }
+
+    if (args.containsOption("--set"))
+    {
+        for (const auto& assignment : juce::StringArray::fromTokens(args.getValueForOption("--set"), ",", {}))
+            settings.overrides.set(assignment.upToFirstOccurrenceOf("=", false, false).trim(),
+                                   assignment.fromFirstOccurrenceOf("=", false, false).trim());
+    }
+
+    if (args.containsOption("--bpm"))
+        settings.bpm = args.getValueForOption("--bpm").getDoubleValue();
+
+    if (args.containsOption("--block"))
+        settings.blockSize = juce::jlimit(16, 65536, args.getValueForOption("--block").getIntValue());
+
+    if (args.containsOption("--tail"))
+    {
+        const auto tail = args.getValueForOption("--tail");
+
+        if (tail.equalsIgnoreCase("none"))
+            settings.tailSeconds = 0.0;
+        else if (!tail.equalsIgnoreCase("auto"))
+            settings.tailSeconds = juce::jmax(0.0, tail.getDoubleValue());
+    }
+
+    if (args.containsOption("--bits"))
+    {
+        const int bits = args.getValueForOption("--bits").getIntValue();
+        settings.bitsPerSample = bits == 16 || bits == 24 ? bits : 32;
+    }
+
+    settings.realtime = args.containsOption("--realtime");
+    settings.doublePrecision = args.containsOption("--double");
+
+    const int jobs = args.containsOption("--jobs") ? juce::jmax(1, args.getValueForOption("--jobs").getIntValue())
+                                                   : juce::SystemStats::getNumCpus();
+
+    auto inputs = findInputs(args);
+
+    if (inputs.isEmpty())
+    {
+        std::fprintf(stderr, "No input files\n");
+        return 1;
+    }
+
+    std::fprintf(stderr, "%d file(s), %d job(s), %s, %d-frame blocks\n", inputs.size(), jobs,
+        settings.realtime ? "realtime path" : "offline render path", settings.blockSize);
+
+    Batch batch(std::move(inputs), std::move(settings), jobs);
+    batch.startThread();
+    juce::MessageManager::getInstance()->runDispatchLoop();
+    batch.stopThread(-1);
+
+    return batch.getFailures() == 0 ? 0 : 1;
+}
@@ -1,6 +1,10 @@
 /*
   SHARC Echo/Delay Effect Plugin - Editor Implementation (OPTIMIZED)
   JUCE 8.0.11
+
+  The static background is rendered once per resize. The timer only
+  repaints the readout and telemetry view, and only when they changed,
+  and slows down while nothing does.
 */
 
 #include "PluginProcessor.h"
@@ -10,13 +14,17 @@
 SharcEchoAudioProcessorEditor::SharcEchoAudioProcessorEditor(SharcEchoAudioProcessor& p)
     : AudioProcessorEditor(&p), audioProcessor(p)
 {
-    setSize(500, 350);
+    setSize(720, 450);
+    setOpaque(true);
 
     // Setup controls
     setupControl(delayControl, "delay", "Delay Time", juce::Slider::RotaryVerticalDrag);
     setupControl(feedbackControl, "feedback", "Feedback", juce::Slider::RotaryVerticalDrag);
     setupControl(wetControl, "wet", "Wet Mix", juce::Slider::LinearVertical);
     setupControl(dryControl, "dry", "Dry Mix", juce::Slider::LinearVertical);
+    setupControl(lowCutControl, "lowcut", "Low Cut", juce::Slider::LinearVertical);
+    setupControl(highCutControl, "highcut", "High Cut", juce::Slider::LinearVertical);
+    setupControl(crossControl, "cross", "Cross", juce::Slider::LinearVertical);
 
     // Bypass button
     addAndMakeVisible(bypassButton);
@@ -24,11 +32,57 @@ SharcEchoAudioProcessorEditor::SharcEchoAudioProcessorEditor(SharcEchoAudioProce
     bypassAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
         audioProcessor.getAPVTS(), "bypass", bypassButton);
 
-    // SIMD mode toggle
-    addAndMakeVisible(simdButton);
-    simdButton.setButtonText("Use SIMD (Low CPU)");
-    simdAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
-        audioProcessor.getAPVTS(), "simd", simdButton);
+    // Stereo feedback routing (with "Cross" at 100%: alternating echoes)
+    addAndMakeVisible(pingPongButton);
+    pingPongButton.setButtonText("Ping-Pong");
+    pingPongAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        audioProcessor.getAPVTS(), "pingpong", pingPongButton);
+
+    // Loops the delay memory as it is (input heard dry, nothing recorded)
+    addAndMakeVisible(freezeButton);
+    freezeButton.setButtonText("Freeze");
+    freezeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        audioProcessor.getAPVTS(), "freeze", freezeButton);
+
+    // Processing mode: Auto / Scalar / forced ISA
+    setupChoice(simdBox, "mode", simdAttachment);
+
+    // Fractional delay interpolation
+    setupChoice(interpBox, "interp", interpAttachment);
+
+    // Feedback write clip / saturation
+    setupChoice(saturationBox, "sat", saturationAttachment);
+
+    // Tempo sync and tap count (per-tap time / gain / pan are host
+    // parameters only)
+    addAndMakeVisible(syncButton);
+    syncButton.setButtonText("Sync");
+    syncAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        audioProcessor.getAPVTS(), "sync", syncButton);
+
+    setupChoice(divisionBox, "division", divisionAttachment);
+
+    addAndMakeVisible(tapsSlider);
+    tapsSlider.setSliderStyle(juce::Slider::IncDecButtons);
+    tapsSlider.setTextBoxStyle(juce::Slider::TextBoxLeft, false, 40, 25);
+    tapsSlider.setTextValueSuffix(" taps");
+    tapsAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+        audioProcessor.getAPVTS(), "taps", tapsSlider);
+
+    // Quality upgrades for offline bounces only
+    addAndMakeVisible(renderHqButton);
+    renderHqButton.setButtonText("HQ Render");
+    renderHqAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        audioProcessor.getAPVTS(), "renderhq", renderHqButton);
+
+    // Delay history: float or 16-bit
+    setupChoice(memoryBox, "memory", memoryAttachment);
+
+    // Keep a ringing tail in saved sessions
+    addAndMakeVisible(saveTailButton);
+    saveTailButton.setButtonText("Save Tail");
+    saveTailAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+        audioProcessor.getAPVTS(), "savetail", saveTailButton);
 
     // Mode label
     addAndMakeVisible(modeLabel);
@@ -36,13 +90,28 @@ SharcEchoAudioProcessorEditor::SharcEchoAudioProcessorEditor(SharcEchoAudioProce
     modeLabel.setJustificationType(juce::Justification::centredLeft);
     modeLabel.setFont(juce::FontOptions(14.0f, juce::Font::bold));
 
-    // Start timer for CPU monitoring (30Hz refresh rate)
-    startTimerHz(30);
+    // Stage timing histograms to CSV
+    addAndMakeVisible(exportProfileButton);
+    exportProfileButton.setButtonText("Export Profile...");
+    exportProfileButton.onClick = [this] { exportProfile(); };
+
+    // Telemetry only runs while an editor is open; stale frames from a
+    // previous editor are dropped
+    addAndMakeVisible(telemetryView);
+    audioProcessor.getTelemetry().discardPending();
+    audioProcessor.getTelemetry().setEnabled(true);
+
+    // CPU / timing readout
+    addAndMakeVisible(statusReadout);
+
+    // Readout and telemetry refresh (30 Hz, slower while idle)
+    startTimer(fastIntervalMs);
 }
 
 SharcEchoAudioProcessorEditor::~SharcEchoAudioProcessorEditor()
 {
     stopTimer();
+    audioProcessor.getTelemetry().setEnabled(false);
 }
 
 //==============================================================================
@@ -64,9 +133,55 @@ void SharcEchoAudioProcessorEditor::setupControl(ControlGroup& control,
         audioProcessor.getAPVTS(), paramID, control.slider);
 }
 
+void SharcEchoAudioProcessorEditor::setupChoice(juce::ComboBox& box,
+    const juce::String& paramID,
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment>& attachment)
+{
+    addAndMakeVisible(box);
+
+    // Items must exist before the attachment syncs the selection
+    if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(audioProcessor.getAPVTS().getParameter(paramID)))
+        box.addItemList(choice->choices, 1);
+
+    attachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getAPVTS(), paramID, box);
+}
+
+void SharcEchoAudioProcessorEditor::exportProfile()
+{
+    exportChooser = std::make_unique<juce::FileChooser>("Export DSP Profile",
+        juce::File::getSpecialLocation(juce::File::userDocumentsDirectory).getChildFile("SharcEchoProfile.csv"),
+        "*.csv");
+
+    exportChooser->launchAsync(juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::canSelectFiles
+                                   | juce::FileBrowserComponent::warnAboutOverwriting,
+        [this](const juce::FileChooser& chooser)
+        {
+            const auto file = chooser.getResult();
+
+            if (file != juce::File() && !audioProcessor.getProfiler().exportCsv(file))
+                juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon,
+                    "Export DSP Profile", "Could not write " + file.getFullPathName());
+        });
+}
+
 //==============================================================================
 void SharcEchoAudioProcessorEditor::paint(juce::Graphics& g)
 {
+    // Everything static is pre-rendered in resized()
+    g.drawImage(background, getLocalBounds().toFloat());
+}
+
+// Header, panels and dividers at the display's pixel scale
+void SharcEchoAudioProcessorEditor::renderBackground()
+{
+    const float scale = juce::jmax(1.0f, juce::Component::getApproximateScaleFactorForComponent(this));
+    background = juce::Image(juce::Image::RGB, juce::jmax(1, juce::roundToInt(getWidth() * scale)),
+                             juce::jmax(1, juce::roundToInt(getHeight() * scale)), false);
+
+    juce::Graphics g(background);
+    g.addTransform(juce::AffineTransform::scale(scale));
+
     // Dark background (SHARC hardware aesthetic)
     g.fillAll(juce::Colour(0xff1a1d2a));
 
@@ -94,46 +209,26 @@ void SharcEchoAudioProcessorEditor::paint(juce::Graphics& g)
     g.setColour(juce::Colour(0xff2a2d3a));
     g.fillRoundedRectangle(controlArea.reduced(10, 5).toFloat(), 8.0f);
 
-    // Footer
-    auto footerArea = bounds;
-    g.setColour(juce::Colour(0xff0a0d1a));
-    g.fillRect(footerArea.reduced(10, 5));
-
-    // CPU meter with color coding
-    bool usingSIMD = *audioProcessor.getAPVTS().getRawParameterValue("simd") > 0.5f;
-    float cpuPercent = currentCpuUsage * 100.0f;
-
-    // Color code based on CPU usage
-    juce::Colour cpuColor = juce::Colours::lime;
-    if (cpuPercent > 50.0f)
-        cpuColor = juce::Colours::orange;
-    if (cpuPercent > 75.0f)
-        cpuColor = juce::Colours::red;
-
-    juce::String cpuText = juce::String("CPU: ") + juce::String(cpuPercent, 1) + "% | "
-        + (usingSIMD ? "SIMD Mode (Optimized)" : "Scalar Mode (Authentic)");
+    // Telemetry strip (the view paints itself)
+    bounds.removeFromTop(70);
 
-    g.setColour(cpuColor);
-    g.setFont(juce::FontOptions(12.0f, juce::Font::bold));
-    g.drawText(cpuText, footerArea.reduced(15, 8), juce::Justification::centredLeft);
-
-    // Info text
-    g.setColour(juce::Colours::grey);
-    g.setFont(juce::FontOptions(10.0f));
-    g.drawText("Max Delay: 5.0s (240k samples @ 48kHz) | Stable Feedback Algorithm",
-        footerArea.reduced(15, 30), juce::Justification::centredLeft);
+    // Footer (the readout paints the CPU / timing text)
+    g.setColour(SharcStatusReadout::backgroundColour);
+    g.fillRect(bounds.reduced(10, 5));
 
     // Dividers
     g.setColour(juce::Colour(0xff4a5a6a).withAlpha(0.3f));
     g.drawLine(10.0f, 70.0f, static_cast<float>(getWidth()) - 10.0f, 70.0f, 1.0f);
-    g.drawLine(10.0f, static_cast<float>(getHeight()) - 75.0f,
+    g.drawLine(10.0f, static_cast<float>(getHeight()) - 105.0f,
         static_cast<float>(getWidth()) - 10.0f,
-        static_cast<float>(getHeight()) - 75.0f, 1.0f);
+        static_cast<float>(getHeight()) - 105.0f, 1.0f);
 }
 
 //==============================================================================
 void SharcEchoAudioProcessorEditor::resized()
 {
+    renderBackground();
+
     auto bounds = getLocalBounds();
     bounds.removeFromTop(75); // Skip header
 
@@ -152,23 +247,146 @@ void SharcEchoAudioProcessorEditor::resized()
     controlArea.removeFromLeft(20);
     dryControl.slider.setBounds(controlArea.removeFromLeft(50));
 
-    // Footer controls
-    auto footerArea = bounds.removeFromTop(65).reduced(20, 10);
-    modeLabel.setBounds(footerArea.removeFromTop(20));
+    // Feedback filter (Low Cut, High Cut)
+    controlArea.removeFromLeft(20);
+    lowCutControl.slider.setBounds(controlArea.removeFromLeft(60));
+    controlArea.removeFromLeft(20);
+    highCutControl.slider.setBounds(controlArea.removeFromLeft(60));
+
+    // Stereo cross feedback
+    controlArea.removeFromLeft(20);
+    crossControl.slider.setBounds(controlArea.removeFromLeft(60));
+
+    // Telemetry strip
+    bounds.removeFromTop(5);
+    telemetryView.setBounds(bounds.removeFromTop(70).reduced(10, 0));
+
+    // Footer controls, readout underneath
+    auto footerArea = bounds.reduced(20, 6);
+    auto labelRow = footerArea.removeFromTop(20);
+    exportProfileButton.setBounds(labelRow.removeFromRight(120));
+    modeLabel.setBounds(labelRow);
 
     auto buttonArea = footerArea.removeFromTop(25);
-    bypassButton.setBounds(buttonArea.removeFromLeft(100));
-    buttonArea.removeFromLeft(15);
-    simdButton.setBounds(buttonArea.removeFromLeft(180));
+    bypassButton.setBounds(buttonArea.removeFromLeft(90));
+    buttonArea.removeFromLeft(10);
+    simdBox.setBounds(buttonArea.removeFromLeft(130));
+    buttonArea.removeFromLeft(10);
+    interpBox.setBounds(buttonArea.removeFromLeft(105));
+    buttonArea.removeFromLeft(10);
+    saturationBox.setBounds(buttonArea.removeFromLeft(105));
+    buttonArea.removeFromLeft(10);
+    saveTailButton.setBounds(buttonArea.removeFromLeft(100));
+    buttonArea.removeFromLeft(10);
+    pingPongButton.setBounds(buttonArea.removeFromLeft(95));
+
+    footerArea.removeFromTop(5);
+    auto syncArea = footerArea.removeFromTop(25);
+    syncButton.setBounds(syncArea.removeFromLeft(90));
+    syncArea.removeFromLeft(10);
+    divisionBox.setBounds(syncArea.removeFromLeft(130));
+    syncArea.removeFromLeft(10);
+    tapsSlider.setBounds(syncArea.removeFromLeft(130));
+    syncArea.removeFromLeft(10);
+    renderHqButton.setBounds(syncArea.removeFromLeft(105));
+    syncArea.removeFromLeft(10);
+    memoryBox.setBounds(syncArea.removeFromLeft(105));
+    syncArea.removeFromLeft(10);
+    freezeButton.setBounds(syncArea.removeFromLeft(70));
+
+    statusReadout.setBounds(footerArea);
 }
 
 //==============================================================================
 void SharcEchoAudioProcessorEditor::timerCallback()
 {
-    // Update CPU usage
-    currentCpuUsage = audioProcessor.getCpuUsage();
+    // CPU meter with color coding
+    const auto activeKernel = audioProcessor.getActiveKernel();
+    const bool usingSIMD = activeKernel != SharcKernelIsa::scalar;
+    const float cpuPercent = audioProcessor.getCpuUsage() * 100.0f;
+
+    juce::Colour cpuColour = juce::Colours::lime;
+    if (cpuPercent > 50.0f)
+        cpuColour = juce::Colours::orange;
+    if (cpuPercent > 75.0f)
+        cpuColour = juce::Colours::red;
+
+    const juce::String cpuText = juce::String("CPU: ") + juce::String(cpuPercent, 1) + "% | "
+        + (usingSIMD ? juce::String(SharcDelayKernels::getName(activeKernel)) + " Mode (Optimized)"
+                     : juce::String("Scalar Mode (Authentic)"));
+
+    // Block timings (whole block, and the delay DSP alone) at the host's
+    // current block size
+    const auto& profiler = audioProcessor.getProfiler();
+    const int blockSizeClass = profiler.getLastBlockSizeClass();
+    const auto total = profiler.getSummary(SharcProfiler::Stage::total, blockSizeClass);
+    const auto dsp = profiler.getSummary(SharcProfiler::Stage::dsp, blockSizeClass);
+
+    juce::String profileText = "Block " + SharcProfiler::getBlockSizeLabel(blockSizeClass) + ": ";
+
+    if (total.count == 0)
+        profileText << "no blocks timed yet";
+    else
+        profileText << "p50 " << juce::String(total.p50, 1) << " us | p99 "
+                    << juce::String(total.p99, 1) << " us | max "
+                    << juce::String(total.max, 1) << " us (DSP p99 "
+                    << juce::String(dsp.p99, 1) << " us)";
+
+    if (SharcRealtimeChecker::isEnabled())
+        profileText << " | " << profiler.getRealtimeChecker().getSummaryText();
+
+    // Each part repaints only itself, and only if it changed
+    bool changed = statusReadout.setStatus(cpuText, cpuColour, profileText);
+    // The decay as the processor reports it to the host: synced delay,
+    // smoothed feedback, "Tail Floor"
+    const auto tail = audioProcessor.getTailEstimate();
+    changed |= telemetryView.setTail(tail.delaySeconds, tail.feedback, tail.floorDb);
+    changed |= telemetryView.update(audioProcessor.getTelemetry());
+
+    // Back off while nothing moves, snap back on the first change
+    idleTicks = changed ? 0 : idleTicks + 1;
+
+    const int interval = idleTicks < idleTicksBeforeBackoff ? fastIntervalMs
+                       : idleTicks < 2 * idleTicksBeforeBackoff ? mediumIntervalMs
+                                                                : slowIntervalMs;
+
+    if (interval != getTimerInterval())
+        startTimer(interval);
+}
+
+//==============================================================================
+const juce::Colour SharcStatusReadout::backgroundColour(0xff0a0d1a);
+
+SharcStatusReadout::SharcStatusReadout()
+{
+    setOpaque(true);
+    setInterceptsMouseClicks(false, false);
+}
+
+bool SharcStatusReadout::setStatus(const juce::String& newCpuText, juce::Colour newCpuColour,
+                                   const juce::String& newProfileText)
+{
+    if (newCpuText == cpuText && newCpuColour == cpuColour && newProfileText == profileText)
+        return false;
+
+    cpuText = newCpuText;
+    cpuColour = newCpuColour;
+    profileText = newProfileText;
+    repaint();
+    return true;
+}
+
+void SharcStatusReadout::paint(juce::Graphics& g)
+{
+    g.fillAll(backgroundColour);
 
-    // Only repaint footer area for efficiency
-    auto footerBounds = getLocalBounds().removeFromBottom(75);
-    repaint(footerBounds);
-}
\ No newline at end of file
+    auto bounds = getLocalBounds();
+
+    g.setColour(cpuColour);
+    g.setFont(juce::FontOptions(12.0f, juce::Font::bold));
+    g.drawText(cpuText, bounds.removeFromTop(bounds.getHeight() / 2), juce::Justification::centredLeft);
+
+    g.setColour(juce::Colours::grey);
+    g.setFont(juce::FontOptions(10.0f));
+    g.drawText(profileText, bounds, juce::Justification::centredLeft);
+}
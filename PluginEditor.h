@@ -6,6 +6,30 @@
 #pragma once
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "SharcTelemetryView.h"
+
+//==============================================================================
+// CPU / mode line and block timings. Opaque, and repaints only when the
+// text actually changes.
+//==============================================================================
+class SharcStatusReadout : public juce::Component
+{
+public:
+    static const juce::Colour backgroundColour;
+
+    SharcStatusReadout();
+
+    // Returns true (and repaints) if anything differs from what is shown
+    bool setStatus(const juce::String& cpuText, juce::Colour cpuColour, const juce::String& profileText);
+
+    void paint(juce::Graphics&) override;
+
+private:
+    juce::String cpuText, profileText;
+    juce::Colour cpuColour;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SharcStatusReadout)
+};
 
 //==============================================================================
 class SharcEchoAudioProcessorEditor : public juce::AudioProcessorEditor,
@@ -34,19 +58,61 @@ private:
     ControlGroup feedbackControl;
     ControlGroup wetControl;
     ControlGroup dryControl;
+    ControlGroup lowCutControl;
+    ControlGroup highCutControl;
+    ControlGroup crossControl;
 
     juce::ToggleButton bypassButton;
-    juce::ToggleButton simdButton;
+    juce::ComboBox simdBox;
+    juce::ComboBox interpBox;
+    juce::ComboBox saturationBox;
+    juce::ToggleButton syncButton;
+    juce::ComboBox divisionBox;
+    juce::Slider tapsSlider;
+    juce::ToggleButton renderHqButton;
+    juce::ComboBox memoryBox;
+    juce::ToggleButton saveTailButton;
+    juce::ToggleButton pingPongButton;
+    juce::ToggleButton freezeButton;
     juce::Label modeLabel;
+    juce::TextButton exportProfileButton;
+
+    // Level envelope + decay display, fed from the processor's telemetry
+    SharcTelemetryView telemetryView;
+
+    std::unique_ptr<juce::FileChooser> exportChooser;
 
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> bypassAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> simdAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> simdAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> interpAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> saturationAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> syncAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> divisionAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> tapsAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> renderHqAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> memoryAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> saveTailAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> pingPongAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> freezeAttachment;
+
+    SharcStatusReadout statusReadout;
+
+    // Pre-rendered header, panels and dividers (rebuilt in resized())
+    juce::Image background;
 
-    // CPU meter
-    float currentCpuUsage = 0.0f;
+    // Timer backoff: 30 Hz, then 10 Hz and 4 Hz after ~1 s and ~4 s idle
+    static constexpr int fastIntervalMs = 33;
+    static constexpr int mediumIntervalMs = 100;
+    static constexpr int slowIntervalMs = 250;
+    static constexpr int idleTicksBeforeBackoff = 30;
+    int idleTicks = 0;
 
     void setupControl(ControlGroup& control, const juce::String& paramID,
         const juce::String& labelText, juce::Slider::SliderStyle style);
+    void setupChoice(juce::ComboBox& box, const juce::String& paramID,
+        std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment>& attachment);
+    void exportProfile();
+    void renderBackground();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SharcEchoAudioProcessorEditor)
 };
\ No newline at end of file
@@ -11,12 +11,16 @@ SharcEchoAudioProcessor::SharcEchoAudioProcessor()
     : AudioProcessor(BusesProperties()
         .withInput("Input", juce::AudioChannelSet::stereo(), true)
         .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
-    apvts(*this, nullptr, "PARAMS", createParameterLayout())
+    apvts(*this, nullptr, "PARAMS", createParameterLayout()),
+    parameters(apvts),
+    schedule(1),
+    tailFloor(apvts.getRawParameterValue("tailfloor"))
 {
 }
 
 SharcEchoAudioProcessor::~SharcEchoAudioProcessor()
 {
+    cancelPendingUpdate();
 }
 
 //==============================================================================
@@ -30,10 +34,30 @@ juce::AudioProcessorValueTreeState::ParameterLayout SharcEchoAudioProcessor::cre
         juce::NormalisableRange<float>(0.001f, 5.0f, 0.001f, 0.3f), 1.0f,
         juce::AudioParameterFloatAttributes().withLabel("s")));
 
+    // Caps the delay (and the memory it may grow to); not automatable
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("maxdelay", 1), "Max Delay",
+        juce::NormalisableRange<float>(0.05f, 5.0f, 0.01f, 0.5f), 5.0f,
+        juce::AudioParameterFloatAttributes().withLabel("s").withAutomatable(false)));
+
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         juce::ParameterID("feedback", 1), "Feedback",
         juce::NormalisableRange<float>(0.0f, 0.99f, 0.01f), 0.3f));
 
+    // Stereo feedback matrix: how much of each side's echo feeds the other
+    // side instead of itself. Ping-pong sends the mono sum into the left
+    // side only, so with full cross feedback the echoes alternate sides
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("cross", 1), "Cross Feedback",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.0f));
+
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID("pingpong", 1), "Ping-Pong", false));
+
+    // Loops the delay memory read-only (see SharcDelayLine::setFreeze())
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID("freeze", 1), "Freeze", false));
+
     params.push_back(std::make_unique<juce::AudioParameterFloat>(
         juce::ParameterID("wet", 1), "Wet Mix",
         juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.5f));
@@ -45,87 +69,687 @@ juce::AudioProcessorValueTreeState::ParameterLayout SharcEchoAudioProcessor::cre
     params.push_back(std::make_unique<juce::AudioParameterBool>(
         juce::ParameterID("bypass", 1), "Bypass", false));
 
+    // Choice indices match SharcInterpolation
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("interp", 1), "Interpolation",
+        juce::StringArray { "Linear", "Hermite", "Lagrange", "Allpass" }, 1));
+
+    // Feedback write: the original hard clip, or soft tanh-style limiting.
+    // Choice indices match SharcSaturation
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("sat", 1), "Saturation",
+        juce::StringArray { "Hard Clip", "Soft", "Soft 2x" }, 0));
+
+    // Feedback damping: each echo is filtered again, so repeats darken /
+    // thin out. The range ends (20 Hz / 20 kHz) switch a side off.
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("lowcut", 1), "Feedback Low Cut",
+        juce::NormalisableRange<float>(SharcFeedbackFilter::lowCutOff, 2000.0f, 1.0f, 0.3f), SharcFeedbackFilter::lowCutOff,
+        juce::AudioParameterFloatAttributes().withLabel("Hz")));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("highcut", 1), "Feedback High Cut",
+        juce::NormalisableRange<float>(1000.0f, SharcFeedbackFilter::highCutOff, 1.0f, 0.3f), SharcFeedbackFilter::highCutOff,
+        juce::AudioParameterFloatAttributes().withLabel("Hz")));
+
+    // Tempo sync: the delay follows the host tempo at a note division
+    // (the free "Delay Time" is used while the tempo is unknown)
     params.push_back(std::make_unique<juce::AudioParameterBool>(
-        juce::ParameterID("simd", 1), "Use SIMD", false));
+        juce::ParameterID("sync", 1), "Tempo Sync", false));
+
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("division", 1), "Sync Division",
+        SharcParameterEngine::getDivisionNames(), 8));
+
+    // Output taps: read heads at a fraction of the delay, each with its
+    // own gain and pan. One tap at full delay, gain 1, centre is the plain
+    // echo; the defaults space the taps evenly when the count goes up.
+    params.push_back(std::make_unique<juce::AudioParameterInt>(
+        juce::ParameterID("taps", 1), "Taps", 1, SharcTapTable::maxTaps, 1));
+
+    for (int i = 0; i < SharcTapTable::maxTaps; ++i)
+    {
+        const auto id = "tap" + juce::String(i + 1);
+        const auto name = "Tap " + juce::String(i + 1);
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID(id + "time", 1), name + " Time",
+            juce::NormalisableRange<float>(0.01f, 1.0f, 0.001f), 1.0f - static_cast<float>(i) / SharcTapTable::maxTaps,
+            juce::AudioParameterFloatAttributes().withLabel("x delay")));
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID(id + "gain", 1), name + " Gain",
+            juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 1.0f));
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID(id + "pan", 1), name + " Pan",
+            juce::NormalisableRange<float>(-1.0f, 1.0f, 0.01f), 0.0f));
+    }
+
+    // Choice indices match SharcKernelIsa. Replaces "Use SIMD" ("simd", a
+    // bool), which is mapped over on load (see migrateUseSimd)
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("mode", 1), "Processing Mode",
+        juce::StringArray { "Auto", "Scalar", "SSE2", "AVX2", "AVX-512", "NEON" }, 0));
+
+    // Offline renders only: Linear -> Hermite, Soft -> Soft 2x (see
+    // SharcParameterEngine); not automatable
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID("renderhq", 1), "HQ Render", false,
+        juce::AudioParameterBoolAttributes().withAutomatable(false)));
+
+    // Delay history precision: 16-bit halves the ring memory. Switching
+    // reallocates (off the audio thread), so not automatable. Choice
+    // indices match SharcRingFormat
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("memory", 1), "Delay Memory",
+        juce::StringArray { "32-bit Float", "16-bit" }, 0,
+        juce::AudioParameterChoiceAttributes().withAutomatable(false)));
+
+    // Level the reported tail decays to (see getTailLengthSeconds); lower
+    // floors keep offline bounces running longer. Not automatable
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("tailfloor", 1), "Tail Floor",
+        juce::NormalisableRange<float>(-144.0f, -48.0f, 1.0f), -96.0f,
+        juce::AudioParameterFloatAttributes().withLabel("dB").withAutomatable(false)));
+
+    // Saved states include the delay history, so a ringing tail carries on
+    // when the session reopens (see SharcState.h); not automatable
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID("savetail", 1), "Save Tail", false,
+        juce::AudioParameterBoolAttributes().withAutomatable(false)));
 
     return { params.begin(), params.end() };
 }
 
 //==============================================================================
+namespace
+{
+    // The first block's settings, before anything is processed
+    template <typename Engine>
+    void applyInitialBlock(Engine& delay, const SharcParameterEngine::BlockParameters& initial)
+    {
+        delay.setMaxDelaySeconds(initial.maxDelaySeconds);
+        delay.setParameterRamps(initial.ramps);
+        delay.setFeedbackFilter(initial.lowCutHz, initial.highCutHz);
+        delay.setTaps(initial.taps);
+    }
+
+    template <typename SampleType>
+    void processInPlace(SharcDelayLine& line, SampleType* const* channels, int numSamples, bool scalar) noexcept
+    {
+        if (scalar)
+            line.processBlockScalar(channels[0], channels[1], numSamples);
+        else
+            line.processBlockSIMD(channels[0], channels[1], numSamples);
+    }
+
+    template <typename SampleType>
+    void processInPlace(SharcDelayBank& bank, SampleType* const* channels, int numSamples, bool scalar) noexcept
+    {
+        if (scalar)
+            bank.processBlockScalar(channels, numSamples);
+        else
+            bank.processBlockSIMD(channels, numSamples);
+    }
+}
+
 void SharcEchoAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
+    // Counted if a host calls this from inside processBlock
+    SharcRealtimeChecker::ScopedSource realtimeSource(SharcRealtimeChecker::Source::prepare);
     currentSampleRate = sampleRate;
 
-    // Prepare delay line
-    delayLine.prepare(sampleRate, 5.0f);
+    // A synced delay starts at the host's tempo if it already has one, so
+    // the ring is sized for it and the first block doesn't glide there
+    double bpm = 0.0;
+
+    if (auto* playHead = getPlayHead())
+        if (const auto position = playHead->getPosition())
+            bpm = position->getBpm().orFallback(0.0);
 
-    // Initialize smoothed CPU measurement (500ms smoothing time)
-    smoothedCpuUsage.reset(sampleRate, 0.5);
-    smoothedCpuUsage.setCurrentAndTargetValue(0.0f);
+    parameters.setHostTempo(bpm);
+
+    // Start the smoothers at the current values, then prepare the delay
+    // line (resolves the SIMD kernel for this CPU)
+    parameters.prepare(sampleRate);
+    parameters.setOfflineRender(isNonRealtime());
+    const auto initial = parameters.nextBlock(0);
+
+    const int numChannels = getTotalNumOutputChannels();
+    useBank = numChannels != 2;
+
+    // Size the ring for the current delay only; it grows on demand (up to
+    // 5 s, or "Max Delay") via handleAsyncUpdate, or in processSubBlock
+    // during offline renders
+    const auto initialDelaySeconds = static_cast<float>(initial.delayTarget / sampleRate);
+
+    // Offline: one group per core, up to one per channel. Cross feedback
+    // and ping-pong couple the two sides of a stereo bus, so one that uses
+    // them at prepare time stays one interleaved line (and one that turns
+    // them on later goes back to it, see joinStereoSides).
+    const bool stereoCoupled = numChannels == 2 && (initial.ramps.cross > 0.0f || initial.ramps.pingPong);
+    const int numGroups = isNonRealtime() && !stereoCoupled ? juce::jlimit(1, SharcRenderPool::maxWorkers + 1,
+                                                         juce::jmin(numChannels, juce::SystemStats::getNumPhysicalCpus()))
+                                          : 1;
+    cancelPendingUpdate();
+    renderGroups.clear();
+    renderPool.start(numGroups - 1);
+    stereoSidesJoined = false;
+
+    // Only one engine holds memory; the others go back to the pool
+    if (numGroups > 1)
+    {
+        delayLine.releaseStorage();
+        delayBank.releaseStorage();
+
+        for (int g = 0; g < numGroups; ++g)
+        {
+            auto* group = renderGroups.add(new RenderGroup());
+            group->firstChannel = g * numChannels / numGroups;
+            group->numChannels = (g + 1) * numChannels / numGroups - group->firstChannel;
+            group->bank.setKernel(initial.kernel);
+            group->bank.setRingFormat(initial.ringFormat);
+
+            // Stereo split into its sides: each keeps its tap pan
+            if (numChannels == 2)
+                group->bank.setStereoSide(g == 0 ? SharcDelayBank::StereoSide::left : SharcDelayBank::StereoSide::right);
+
+            group->bank.prepare(sampleRate, group->numChannels, maxDelaySeconds, initialDelaySeconds);
+            applyInitialBlock(group->bank, initial);
+            group->state.prepare(group->numChannels, initial);
+        }
+
+        activeKernel = renderGroups.getFirst()->bank.getActiveKernel();
+    }
+    else if (useBank)
+    {
+        delayLine.releaseStorage();
+        delayBank.setKernel(initial.kernel);
+        delayBank.setRingFormat(initial.ringFormat);
+        delayBank.prepare(sampleRate, numChannels, maxDelaySeconds, initialDelaySeconds);
+        applyInitialBlock(delayBank, initial);
+        activeKernel = delayBank.getActiveKernel();
+    }
+    else
+    {
+        delayBank.releaseStorage();
+        delayLine.setKernel(initial.kernel);
+        delayLine.setRingFormat(initial.ringFormat);
+        delayLine.prepare(sampleRate, maxDelaySeconds, initialDelaySeconds);
+        applyInitialBlock(delayLine, initial);
+        activeKernel = delayLine.getActiveKernel();
+    }
+
+    const double tail = computeTailSeconds(initial.delayTarget, initial.ramps.feedback, initial.freeze);
+    tailSeconds.store(tail);
+    reportedTailSeconds.store(tail);
+    tailDelaySeconds.store(static_cast<float>(initial.delayTarget / sampleRate));
+    tailFeedbackInUse.store(initial.ramps.feedback);
+
+    // One parameter set per sub-block of the largest expected buffer
+    schedule.resize(static_cast<size_t>(juce::jmax(1, (samplesPerBlock + subBlockSize - 1) / subBlockSize)));
+    engineState.prepare(numChannels, initial);
+
+    cpuUsage.store(0.0f);
+    profiler.reset();
+    telemetry.prepare(sampleRate);
 }
 
 void SharcEchoAudioProcessor::releaseResources()
 {
+    SharcRealtimeChecker::ScopedSource realtimeSource(SharcRealtimeChecker::Source::prepare);
+
+    // Hand the rings back to SharcMemoryPool for other instances
+    cancelPendingUpdate();
+    delayLine.releaseStorage();
+    delayBank.releaseStorage();
+    engineState.release();
+    renderPool.stop();
+    renderGroups.clear();
+}
+
+void SharcEchoAudioProcessor::handleAsyncUpdate()
+{
+    delayLine.serviceStorage();
+    delayBank.serviceStorage();
+
+    for (auto* group : renderGroups)
+        group->bank.serviceStorage();
+
+    historyExchange.release();
+
+    // JUCE has no tail flag. A latency change would make most hosts
+    // re-activate the plugin, clearing the ring mid-echo, so this only
+    // marks the state changed; hosts read getTailLengthSeconds() when
+    // they need it (e.g. where a bounce stops)
+    const double tail = tailSeconds.load();
+
+    if (hasTailMoved(tail, reportedTailSeconds.load()))
+    {
+        reportedTailSeconds.store(tail);
+        updateHostDisplay(ChangeDetails().withNonParameterStateChanged(true));
+    }
+}
+
+double SharcEchoAudioProcessor::computeTailSeconds(double delaySamples, float feedback, bool frozen) const
+{
+    if (frozen)
+        return std::numeric_limits<double>::infinity();
+
+    const float floorDb = tailFloor->load();
+    const float floor = juce::Decibels::decibelsToGain(floorDb, -200.0f);
+
+    return SharcSilenceTracker::getTailLength(delaySamples, feedback, floor) / currentSampleRate;
+}
+
+double SharcEchoAudioProcessor::getTailLengthSeconds() const
+{
+    // Time for the feedback loop to decay below "Tail Floor", not the
+    // buffer size. Before the first prepareToPlay: from the free delay
+    // time (no host tempo yet). Infinite while frozen.
+    if (const double tail = tailSeconds.load(); tail >= 0.0)
+        return tail;
+
+    const auto* delay = apvts.getRawParameterValue("delay");
+    const auto* maxDelay = apvts.getRawParameterValue("maxdelay");
+    const auto* feedback = apvts.getRawParameterValue("feedback");
+    const auto* freeze = apvts.getRawParameterValue("freeze");
+
+    return computeTailSeconds(juce::jmin(delay->load(), maxDelay->load()) * currentSampleRate, feedback->load(),
+                              freeze->load() > 0.5f);
+}
+
+SharcEchoAudioProcessor::TailEstimate SharcEchoAudioProcessor::getTailEstimate() const noexcept
+{
+    TailEstimate estimate;
+    estimate.delaySeconds = tailDelaySeconds.load(std::memory_order_relaxed);
+    estimate.feedback = tailFeedbackInUse.load(std::memory_order_relaxed);
+    estimate.floorDb = tailFloor->load();
+
+    // Before the first prepareToPlay, as getTailLengthSeconds()
+    if (estimate.delaySeconds < 0.0f)
+    {
+        estimate.delaySeconds = juce::jmin(apvts.getRawParameterValue("delay")->load(),
+                                           apvts.getRawParameterValue("maxdelay")->load());
+        estimate.feedback = apvts.getRawParameterValue("feedback")->load();
+    }
+
+    return estimate;
 }
 
 bool SharcEchoAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 {
-    // Only stereo input/output
-    return layouts.getMainInputChannelSet() == juce::AudioChannelSet::stereo()
-        && layouts.getMainOutputChannelSet() == juce::AudioChannelSet::stereo();
+    // Any layout, as long as input and output match (one delay per channel)
+    const auto& input = layouts.getMainInputChannelSet();
+
+    return !input.isDisabled()
+        && input == layouts.getMainOutputChannelSet()
+        && input.size() <= SharcDelayBank::maxChannels;
 }
 
 //==============================================================================
 void SharcEchoAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+{
+    process(buffer);
+}
+
+// 64-bit hosts: no conversion copy in the wrapper; the delay line narrows
+// per chunk and keeps the dry signal in double
+void SharcEchoAudioProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer&)
+{
+    process(buffer);
+}
+
+template <typename SampleType>
+void SharcEchoAudioProcessor::process(juce::AudioBuffer<SampleType>& buffer)
 {
     juce::ScopedNoDenormals noDenormals;
 
-    // CPU monitoring start
-    auto startTime = juce::Time::getMillisecondCounterHiRes();
+    // Allocations and locks from here to the end of the block are
+    // violations (SHARC_REALTIME_CHECKS builds only)
+    SharcRealtimeChecker::ScopedAudioThread realtimeCheck(profiler.getRealtimeChecker());
+
+    // Profiler stage times, summed over the sub-blocks
+    SharcProfiler::Clock::duration stageTimes[SharcProfiler::numStages - 1] {};
+    const auto start = SharcProfiler::now();
+    auto stageStart = start;
+
+    auto addStageTime = [&](SharcProfiler::Stage stage)
+    {
+        const auto now = SharcProfiler::now();
+        stageTimes[static_cast<int>(stage)] += now - stageStart;
+        stageStart = now;
+    };
+
+    const int numSamples = buffer.getNumSamples();
+    const int numChannels = buffer.getNumChannels();
+
+    // Taken once: the render groups use them from several threads
+    SampleType* const* channels = buffer.getArrayOfWritePointers();
+
+    // Host tempo for sync, once per buffer (none: the free delay time)
+    double bpm = 0.0;
+
+    {
+        SharcRealtimeChecker::ScopedSource realtimeSource(SharcRealtimeChecker::Source::parameters);
+
+        if (auto* playHead = getPlayHead())
+            if (const auto position = playHead->getPosition())
+                bpm = position->getBpm().orFallback(0.0);
+
+        parameters.setHostTempo(bpm);
+        parameters.setOfflineRender(isNonRealtime());
+    }
+
+    // Input levels for the editor, before the buffer is processed in place
+    const bool collectTelemetry = telemetry.isEnabled();
+
+    if (collectTelemetry)
+    {
+        SharcRealtimeChecker::ScopedSource realtimeSource(SharcRealtimeChecker::Source::output);
+        telemetry.addInput(buffer, numSamples);
+        addStageTime(SharcProfiler::Stage::output);
+    }
+
+    // A state save's history copy, or a loaded one to put back (before
+    // this buffer's writes). Offline renders keep theirs for later.
+    bool historyToRelease = false;
+
+    if (renderGroups.isEmpty())
+        historyToRelease = useBank ? historyExchange.service(delayBank, delayBank.getNumChannels())
+                                   : historyExchange.service(delayLine, SharcDelayLine::numChannels);
+
+    // Fixed-size sub-blocks: parameters are re-read at every sub-block
+    // edge, so automation resolution no longer depends on the host buffer,
+    // and the kernels see the same chunk in every host configuration. The
+    // whole schedule is built first, then run, so the profiler only needs
+    // a few timestamps per buffer. Buffers longer than prepareToPlay
+    // promised are handled in several passes.
+    const int passLength = static_cast<int>(schedule.size()) * subBlockSize;
+
+    // Where the delay and feedback end up after this buffer, for the tail
+    double tailDelay = -1.0;
+    float tailFeedback = 0.0f;
+    bool tailFrozen = false;
+
+    for (int passStart = 0; passStart < numSamples; passStart += passLength)
+    {
+        const int passSamples = juce::jmin(passLength, numSamples - passStart);
+        const int numSubBlocks = (passSamples + subBlockSize - 1) / subBlockSize;
+
+        // Get parameters (pre-resolved atomics, smoothed into per-sample ramps)
+        {
+            SharcRealtimeChecker::ScopedSource realtimeSource(SharcRealtimeChecker::Source::parameters);
+
+            for (int i = 0; i < numSubBlocks; ++i)
+                schedule[static_cast<size_t>(i)] = parameters.nextBlock(juce::jmin(subBlockSize, passSamples - i * subBlockSize));
+        }
+
+        const auto& last = schedule[static_cast<size_t>(numSubBlocks - 1)];
+        tailDelay = last.delayTarget;
+        tailFeedback = last.ramps.at(passSamples - (numSubBlocks - 1) * subBlockSize).feedback;
+        tailFrozen = last.freeze;
+
+        addStageTime(SharcProfiler::Stage::parameters);
+
+        if (!renderGroups.isEmpty() && !stereoSidesJoined && numChannels == 2 && passCouplesStereo(numSubBlocks))
+            joinStereoSides(schedule.front());
+
+        if (!renderGroups.isEmpty() && !stereoSidesJoined)
+        {
+            processRenderGroups(channels, passStart, passSamples, numSubBlocks);
+        }
+        else
+        {
+            for (int i = 0; i < numSubBlocks; ++i)
+            {
+                const int offset = passStart + i * subBlockSize;
+                const int length = juce::jmin(subBlockSize, passSamples - i * subBlockSize);
+                const auto& block = schedule[static_cast<size_t>(i)];
+
+                if (useBank)
+                    processSubBlock(delayBank, engineState, channels, numChannels, offset, length, block);
+                else
+                    processSubBlock(delayLine, engineState, channels, numChannels, offset, length, block);
+            }
+        }
 
-    auto numSamples = buffer.getNumSamples();
+        addStageTime(SharcProfiler::Stage::dsp);
+    }
+
+    // Storage requests, tail, telemetry and meters to the end of the block
+    SharcRealtimeChecker::ScopedSource realtimeSource(SharcRealtimeChecker::Source::output);
+
+    bool needsStorageService = useBank ? delayBank.needsStorageService() : delayLine.needsStorageService();
+
+    for (auto* group : renderGroups)
+        needsStorageService = needsStorageService || group->bank.needsStorageService();
+
+    // The host hears about a tail change from the message thread
+    bool tailChanged = false;
+
+    if (tailDelay >= 0.0)
+    {
+        const double tail = computeTailSeconds(tailDelay, tailFeedback, tailFrozen);
+        tailSeconds.store(tail, std::memory_order_relaxed);
+        tailDelaySeconds.store(static_cast<float>(tailDelay / currentSampleRate), std::memory_order_relaxed);
+        tailFeedbackInUse.store(tailFeedback, std::memory_order_relaxed);
+        tailChanged = hasTailMoved(tail, reportedTailSeconds.load(std::memory_order_relaxed));
+    }
+
+    if (needsStorageService || historyToRelease || tailChanged)
+        triggerAsyncUpdate();
+
+    if (collectTelemetry)
+        telemetry.addOutput(buffer, numSamples);
+
+    // CPU usage: one-pole smoothing whose coefficient follows the block
+    // duration, so the time constant is the same at any block size.
+    // Not capped: > 100% means the block took longer than it lasts.
+    if (numSamples > 0)
+    {
+        const double blockSeconds = std::chrono::duration<double>(SharcProfiler::now() - start).count();
+        const double expectedBlockSeconds = static_cast<double>(numSamples) / currentSampleRate;
+        const double alpha = 1.0 - std::exp(-expectedBlockSeconds / cpuSmoothingSeconds);
+
+        const float previous = cpuUsage.load(std::memory_order_relaxed);
+        cpuUsage.store(previous + static_cast<float>(alpha * (blockSeconds / expectedBlockSeconds - previous)),
+                       std::memory_order_relaxed);
+    }
+
+    addStageTime(SharcProfiler::Stage::output);
+    profiler.record(numSamples, stageTimes);
+}
+
+// One sub-block, [offset, offset + numSamples), of channels[0 .. numChannels)
+template <typename SampleType, typename Engine>
+void SharcEchoAudioProcessor::processSubBlock(Engine& delay, EngineState& state, SampleType* const* channels, int numChannels,
+                                              int offset, int numSamples, const SharcParameterEngine::BlockParameters& block) noexcept
+{
+    // Bypass: once the fade-out is done the buffer is passed through
+    // untouched, and the (now stale) history is dropped exactly once
+    if (block.isFullyBypassed())
+    {
+        if (!state.bypassed)
+        {
+            delay.reset();
+            state.bypassed = true;
+        }
 
-    // Bypass
-    if (*apvts.getRawParameterValue("bypass") > 0.5f)
         return;
+    }
+
+    state.bypassed = false;
 
-    // Get parameters
-    float delaySeconds = *apvts.getRawParameterValue("delay");
-    float feedback = *apvts.getRawParameterValue("feedback");
-    float wetMix = *apvts.getRawParameterValue("wet");
-    float dryMix = *apvts.getRawParameterValue("dry");
-    useSIMD = *apvts.getRawParameterValue("simd") > 0.5f;
+    // Keep the input for the crossfade while bypass is ramping
+    auto& bypassInput = state.getBypassBuffer<SampleType>();
 
-    // Update delay line parameters
-    delayLine.setDelaySeconds(delaySeconds);
-    delayLine.setFeedback(feedback);
-    delayLine.setWetMix(wetMix);
-    delayLine.setDryMix(dryMix);
+    if (block.isFading())
+    {
+        bypassInput.setSize(numChannels, numSamples, false, false, true);
 
-    // Get audio pointers
-    const float* inputLeft = buffer.getReadPointer(0);
-    const float* inputRight = buffer.getReadPointer(1);
-    float* outputLeft = buffer.getWritePointer(0);
-    float* outputRight = buffer.getWritePointer(1);
+        for (int ch = 0; ch < numChannels; ++ch)
+            std::copy(channels[ch] + offset, channels[ch] + offset + numSamples, bypassInput.getWritePointer(ch));
+    }
 
-    // Process with optimized SIMD or scalar
-    if (useSIMD)
+    // Re-resolve only when the mode changes (table lookup, no CPUID)
+    if (block.kernel != state.requestedKernel)
     {
-        delayLine.processBlockSIMD(inputLeft, inputRight, outputLeft, outputRight, numSamples);
+        state.requestedKernel = block.kernel;
+        delay.setKernel(state.requestedKernel);
+        activeKernel = delay.getActiveKernel();
     }
-    else
+
+    // A new format is converted into on the message thread, like a growth
+    if (block.ringFormat != delay.getRingFormat())
+        delay.setRingFormat(block.ringFormat);
+
+    // Update the delay parameters (reserving the glide target early gives
+    // the message thread time to grow the ring)
+    delay.setMaxDelaySeconds(block.maxDelaySeconds);
+    delay.reserveDelay(block.delayTarget);
+
+    // Offline, a growth or conversion happens right here, before this
+    // sub-block is processed: waiting for the message thread would make
+    // the render depend on its timing. Blocking is fine when not live.
+    if (isNonRealtime() && delay.needsStorageService())
     {
-        delayLine.processBlockScalar(inputLeft, inputRight, outputLeft, outputRight, numSamples);
+        SharcRealtimeChecker::ScopedSource realtimeSource(SharcRealtimeChecker::Source::output);
+        delay.serviceStorage();
     }
 
-    // Update smoothed CPU usage
-    auto endTime = juce::Time::getMillisecondCounterHiRes();
-    double blockTime = (endTime - startTime) / 1000.0;
-    double expectedBlockTime = static_cast<double>(numSamples) / currentSampleRate;
-    float instantCpu = static_cast<float>(juce::jmin(1.0, blockTime / expectedBlockTime));
+    delay.setParameterRamps(block.ramps);
+    delay.setFeedbackFilter(block.lowCutHz, block.highCutHz);
+    delay.setTaps(block.taps);
+    delay.setFreeze(block.freeze);
+
+    // In place on the host buffer (no copies), with the dispatched SIMD
+    // kernel or the authentic scalar loop
+    SampleType* subBlock[SharcDelayBank::maxChannels];
 
-    smoothedCpuUsage.setTargetValue(instantCpu);
-    smoothedCpuUsage.skip(1); // Advance smoother by 1 sample
+    for (int ch = 0; ch < numChannels; ++ch)
+        subBlock[ch] = channels[ch] + offset;
+
+    processInPlace(delay, subBlock, numSamples, state.requestedKernel == SharcKernelIsa::scalar);
+
+    // Crossfade processed -> input (fade 1 = fully bypassed)
+    if (block.isFading())
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const SampleType* input = bypassInput.getReadPointer(ch);
+            SampleType* output = subBlock[ch];
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float fade = block.bypassFade + block.bypassFadeStep * static_cast<float>(i);
+                output[i] += (input[i] - output[i]) * fade;
+            }
+        }
+    }
+}
+
+bool SharcEchoAudioProcessor::passCouplesStereo(int numSubBlocks) const noexcept
+{
+    for (int i = 0; i < numSubBlocks; ++i)
+    {
+        const auto& ramps = schedule[static_cast<size_t>(i)].ramps;
+
+        if (ramps.cross > 0.0f || ramps.crossStep != 0.0f || ramps.pingPong)
+            return true;
+    }
+
+    return false;
+}
+
+// Offline only, on the render thread: allocating here is fine, as for a
+// growth in processSubBlock. The sides' frozen loops and filter states are
+// not carried over; a freeze still on recaptures its loop from the history.
+void SharcEchoAudioProcessor::joinStereoSides(const SharcParameterEngine::BlockParameters& block)
+{
+    SharcRealtimeChecker::ScopedSource realtimeSource(SharcRealtimeChecker::Source::output);
+
+    // Each side's history (none once asleep), newest frames aligned at the
+    // write head, interleaved the way the line stores it
+    const int maxFrames = static_cast<int>(std::ceil(currentSampleRate * maxDelaySeconds)) + SharcRingStorage::tapFrames;
+    std::vector<float> sides[2] { std::vector<float>(static_cast<size_t>(maxFrames)),
+                                  std::vector<float>(static_cast<size_t>(maxFrames)) };
+    int sideFrames[2] {};
+
+    for (int side = 0; side < 2; ++side)
+        sideFrames[side] = renderGroups.getUnchecked(side)->bank.copyHistory(sides[side].data(), maxFrames);
+
+    const int numFrames = juce::jmax(sideFrames[0], sideFrames[1]);
+    std::vector<float> history(static_cast<size_t>(SharcDelayLine::numChannels * numFrames));
+
+    for (int side = 0; side < 2; ++side)
+        for (int f = 0; f < sideFrames[side]; ++f)
+            history[static_cast<size_t>((numFrames - sideFrames[side] + f) * SharcDelayLine::numChannels + side)]
+                = sides[side][static_cast<size_t>(f)];
+
+    // Sized for the history as well as this pass's delay
+    const double initialDelay = juce::jmax(block.delayTarget, static_cast<double>(numFrames));
+    delayLine.setKernel(block.kernel);
+    delayLine.setRingFormat(block.ringFormat);
+    delayLine.prepare(currentSampleRate, maxDelaySeconds, static_cast<float>(initialDelay / currentSampleRate));
+    applyInitialBlock(delayLine, block);
+    delayLine.restoreHistory(history.data(), numFrames);
+
+    engineState.requestedKernel = block.kernel;
+    engineState.bypassed = renderGroups.getUnchecked(0)->state.bypassed;
+    activeKernel = delayLine.getActiveKernel();
+
+    for (auto* group : renderGroups)
+        group->bank.releaseStorage();
+
+    stereoSidesJoined = true;
+}
+
+// Each group runs every sub-block of the pass on its own channels, so the
+// threads meet once per pass, not once per sub-block
+template <typename SampleType>
+void SharcEchoAudioProcessor::processRenderGroups(SampleType* const* channels, int passStart, int passSamples,
+                                                  int numSubBlocks) noexcept
+{
+    struct PassJob : SharcRenderPool::Job
+    {
+        PassJob(SharcEchoAudioProcessor& p, SampleType* const* c, int start, int samples, int count)
+            : owner(p), channels(c), passStart(start), passSamples(samples), numSubBlocks(count)
+        {
+        }
+
+        void run(int index) noexcept override
+        {
+            auto& group = *owner.renderGroups.getUnchecked(index);
+
+            for (int i = 0; i < numSubBlocks; ++i)
+            {
+                const int offset = i * subBlockSize;
+                owner.processSubBlock(group.bank, group.state, channels + group.firstChannel, group.numChannels,
+                                      passStart + offset, juce::jmin(subBlockSize, passSamples - offset),
+                                      owner.schedule[static_cast<size_t>(i)]);
+            }
+        }
+
+        SharcEchoAudioProcessor& owner;
+        SampleType* const* channels;
+        const int passStart, passSamples, numSubBlocks;
+    };
+
+    PassJob job(*this, channels, passStart, passSamples, numSubBlocks);
+
+    // The host may switch back to realtime without a new prepareToPlay:
+    // then the groups run here, never waiting on the pool
+    if (isNonRealtime() && getTotalNumOutputChannels() * passSamples >= minParallelFrames)
+    {
+        renderPool.run(job, renderGroups.size());
+    }
+    else
+    {
+        for (int g = 0; g < renderGroups.size(); ++g)
+            job.run(g);
+    }
 }
 
 //==============================================================================
@@ -137,18 +761,104 @@ juce::AudioProcessorEditor* SharcEchoAudioProcessor::createEditor()
 //==============================================================================
 void SharcEchoAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
+   #if SHARC_BINARY_STATE
+    // The ring only holds something worth saving while a tail is ringing
+    std::unique_ptr<SharcStateFormat::History> history;
+
+    if (apvts.getRawParameterValue("savetail")->load() > 0.5f && renderGroups.isEmpty())
+        history = historyExchange.capture(useBank ? delayBank.getNumChannels() : SharcDelayLine::numChannels,
+                                          static_cast<int>(std::ceil(currentSampleRate * maxDelaySeconds)) + SharcRingStorage::tapFrames);
+
+    SharcStateFormat::write(destData, getParameters(), history.get());
+   #else
     auto state = apvts.copyState();
     std::unique_ptr<juce::XmlElement> xml(state.createXml());
     copyXmlToBinary(*xml, destData);
+   #endif
+}
+
+namespace
+{
+    // The first builds had "Use SIMD" (ID "simd", a bool) where "Processing
+    // Mode" is now: on is Auto, off is Scalar. A state with a "mode" keeps
+    // it.
+    void migrateUseSimd(juce::XmlElement& state)
+    {
+        if (state.getChildByAttribute("id", "mode") != nullptr)
+            return;
+
+        if (auto* simd = state.getChildByAttribute("id", "simd"))
+        {
+            const auto mode = simd->getDoubleAttribute("value") > 0.5 ? SharcKernelIsa::automatic : SharcKernelIsa::scalar;
+            simd->setAttribute("id", "mode");
+            simd->setAttribute("value", static_cast<int>(mode));
+        }
+    }
+
+    // Binary states from before the rename stored the choice index itself
+    // under "simd"
+    void migrateUseSimd(std::vector<SharcStateFormat::Value>& values)
+    {
+        for (const auto& v : values)
+            if (v.id == "mode")
+                return;
+
+        for (auto& v : values)
+            if (v.id == "simd")
+                v.id = "mode";
+    }
 }
 
 void SharcEchoAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
+    std::vector<SharcStateFormat::Value> values;
+    std::unique_ptr<SharcStateFormat::History> history;
+
+    if (SharcStateFormat::read(data, sizeInBytes, values, history))
+    {
+        migrateUseSimd(values);
+        applyStateValues(values);
+
+        if (history != nullptr)
+            historyExchange.restore(std::move(history));
+
+        return;
+    }
+
+    // States saved by earlier builds (or with SHARC_BINARY_STATE=0)
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
 
-    if (xmlState != nullptr)
-        if (xmlState->hasTagName(apvts.state.getType()))
-            apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
+    if (xmlState != nullptr && xmlState->hasTagName(apvts.state.getType()))
+    {
+        migrateUseSimd(*xmlState);
+        apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
+    }
+}
+
+void SharcEchoAudioProcessor::applyStateValues(const std::vector<SharcStateFormat::Value>& values)
+{
+    for (auto* parameter : getParameters())
+    {
+        auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter);
+
+        if (ranged == nullptr)
+            continue;
+
+        float normalised = ranged->getDefaultValue();
+
+        for (const auto& v : values)
+        {
+            if (v.id == ranged->paramID)
+            {
+                normalised = ranged->convertTo0to1(v.value);
+                break;
+            }
+        }
+
+        // Unchanged values don't bother the host (sessions restore hundreds)
+        if (ranged->getValue() != normalised)
+            ranged->setValueNotifyingHost(normalised);
+    }
 }
 
 //==============================================================================
@@ -4,234 +4,56 @@
 
   Critical Fixes:
   - Stable delay formula: input + (feedback * delayed)
-  - Optimized SIMD (no modulo in inner loop)
-  - Smoothed CPU measurement
-  - Hard clipping to prevent overflow
+  - Optimized SIMD (no modulo in inner loop), runtime ISA dispatch
+  - Smoothed parameters (per-sample gain ramps, no string lookups)
+  - Fixed 128-frame sub-blocks: automation resolution independent of the
+    host buffer size
+  - Per-stage DSP profiling (p50/p99/max histograms), time-smoothed CPU meter
+  - Lock-free level telemetry to the editor, only while it is open
+  - Hard clip or soft (tanh-style, optionally 2x) saturation in the
+    feedback write to prevent overflow, after an optional low / high cut
+    (one fused biquad, vectorised with the write)
+  - Tempo sync to a host note division; up to 8 output taps with gain and
+    pan, read from the same ring in one pass
+  - Stereo cross feedback (a 2x2 feedback matrix) and ping-pong, in the
+    same pass as the feedback multiply
+  - Freeze: the delay memory becomes a read-only loop (no write, no
+    feedback, no clip), released at the loop's end without a click
+  - Click-free bypass crossfade; silent input + decayed tail skips the DSP
+  - Delay memory sized for the delay in use, grown off the audio thread
+  - Any matching in/out layout: stereo runs SharcDelayLine, every other
+    width (mono, 5.1, 7.1.4, ambisonics) one SharcDelayBank
+  - 32- or 64-bit host buffers; the ring stays float, the dry path runs at
+    the host's precision
+  - Optional 16-bit delay memory (half the ring footprint), converted in
+    the kernels' loads and stores
+  - Offline renders split the bus into channel groups on a persistent
+    worker pool, optionally with higher-quality interpolation / saturation
+  - Tail length from the effective delay and feedback down to a chosen
+    floor, re-reported to the host when it changes (no lookahead, so no
+    latency to report)
+  - Compact binary state (XML still read), restored through the parameter
+    smoothers; optionally with the delay history, so a tail survives a
+    session reopen
+  - Optional realtime safety checks (SHARC_REALTIME_CHECKS): allocations
+    and locks inside processBlock, counted per block and per stage
 */
 
 #pragma once
 #include <JuceHeader.h>
-
-//==============================================================================
-// SHARC-style Stereo Delay Line (CORRECTED STABLE ALGORITHM)
-// Formula: buffer[n] = input[n] + (feedback * delayed[n-M])
-//          output[n] = (input[n] * dry) + (delayed[n-M] * wet)
-//==============================================================================
-class SharcDelayLine
-{
-public:
-    SharcDelayLine() = default;
-
-    void prepare(double sRate, float maxDelaySeconds = 5.0f)
-    {
-        this->sRate = sRate;
-
-        // Calculate max delay line size
-        maxDelaySamples = static_cast<int>(sRate * maxDelaySeconds);
-
-        // Allocate delay buffers
-        delayLineLeft.resize(static_cast<size_t>(maxDelaySamples));
-        delayLineRight.resize(static_cast<size_t>(maxDelaySamples));
-
-        // Zero delay lines
-        reset();
-        prepared = true;
-    }
-
-    void setDelaySeconds(float seconds)
-    {
-        delaySamples = static_cast<int>(seconds * sRate);
-        delaySamples = juce::jlimit(1, maxDelaySamples, delaySamples);
-    }
-
-    void setFeedback(float fb)
-    {
-        feedback = juce::jlimit(0.0f, 0.99f, fb);
-    }
-
-    void setWetMix(float wet)
-    {
-        wetMix = juce::jlimit(0.0f, 1.0f, wet);
-    }
-
-    void setDryMix(float dry)
-    {
-        dryMix = juce::jlimit(0.0f, 1.0f, dry);
-    }
-
-    void reset()
-    {
-        std::fill(delayLineLeft.begin(), delayLineLeft.end(), 0.0f);
-        std::fill(delayLineRight.begin(), delayLineRight.end(), 0.0f);
-        delayIndex = 0;
-    }
-
-    // Scalar version - CORRECTED STABLE FORMULA
-    void processBlockScalar(const float* inputLeft, const float* inputRight,
-        float* outputLeft, float* outputRight, int numSamples) noexcept
-    {
-        if (!prepared) return;
-
-        auto* bufferLeft = delayLineLeft.data();
-        auto* bufferRight = delayLineRight.data();
-        int idx = delayIndex;
-        const int len = delaySamples;
-        const float fb = feedback;
-        const float wet = wetMix;
-        const float dry = dryMix;
-
-        for (int i = 0; i < numSamples; ++i)
-        {
-            // 1. Read delayed sample
-            const float delayedLeft = bufferLeft[idx];
-            const float delayedRight = bufferRight[idx];
-
-            // 2. Mix and output
-            outputLeft[i] = (inputLeft[i] * dry) + (delayedLeft * wet);
-            outputRight[i] = (inputRight[i] * dry) + (delayedRight * wet);
-
-            // 3. STABLE FORMULA: input + (feedback * delayed)
-            //    This ensures exponential decay, not growth
-            float newLeft = inputLeft[i] + (fb * delayedLeft);
-            float newRight = inputRight[i] + (fb * delayedRight);
-
-            // 4. Hard clip to prevent overflow (safety)
-            bufferLeft[idx] = juce::jlimit(-1.0f, 1.0f, newLeft);
-            bufferRight[idx] = juce::jlimit(-1.0f, 1.0f, newRight);
-
-            // 5. Circular buffer wraparound
-            if (++idx >= len)
-                idx = 0;
-        }
-
-        delayIndex = idx;
-    }
-
-    // SIMD version - OPTIMIZED (no modulo in inner loop!)
-    void processBlockSIMD(const float* inputLeft, const float* inputRight,
-        float* outputLeft, float* outputRight, int numSamples) noexcept
-    {
-        if (!prepared) return;
-
-        using SIMD = juce::dsp::SIMDRegister<float>;
-        constexpr int simdWidth = static_cast<int>(SIMD::SIMDRegister::size());
-
-        auto* bufferLeft = delayLineLeft.data();
-        auto* bufferRight = delayLineRight.data();
-        int idx = delayIndex;
-        const int len = delaySamples;
-        const float fb = feedback;
-        const float wet = wetMix;
-        const float dry = dryMix;
-
-        // Pre-load constants into SIMD registers
-        const SIMD dryVec(dry);
-        const SIMD wetVec(wet);
-        const SIMD fbVec(fb);
-        const SIMD clipMin(-1.0f);
-        const SIMD clipMax(1.0f);
-
-        int samplesRemaining = numSamples;
-
-        // Process in chunks that don't cross buffer boundary
-        while (samplesRemaining > 0)
-        {
-            // Calculate samples until buffer edge (no modulo needed!)
-            const int samplesToEdge = juce::jmin(samplesRemaining, len - idx);
-            const int simdChunks = samplesToEdge / simdWidth;
-            const int scalarTail = samplesToEdge % simdWidth;
-
-            // SIMD main loop - contiguous memory access
-            for (int chunk = 0; chunk < simdChunks; ++chunk)
-            {
-                const int offset = idx + (chunk * simdWidth);
-
-                // Load from contiguous memory (fast!)
-                SIMD delayedLeftVec = SIMD::fromRawArray(bufferLeft + offset);
-                SIMD delayedRightVec = SIMD::fromRawArray(bufferRight + offset);
-                SIMD inputLeftVec = SIMD::fromRawArray(inputLeft);
-                SIMD inputRightVec = SIMD::fromRawArray(inputRight);
-
-                // Mix and output
-                SIMD outL = inputLeftVec * dryVec + delayedLeftVec * wetVec;
-                SIMD outR = inputRightVec * dryVec + delayedRightVec * wetVec;
-                outL.copyToRawArray(outputLeft);
-                outR.copyToRawArray(outputRight);
-
-                // Update delay lines with STABLE FORMULA
-                SIMD newL = inputLeftVec + (delayedLeftVec * fbVec);
-                SIMD newR = inputRightVec + (delayedRightVec * fbVec);
-
-                // Hard clip (SIMD max/min)
-                newL = juce::jmax(clipMin, juce::jmin(clipMax, newL));
-                newR = juce::jmax(clipMin, juce::jmin(clipMax, newR));
-
-                newL.copyToRawArray(bufferLeft + offset);
-                newR.copyToRawArray(bufferRight + offset);
-
-                // Advance input/output pointers
-                inputLeft += simdWidth;
-                inputRight += simdWidth;
-                outputLeft += simdWidth;
-                outputRight += simdWidth;
-            }
-
-            // Update index after SIMD chunks
-            idx += simdChunks * simdWidth;
-
-            // Scalar tail (remaining samples before edge)
-            for (int i = 0; i < scalarTail; ++i)
-            {
-                const float delayedLeft = bufferLeft[idx];
-                const float delayedRight = bufferRight[idx];
-
-                *outputLeft = (*inputLeft * dry) + (delayedLeft * wet);
-                *outputRight = (*inputRight * dry) + (delayedRight * wet);
-
-                float newLeft = *inputLeft + (fb * delayedLeft);
-                float newRight = *inputRight + (fb * delayedRight);
-
-                bufferLeft[idx] = juce::jlimit(-1.0f, 1.0f, newLeft);
-                bufferRight[idx] = juce::jlimit(-1.0f, 1.0f, newRight);
-
-                ++inputLeft;
-                ++inputRight;
-                ++outputLeft;
-                ++outputRight;
-                ++idx;
-            }
-
-            samplesRemaining -= samplesToEdge;
-
-            // Wrap only at buffer edge (once per chunk)
-            if (idx >= len)
-                idx = 0;
-        }
-
-        delayIndex = idx;
-    }
-
-private:
-    std::vector<float> delayLineLeft;
-    std::vector<float> delayLineRight;
-    int maxDelaySamples = 240000;
-    int delaySamples = 48000;
-    int delayIndex = 0;
-
-    float feedback = 0.3f;
-    float wetMix = 0.5f;
-    float dryMix = 0.5f;
-
-    double sRate = 48000.0;
-    bool prepared = false;
-
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SharcDelayLine)
-};
+#include "SharcDelayLine.h"
+#include "SharcDelayBank.h"
+#include "SharcParameterEngine.h"
+#include "SharcProfiler.h"
+#include "SharcRenderPool.h"
+#include "SharcState.h"
+#include "SharcTelemetry.h"
 
 //==============================================================================
 // Main Plugin Processor
 //==============================================================================
-class SharcEchoAudioProcessor : public juce::AudioProcessor
+class SharcEchoAudioProcessor : public juce::AudioProcessor,
+                                private juce::AsyncUpdater
 {
 public:
     SharcEchoAudioProcessor();
@@ -241,6 +63,8 @@ public:
     void releaseResources() override;
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override { return true; }
@@ -249,7 +73,7 @@ public:
     bool acceptsMidi() const override { return false; }
     bool producesMidi() const override { return false; }
     bool isMidiEffect() const override { return false; }
-    double getTailLengthSeconds() const override { return 5.0; }
+    double getTailLengthSeconds() const override;
 
     int getNumPrograms() override { return 1; }
     int getCurrentProgram() override { return 0; }
@@ -261,19 +85,167 @@ public:
     void setStateInformation(const void* data, int sizeInBytes) override;
 
     juce::AudioProcessorValueTreeState& getAPVTS() { return apvts; }
-    float getCpuUsage() const { return smoothedCpuUsage.getCurrentValue(); }
+    // Block time / block duration, smoothed over ~500 ms (can exceed 1)
+    float getCpuUsage() const { return cpuUsage.load(std::memory_order_relaxed); }
+    SharcProfiler& getProfiler() { return profiler; }
+    SharcTelemetry& getTelemetry() { return telemetry; }
+    SharcKernelIsa getActiveKernel() const { return activeKernel.load(); }
+
+    // What the tail report was last computed from, for the editor's decay
+    // plot: the delay in use (sync, "Max Delay" and glides included), the
+    // smoothed feedback and "Tail Floor". Any thread.
+    struct TailEstimate
+    {
+        float delaySeconds = 0.0f;
+        float feedback = 0.0f;
+        float floorDb = 0.0f;
+    };
+
+    TailEstimate getTailEstimate() const noexcept;
 
 private:
     juce::AudioProcessorValueTreeState apvts;
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
-    SharcDelayLine delayLine;
+    // Message thread: grows / frees delay memory the audio thread asked for
+    void handleAsyncUpdate() override;
+
+    // Seconds until the feedback loop, starting at 0 dB, is below the
+    // "Tail Floor" parameter; infinite while frozen
+    double computeTailSeconds(double delaySamples, float feedback, bool frozen) const;
+
+    // Sets every parameter to its value in the state (the default if it
+    // has none); the engine's smoothers ramp to them
+    void applyStateValues(const std::vector<SharcStateFormat::Value>& values);
+
+    // Both processBlock overloads (float / double host buffers)
+    template <typename SampleType>
+    void process(juce::AudioBuffer<SampleType>& buffer);
+
+    // What processSubBlock keeps per delay engine: the kernel it asked
+    // for, the bypass state and the input copy for the bypass crossfade
+    // (one sub-block, per sample type)
+    struct EngineState
+    {
+        SharcKernelIsa requestedKernel = SharcKernelIsa::automatic;
+        bool bypassed = false;
+        juce::AudioBuffer<float> bypassBuffer;
+        juce::AudioBuffer<double> bypassBufferDouble;
+
+        void prepare(int numChannels, const SharcParameterEngine::BlockParameters& initial)
+        {
+            requestedKernel = initial.kernel;
+            bypassed = initial.isFullyBypassed();
+            bypassBuffer.setSize(numChannels, subBlockSize);
+            bypassBufferDouble.setSize(numChannels, subBlockSize);
+        }
+
+        void release()
+        {
+            bypassBuffer.setSize(0, 0);
+            bypassBufferDouble.setSize(0, 0);
+        }
+
+        template <typename SampleType>
+        juce::AudioBuffer<SampleType>& getBypassBuffer() noexcept
+        {
+            if constexpr (std::is_same_v<SampleType, double>)
+                return bypassBufferDouble;
+            else
+                return bypassBuffer;
+        }
+    };
+
+    // One sub-block of `numChannels` bus channels on one engine (the line,
+    // the bank or a render group's bank)
+    template <typename SampleType, typename Engine>
+    void processSubBlock(Engine& delay, EngineState& state, SampleType* const* channels, int numChannels,
+                         int offset, int numSamples, const SharcParameterEngine::BlockParameters& block) noexcept;
+
+    // A pass of the schedule on every render group, on the pool when it
+    // is long enough to pay for the dispatch
+    template <typename SampleType>
+    void processRenderGroups(SampleType* const* channels, int passStart, int passSamples, int numSubBlocks) noexcept;
+
+    // A split stereo render from the first pass with cross feedback or
+    // ping-pong on: the two sides' histories go into delayLine, which runs
+    // the bus from then on
+    bool passCouplesStereo(int numSubBlocks) const noexcept;
+    void joinStereoSides(const SharcParameterEngine::BlockParameters& block);
+
+    SharcParameterEngine parameters;
+
+    // processBlock runs in sub-blocks of this many frames: ~2.7 ms at
+    // 48 kHz, and a multiple of the widest kernel (16 frames), so the
+    // write head stays register-aligned from one sub-block to the next
+    static constexpr int subBlockSize = 128;
+
+    // Longest delay any engine is prepared for
+    static constexpr float maxDelaySeconds = 5.0f;
+    std::vector<SharcParameterEngine::BlockParameters> schedule;
+    SharcDelayLine delayLine;       // stereo (interleaved, the tuned path)
+    SharcDelayBank delayBank;       // any other channel count
+    EngineState engineState;        // of whichever of the two is in use
+    bool useBank = false;
+
+    // Offline renders (prepared while isNonRealtime()): contiguous channel
+    // groups with a bank each, one group per core. Empty otherwise.
+    struct RenderGroup
+    {
+        SharcDelayBank bank;
+        EngineState state;
+        int firstChannel = 0;
+        int numChannels = 0;
+    };
+
+    juce::OwnedArray<RenderGroup> renderGroups;
+    SharcRenderPool renderPool;
+
+    // Set by joinStereoSides(); the groups then sit unused (the message
+    // thread still walks them) until the next prepare
+    bool stereoSidesJoined = false;
+
+    // Channel-frames below which a pass runs on the calling thread (about
+    // 4 us of kernel work, more than a dispatch to spinning workers)
+    static constexpr int minParallelFrames = 8192;
 
     double currentSampleRate = 48000.0;
-    bool useSIMD = false;
+    std::atomic<SharcKernelIsa> activeKernel { SharcKernelIsa::scalar };
+
+    // Delay history for "Save Tail" states (the audio thread copies it;
+    // saves wait for that out of a process-wide budget)
+    SharcHistoryExchange historyExchange;
+
+    // getTailLengthSeconds(): kept by the audio thread from the delay and
+    // feedback actually in use (sync and "Max Delay" included; -1 before
+    // the first prepare). The host is told once it has moved by more than
+    // tailChangeRatio from what it last read.
+    std::atomic<double> tailSeconds { -1.0 };
+    std::atomic<double> reportedTailSeconds { 0.0 };
+    static constexpr double tailChangeRatio = 0.1;
+
+    // By more than tailChangeRatio, or into / out of a freeze (infinity)
+    static bool hasTailMoved(double tail, double reported) noexcept
+    {
+        return std::isinf(tail) != std::isinf(reported) || std::abs(tail - reported) > tailChangeRatio * reported;
+    }
+    std::atomic<float>* tailFloor;  // "Tail Floor", looked up once: process() reads it
+
+    // What tailSeconds was computed from, for getTailEstimate() (-1: not
+    // prepared)
+    std::atomic<float> tailDelaySeconds { -1.0f };
+    std::atomic<float> tailFeedbackInUse { 0.0f };
+
+    // Stage timings of every processed block (and, in checked builds,
+    // allocations / locks inside it)
+    SharcProfiler profiler;
+
+    // Level frames for the editor (collected only while it is open)
+    SharcTelemetry telemetry;
 
-    // Smoothed CPU measurement (500ms smoothing)
-    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> smoothedCpuUsage;
+    // One-pole CPU meter, time constant in seconds (not blocks)
+    static constexpr double cpuSmoothingSeconds = 0.5;
+    std::atomic<float> cpuUsage { 0.0f };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SharcEchoAudioProcessor)
 };
\ No newline at end of file
@@ -0,0 +1,582 @@
+/*
+  SHARC Echo/Delay Effect Plugin - Delay Bank
+  JUCE 8.0.11 - N-channel delay for multichannel / immersive layouts
+
+  One object for every channel of a wide bus (5.1, 7.1.4, ambisonics...),
+  so a 12-channel mix costs one set of smoothers, one kernel dispatch and
+  one pooled allocation instead of six stacked stereo instances.
+
+  Storage is SoA: one mono row per channel, all rows in a single cache-line
+  aligned block (SharcRingStorage) with the same power-of-two length, mask,
+  mirrored guard and on-demand growth as SharcDelayLine. Rows match the
+  planar host buffers, so each channel is vectorised along time with no
+  (de)interleave; a single dispatched call runs the whole bank. Every channel keeps its own delay, feedback, wet,
+  dry and ramps. Like SharcDelayLine, the whole bank sleeps once every
+  channel's input is silent and the longest feedback tail has decayed.
+  Double I/O works as in SharcDelayLine (float rows, dry path in double),
+  and so do setRingFormat() (float or 16-bit rows) and setFreeze() (one
+  loop length, the longest channel delay, for every row). Past the
+  streaming threshold each row's feedback read window is prefetched
+  before the block, as in SharcDelayLine; the bank has no non-temporal
+  writes.
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "SharcDelayLine.h"
+
+//==============================================================================
+class SharcDelayBank
+{
+public:
+    static constexpr int maxChannels = 64;
+
+    SharcDelayBank() = default;
+
+    // Allocates the rows; call off the audio thread. Same sizing rules as
+    // SharcDelayLine::prepare().
+    void prepare(double sRate, int numChannels, float maxDelaySeconds = 5.0f, float initialDelaySeconds = -1.0f)
+    {
+        jassert(numChannels > 0 && numChannels <= maxChannels);
+
+        this->sRate = sRate;
+        this->numChannels = juce::jlimit(1, maxChannels, numChannels);
+
+        maxDelaySamples = static_cast<int>(sRate * maxDelaySeconds);
+        delayLimit = maxDelaySamples;
+
+        const double initial = initialDelaySeconds < 0.0f ? maxDelaySamples
+                                                          : juce::jmin(static_cast<double>(maxDelaySamples), initialDelaySeconds * sRate);
+        storage.prepare(this->numChannels, 1, static_cast<int>(std::ceil(initial)), maxDelaySamples, ringFormat);
+
+        allpassState.resize(static_cast<size_t>(this->numChannels));
+        writeState.resize(static_cast<size_t>(this->numChannels));
+        feedbackFilter.setCutoffs(sRate, feedbackFilter.getLowCut(), feedbackFilter.getHighCut());
+        ramps.resize(static_cast<size_t>(this->numChannels), SharcKernelParams { 0.3f, 0.5f, 0.5f });
+        blockParams.resize(ramps.size());
+        doubleRamps.resize(ramps.size());
+        chunkBuffer.resize(static_cast<size_t>(2 * this->numChannels * SharcDelayLine::ioChunkFrames));
+
+        setKernel(requestedKernel);
+
+        reset();
+        prepared = true;
+    }
+
+    void setKernel(SharcKernelIsa requested) noexcept
+    {
+        requestedKernel = requested;
+        activeKernel = SharcDelayKernels::resolve(requested);
+        kernel = SharcDelayKernels::getBankKernel(activeKernel);
+    }
+
+    SharcKernelIsa getRequestedKernel() const noexcept { return requestedKernel; }
+    SharcKernelIsa getActiveKernel() const noexcept { return activeKernel; }
+    int getNumChannels() const noexcept { return numChannels; }
+
+    // See SharcDelayLine
+    void setRingFormat(SharcRingFormat format) noexcept
+    {
+        ringFormat = format;
+        storage.requestFormat(format);
+    }
+
+    SharcRingFormat getRingFormat() const noexcept { return ringFormat; }
+
+    // See SharcDelayLine
+    void setMaxDelaySeconds(float seconds) noexcept
+    {
+        delayLimit = juce::jlimit(static_cast<int>(SharcDelayLine::minDelaySamples), maxDelaySamples, static_cast<int>(seconds * sRate));
+    }
+
+    void reserveDelay(double delaySamples) noexcept
+    {
+        storage.request(juce::jmin(static_cast<double>(delayLimit), delaySamples));
+    }
+
+    void serviceStorage() { storage.service(); }
+    bool needsStorageService() const noexcept { return storage.needsService(); }
+
+    // See SharcDelayLine. The read distance counts a whole bank frame,
+    // since every row is written each frame.
+    void setStreamingThreshold(size_t bytes) noexcept { streamingThreshold = bytes; }
+    size_t getStreamingThreshold() const noexcept { return streamingThreshold; }
+    bool isStreaming() const noexcept { return streaming; }
+
+    // See SharcDelayLine
+    void releaseStorage() noexcept
+    {
+        prepared = false;
+        storage.release();
+        reset();
+    }
+
+    // A bank that is one side of a stereo bus split across banks (offline
+    // render groups): its taps take that side's panned gain, as the
+    // SharcDelayLine the bus would otherwise run on
+    enum class StereoSide { none, left, right };
+
+    void setStereoSide(StereoSide side) noexcept { stereoSide = side; }
+
+    // See SharcDelayLine; one table for every channel (gains only, rows
+    // are mono, unless the bank is one stereo side)
+    void setTaps(const SharcTapTable& newTaps) noexcept
+    {
+        taps = newTaps;
+
+        if (stereoSide != StereoSide::none)
+            std::copy_n(stereoSide == StereoSide::left ? newTaps.gainLeft : newTaps.gainRight,
+                        SharcTapTable::maxTaps, taps.gain);
+    }
+
+    // See SharcDelayLine; one filter for every channel
+    void setFeedbackFilter(float lowCutHz, float highCutHz) noexcept
+    {
+        if (feedbackFilter.setCutoffs(sRate, lowCutHz, highCutHz))
+            for (auto& state : writeState)
+                std::fill(std::begin(state.filter), std::end(state.filter), 0.0f);
+    }
+
+    // Same ramps for every channel (the plugin's global parameters)
+    void setParameterRamps(const SharcKernelParams& newRamps) noexcept
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+            setChannelParameterRamps(ch, newRamps);
+    }
+
+    // Per-channel delay / feedback / mix, for the next process call only
+    // (same semantics as SharcDelayLine::setParameterRamps). Rows are mono:
+    // the stereo cross feedback and ping-pong are dropped.
+    void setChannelParameterRamps(int channel, const SharcKernelParams& newRamps) noexcept
+    {
+        jassert(juce::isPositiveAndBelow(channel, numChannels));
+
+        auto& r = ramps[static_cast<size_t>(channel)];
+        r = newRamps;
+        r.feedback = juce::jlimit(0.0f, SharcDelayLine::maxFeedback, r.feedback);
+        r.cross = r.crossStep = 0.0f;
+        r.pingPong = false;
+        reserveDelay(r.delay);
+        r.delay = clampDelay(r.delay);
+    }
+
+    // See SharcDelayLine; every row loops over the longest channel delay
+    void setFreeze(bool shouldFreeze) noexcept { freezeRequested = shouldFreeze; }
+    bool isFrozen() const noexcept { return ring.freeze.isActive(); }
+
+    // Only the written part of each row is cleared
+    void reset()
+    {
+        storage.clear();
+        std::fill(allpassState.begin(), allpassState.end(), 0.0f);
+        std::fill(writeState.begin(), writeState.end(), SharcWriteState());
+
+        ring = SharcBankRing();
+        ring.allpassState = allpassState.data();
+        ring.writeState = writeState.data();
+        ring.filter = &feedbackFilter;
+        ring.numChannels = numChannels;
+        pointRingAtStorage();
+
+        silence.setAsleep();
+    }
+
+    bool isAsleep() const noexcept { return silence.isAsleep(); }
+
+    // See SharcDelayLine (frames of getNumChannels() samples)
+    int copyHistory(float* destination, int maxFrames) const noexcept
+    {
+        if (!prepared || silence.isAsleep())
+            return 0;
+
+        double longest = 0.0;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            longest = juce::jmax(longest, ramps[static_cast<size_t>(ch)].delay);
+
+        const int numFrames = juce::jmin(maxFrames, storage.getLength(),
+                                         static_cast<int>(std::ceil(longest)) + SharcRingStorage::tapFrames);
+        storage.readHistory(destination, numFrames, ring.writeIndex);
+        return numFrames;
+    }
+
+    void restoreHistory(const float* source, int numFrames) noexcept
+    {
+        if (!prepared || numFrames <= 0)
+            return;
+
+        storage.writeHistory(source, numFrames, ring.writeIndex);
+        silence.wake();
+    }
+
+    // inputs / outputs: getNumChannels() planar buffers each. Per channel
+    // the output is its input (in place) or does not overlap it
+    void processBlockScalar(const float* const* inputs, float* const* outputs, int numSamples) noexcept
+    {
+        if (!prepared) return;
+
+        updateStorage();
+
+        if (playFrozen(false, inputs, outputs, numSamples))
+            return;
+
+        const auto* params = clampedForBlock(numSamples);
+
+        if (skipSilentBlock(inputs, outputs, numSamples))
+            return;
+
+        prepareLongDelay(params, numSamples);
+        SharcDelayKernels::detail::processBankScalar(ring, inputs, outputs, numSamples, params);
+        storage.markWritten(numSamples);
+        finishRamps(numSamples);
+    }
+
+    void processBlockSIMD(const float* const* inputs, float* const* outputs, int numSamples) noexcept
+    {
+        if (!prepared) return;
+
+        updateStorage();
+
+        if (playFrozen(true, inputs, outputs, numSamples))
+            return;
+
+        const auto* params = clampedForBlock(numSamples);
+
+        if (skipSilentBlock(inputs, outputs, numSamples))
+            return;
+
+        prepareLongDelay(params, numSamples);
+        kernel(ring, inputs, outputs, numSamples, params);
+        storage.markWritten(numSamples);
+        finishRamps(numSamples);
+    }
+
+    // In place: the host channels are input and output (zero copy)
+    void processBlockScalar(float* const* channels, int numSamples) noexcept
+    {
+        processBlockScalar(channels, channels, numSamples);
+    }
+
+    void processBlockSIMD(float* const* channels, int numSamples) noexcept
+    {
+        processBlockSIMD(channels, channels, numSamples);
+    }
+
+    // 64-bit host buffers, see SharcDelayLine
+    void processBlockScalar(const double* const* inputs, double* const* outputs, int numSamples) noexcept
+    {
+        processDoubleBlock(inputs, outputs, numSamples, false);
+    }
+
+    void processBlockSIMD(const double* const* inputs, double* const* outputs, int numSamples) noexcept
+    {
+        processDoubleBlock(inputs, outputs, numSamples, true);
+    }
+
+    void processBlockScalar(double* const* channels, int numSamples) noexcept
+    {
+        processDoubleBlock(channels, channels, numSamples, false);
+    }
+
+    void processBlockSIMD(double* const* channels, int numSamples) noexcept
+    {
+        processDoubleBlock(channels, channels, numSamples, true);
+    }
+
+private:
+    double clampDelay(double delaySamples) const noexcept
+    {
+        const int usable = juce::jmax(static_cast<int>(SharcDelayLine::minDelaySamples),
+                                      juce::jmin(delayLimit, storage.getAvailableDelay()));
+        return juce::jlimit(SharcDelayLine::minDelaySamples, static_cast<double>(usable), delaySamples);
+    }
+
+    void pointRingAtStorage() noexcept
+    {
+        ring.samples = storage.data();
+        ring.compact = storage.compactData();
+        ring.format = storage.getFormat();
+        ring.length = storage.getLength();
+        ring.mask = ring.length - 1;
+        ring.stride = storage.getRowStride();
+    }
+
+    void updateStorage() noexcept
+    {
+        if (storage.adoptPending(ring.writeIndex))
+            pointRingAtStorage();
+    }
+
+    // Keeps every channel's delay glide inside the ring
+    const SharcKernelParams* clampedForBlock(int numSamples) noexcept
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto params = ramps[static_cast<size_t>(ch)];
+
+            if (params.isDelayMoving() && numSamples > 0)
+            {
+                const double end = clampDelay(params.delay + params.delayStep * numSamples);
+                params.delayStep = (end - params.delay) / numSamples;
+            }
+
+            params.taps = taps.numTaps > 0 ? &taps : nullptr;
+            blockParams[static_cast<size_t>(ch)] = params;
+        }
+
+        return blockParams.data();
+    }
+
+    // See SharcDelayLine::prepareLongDelay(): prefetches the feedback read
+    // window of each row whose shortest read, taps included, is past the
+    // threshold
+    void prepareLongDelay(const SharcKernelParams* params, int numSamples) noexcept
+    {
+        const double bytesPerFrame = numChannels * (ring.format == SharcRingFormat::int16 ? sizeof(int16_t) : sizeof(float));
+        const int numFrames = juce::jmin(numSamples, SharcDelayLine::maxPrefetchFrames) + 4;
+        streaming = false;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const double delay = params[ch].delay;
+            double shortest = delay;
+
+            for (int t = 0; t < taps.numTaps; ++t)
+                shortest = juce::jmin(shortest, taps.getDelay(t, delay));
+
+            if (shortest * bytesPerFrame < static_cast<double>(streamingThreshold))
+                continue;
+
+            streaming = true;
+            const int first = ring.writeIndex - static_cast<int>(delay) - 2;
+
+            if (ring.format == SharcRingFormat::int16)
+                sharcPrefetchFrames<1>(ring.row<int16_t>(ch), ring.mask, first, numFrames);
+            else
+                sharcPrefetchFrames<1>(ring.row<float>(ch), ring.mask, first, numFrames);
+        }
+    }
+
+    // See SharcDelayLine::playFrozen(); ramps are advanced row by row
+    bool playFrozen(bool simd, const float* const* inputs, float* const* outputs, int numSamples) noexcept
+    {
+        if (freezeRequested && !ring.freeze.isActive())
+        {
+            double longest = 0.0;
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                longest = juce::jmax(longest, ramps[static_cast<size_t>(ch)].delay);
+
+            ring.freeze.length = juce::jlimit(static_cast<int>(SharcDelayLine::minDelaySamples), ring.length,
+                                              juce::roundToInt(longest));
+            ring.freeze.phase = 0;
+
+            const int fadeFrames = juce::jmin(juce::roundToInt(sRate * SharcDelayLine::freezeSeamSeconds),
+                                              ring.freeze.length / 2, ring.length - ring.freeze.length);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                if (ring.format == SharcRingFormat::int16)
+                    sharcFadeLoopSeam<1>(ring.row<int16_t>(ch), ring.length, ring.mask, ring.writeIndex, ring.freeze.length, fadeFrames);
+                else
+                    sharcFadeLoopSeam<1>(ring.row<float>(ch), ring.length, ring.mask, ring.writeIndex, ring.freeze.length, fadeFrames);
+            }
+        }
+
+        if (!ring.freeze.isActive())
+            return false;
+
+        const int remaining = freezeRequested ? numSamples : (ring.freeze.length - ring.freeze.phase) % ring.freeze.length;
+        const int played = juce::jmin(remaining, numSamples);
+        const auto* params = clampedForBlock(numSamples);
+
+        if (played > 0 && freezeRequested)
+            (simd ? kernel : SharcDelayKernels::detail::processBankScalar)(ring, inputs, outputs, played, params);
+        else if (played > 0)
+            releaseFrozen(inputs, outputs, played, params);
+
+        if (freezeRequested || ring.freeze.phase != 0)
+        {
+            finishRamps(numSamples);
+            return true;
+        }
+
+        ring.freeze = SharcFreezeLoop();
+        silence.wake();
+
+        if (played == numSamples)
+        {
+            finishRamps(numSamples);
+            return true;
+        }
+
+        const float* restInputs[maxChannels];
+        float* restOutputs[maxChannels];
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto& r = ramps[static_cast<size_t>(ch)];
+            r = r.advancedBy(played);
+            restInputs[ch] = inputs[ch] + played;
+            restOutputs[ch] = outputs[ch] + played;
+        }
+
+        if (simd)
+            processBlockSIMD(restInputs, restOutputs, numSamples - played);
+        else
+            processBlockScalar(restInputs, restOutputs, numSamples - played);
+
+        return true;
+    }
+
+    // See SharcDelayLine::releaseFrozen(), row by row
+    void releaseFrozen(const float* const* inputs, float* const* outputs, int numSamples, const SharcKernelParams* params) noexcept
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            if (ring.format == SharcRingFormat::int16)
+                sharcReleaseFrozenSteps<1>(ring.row<int16_t>(ch), ring.freeze, ring.length, ring.mask, ring.writeIndex,
+                    inputs + ch, outputs + ch, numSamples, params[ch], ring.filter, ring.writeState + ch);
+            else
+                sharcReleaseFrozenSteps<1>(ring.row<float>(ch), ring.freeze, ring.length, ring.mask, ring.writeIndex,
+                    inputs + ch, outputs + ch, numSamples, params[ch], ring.filter, ring.writeState + ch);
+        }
+
+        if (ring.writeIndex < ring.freeze.length)
+            storage.markWritten(ring.length);
+
+        ring.freeze.advance(numSamples);
+    }
+
+    // Silent input on a decayed (or empty) bank: dry signal only. Expects
+    // blockParams from clampedForBlock().
+    bool skipSilentBlock(const float* const* inputs, float* const* outputs, int numSamples) noexcept
+    {
+        double maxDelay = 0.0;
+        float maxFb = 0.0f;
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto& params = blockParams[static_cast<size_t>(ch)];
+            const auto end = params.at(numSamples);
+            maxDelay = juce::jmax(maxDelay, params.delay, end.delay);
+            maxFb = juce::jmax(maxFb, params.feedback, end.feedback);
+        }
+
+        const auto state = silence.update(inputs, numChannels, numSamples, maxDelay, maxFb);
+
+        if (state == SharcSilenceTracker::State::running)
+            return false;
+
+        if (state == SharcSilenceTracker::State::fallingAsleep)
+            reset();
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto& params = blockParams[static_cast<size_t>(ch)];
+            SharcSilenceTracker::applyDry(inputs[ch], outputs[ch], numSamples, params.dry, params.dryStep);
+        }
+
+        finishRamps(numSamples);
+        return true;
+    }
+
+    // Float chunks with the dry gains at zero, dry added in double (see
+    // SharcDelayLine::processDoubleBlock)
+    void processDoubleBlock(const double* const* inputs, double* const* outputs, int numSamples, bool simd) noexcept
+    {
+        if (!prepared || numSamples <= 0) return;
+
+        constexpr int chunkFrames = SharcDelayLine::ioChunkFrames;
+        float* chunkInputs[maxChannels];
+        float* chunkOutputs[maxChannels];
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            chunkOutputs[ch] = chunkBuffer.data() + static_cast<size_t>(2 * ch * chunkFrames);
+            chunkInputs[ch] = chunkOutputs[ch] + chunkFrames;
+        }
+
+        std::copy(ramps.begin(), ramps.end(), doubleRamps.begin());
+
+        for (int offset = 0; offset < numSamples; offset += chunkFrames)
+        {
+            const int chunk = juce::jmin(chunkFrames, numSamples - offset);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                for (int i = 0; i < chunk; ++i)
+                    chunkInputs[ch][i] = static_cast<float>(inputs[ch][offset + i]);
+
+                auto& r = ramps[static_cast<size_t>(ch)];
+                r = doubleRamps[static_cast<size_t>(ch)].advancedBy(offset);
+                r.dry = r.dryStep = 0.0f;
+            }
+
+            if (simd)
+                processBlockSIMD(chunkInputs, chunkOutputs, chunk);
+            else
+                processBlockScalar(chunkInputs, chunkOutputs, chunk);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const auto& r = doubleRamps[static_cast<size_t>(ch)];
+                SharcSilenceTracker::addDry(inputs[ch] + offset, chunkOutputs[ch], outputs[ch] + offset, chunk,
+                    r.dry, r.dryStep, offset);
+            }
+        }
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto& r = ramps[static_cast<size_t>(ch)];
+            r.dry = doubleRamps[static_cast<size_t>(ch)].at(numSamples).dry;
+            r.dryStep = 0.0f;
+        }
+    }
+
+    // Uses the clamped copies from the block that just ran
+    void finishRamps(int numSamples) noexcept
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto& params = blockParams[static_cast<size_t>(ch)];
+
+            if (!params.isRamping() && !params.isDelayMoving())
+                continue;
+
+            auto& r = ramps[static_cast<size_t>(ch)];
+            r = params.advancedBy(numSamples);
+            r.feedbackStep = r.wetStep = r.dryStep = r.crossStep = 0.0f;
+            r.delayStep = 0.0;
+        }
+    }
+
+    SharcRingStorage storage;
+    std::vector<float> allpassState;
+    std::vector<SharcWriteState> writeState;
+    SharcFeedbackFilter feedbackFilter;
+    SharcTapTable taps;
+    std::vector<SharcKernelParams> ramps, blockParams;
+    std::vector<SharcKernelParams> doubleRamps;     // block ramps of a double call
+    std::vector<float> chunkBuffer;                 // per channel: chunk output, then input
+    SharcBankRing ring;
+    SharcSilenceTracker silence;
+
+    int numChannels = 0;
+    int maxDelaySamples = 240000;
+    int delayLimit = 240000;
+    size_t streamingThreshold = SharcDelayLine::defaultStreamingThreshold;
+    bool streaming = false;
+    bool freezeRequested = false;
+    StereoSide stereoSide = StereoSide::none;
+    SharcRingFormat ringFormat = SharcRingFormat::float32;
+
+    SharcKernelIsa requestedKernel = SharcKernelIsa::automatic;
+    SharcKernelIsa activeKernel = SharcKernelIsa::scalar;
+    SharcBankKernelFn kernel = SharcDelayKernels::detail::processBankScalar;
+
+    double sRate = 48000.0;
+    bool prepared = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SharcDelayBank)
+};
@@ -0,0 +1,1092 @@
+/*
+  SHARC Echo/Delay Effect Plugin - Shared Kernel Body
+  JUCE 8.0.11
+
+  Included by each ISA translation unit *after* its target pragma, with an
+  Ops struct describing that instruction set:
+
+    Vec, width (floats per register), broadcast, load/store (aligned),
+    loadu/storeu, add, sub, mul, div, mulAdd (a * b + c), min, max,
+    interleave (L, R -> lo, hi frames), deinterleave (lo, hi -> L, R),
+    swapPairs (L and R of every interleaved frame exchanged),
+    previousFrames / previousSamples (prev, cur -> cur shifted one
+    interleaved frame / one lane later, filled from the end of prev),
+    broadcastPair (the two floats at p, repeated across the register),
+    stream (aligned non-temporal store), fence (orders earlier streams),
+    loadCompact / storeCompact (`width` int16 ring samples <-> floats, see
+    sharcRingSample; the store is aligned to width * 2 bytes)
+
+  Everything here has internal linkage, so each unit gets its own copy
+  compiled for its own ISA.
+
+  Gather-free fractional read: while the delay is steady every lane shares
+  the same fraction, so interpolation is a fixed 2- or 4-tap FIR over
+  contiguous (unaligned) loads of the ring. Gliding delays and the
+  recursive allpass take the per-frame path.
+
+  Each register holds half a step (width / 2 frames), and both halves are
+  addressed through the ring mask, so once the write head is on a register
+  boundary a block runs vectorised straight across the wrap; only the
+  alignment head and the sub-register tail go per frame.
+
+  Bank rows (SharcBankRing) are mono, so there each register is simply
+  `width` consecutive samples of one channel and needs no (de)interleave.
+
+  The vector loops are also specialised on which mix terms the block
+  needs (Mix: dry, wet, feedback), picked once per block: a kill-dry send
+  skips the dry multiply, a single echo the feedback multiply, and
+  wet = feedback = 0 skips the fractional read altogether. Results equal
+  the full formula (only the sign of an exact zero can differ).
+
+  The write saturation (SharcSaturation) is a template axis as well, so
+  the hard clip keeps its two-instruction write and soft / soft2x pay
+  only for themselves. So is the feedback filter (Filtered): with both
+  cuts off the write path is unchanged.
+
+  Tap heads (SharcTapTable) are a runtime loop instead: each head is one
+  more FIR over contiguous loads, with its gain (and for stereo its pan)
+  folded into the weights, summed into what the output hears.
+
+  The stereo feedback matrix and ping-pong send are runtime branches too,
+  outside every axis: each is one pair swap plus one multiply-add or
+  add-multiply per register on the write path.
+
+  A frozen ring (SharcFreezeLoop) leaves the whole chain at the top: it
+  only reads the loop and mixes it with the input, in runs that are
+  contiguous in both (sharcForEachFrozenRun).
+
+  The ring's sample type (Sample: float, or int16 for
+  SharcRingFormat::int16) is the outermost axis. Every ring access goes
+  through loadRing / storeRing, so a compact ring is widened to float in
+  the same load the FIR uses and narrowed in the same store that writes
+  it back; everything in between runs on floats either way.
+*/
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+    // Frame number of each lane in a pair of interleaved registers
+    // ([L0 R0 L1 R1 ...]), for building per-lane gain ramps
+    alignas(64) const float laneFrameOffsets[32] = { 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7,
+                                                     8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13, 14, 14, 15, 15 };
+
+    // Sample number of each lane in a mono bank row
+    alignas(64) const float laneSampleOffsets[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+
+    // One register of ring samples, unaligned (FIR taps start anywhere)
+    template <typename Ops>
+    SHARC_KERNEL_INLINE typename Ops::Vec loadRing(const float* p) noexcept { return Ops::loadu(p); }
+
+    template <typename Ops>
+    SHARC_KERNEL_INLINE typename Ops::Vec loadRing(const int16_t* p) noexcept { return Ops::loadCompact(p); }
+
+    // One register of ring samples, aligned
+    template <typename Ops>
+    SHARC_KERNEL_INLINE void storeRing(float* p, typename Ops::Vec v) noexcept { Ops::store(p, v); }
+
+    template <typename Ops>
+    SHARC_KERNEL_INLINE void storeRing(int16_t* p, typename Ops::Vec v) noexcept { Ops::storeCompact(p, v); }
+
+    // Aligned store of width / 2 frames starting at `index`, mirrored into
+    // the guard region when it lands in the first guardFrames frames.
+    // A float ring is streamed past the caches when it asks for it (a long
+    // delay evicts the frame long before it is read back); the guard copy
+    // is small and stays a normal store.
+    template <typename Ops, typename Sample>
+    inline void storeFrames(SharcRing& ring, int index, typename Ops::Vec frames) noexcept
+    {
+        Sample* data = ring.data<Sample>();
+
+        if (std::is_same_v<Sample, float> && ring.streamWrites)
+            Ops::stream(ring.frames + 2 * index, frames);
+        else
+            storeRing<Ops>(data + 2 * index, frames);
+
+        if (index < SharcRing::guardFrames)
+            storeRing<Ops>(data + 2 * (index + ring.length), frames);
+    }
+
+    // Mix terms a block needs; a term is only dropped if it is zero for
+    // the whole block (start and slope)
+    enum MixFlags
+    {
+        mixDry = 1,
+        mixWet = 2,
+        mixFeedback = 4,
+        mixAll = mixDry | mixWet | mixFeedback
+    };
+
+    inline int getMixFlags(const SharcKernelParams& params) noexcept
+    {
+        return (params.dry != 0.0f || params.dryStep != 0.0f ? mixDry : 0)
+             | (params.wet != 0.0f || params.wetStep != 0.0f ? mixWet : 0)
+             | (params.feedback != 0.0f || params.feedbackStep != 0.0f ? mixFeedback : 0);
+    }
+
+    // out = in * dry + delayed * wet, without the terms Mix drops
+    template <typename Ops, int Mix>
+    inline typename Ops::Vec mixOutput(typename Ops::Vec in, typename Ops::Vec delayed,
+        typename Ops::Vec dry, typename Ops::Vec wet) noexcept
+    {
+        if constexpr ((Mix & mixDry) != 0 && (Mix & mixWet) != 0)
+            return Ops::mulAdd(delayed, wet, Ops::mul(in, dry));
+        else if constexpr ((Mix & mixWet) != 0)
+            return Ops::mul(delayed, wet);
+        else if constexpr ((Mix & mixDry) != 0)
+            return Ops::mul(in, dry);
+        else
+            return Ops::broadcast(0.0f);
+    }
+
+    // in + delayed * feedback (STABLE FORMULA), before the clip
+    template <typename Ops, int Mix>
+    inline typename Ops::Vec feedbackInput(typename Ops::Vec in, typename Ops::Vec delayed, typename Ops::Vec fb) noexcept
+    {
+        if constexpr ((Mix & mixFeedback) != 0)
+            return Ops::mulAdd(delayed, fb, in);
+        else
+            return in;
+    }
+
+    template <typename Ops>
+    SHARC_KERNEL_INLINE typename Ops::Vec hardClip(typename Ops::Vec x) noexcept
+    {
+        return Ops::max(Ops::broadcast(-1.0f), Ops::min(Ops::broadcast(1.0f), x));
+    }
+
+    // sharcSoftClip as numerator / denominator, lane for lane
+    template <typename Ops>
+    SHARC_KERNEL_INLINE void softClipTerms(typename Ops::Vec x, typename Ops::Vec& num, typename Ops::Vec& den) noexcept
+    {
+        x = Ops::max(Ops::broadcast(-3.0f), Ops::min(Ops::broadcast(3.0f), x));
+        const auto x2 = Ops::mul(x, x);
+        num = Ops::mul(x, Ops::add(x2, Ops::broadcast(27.0f)));
+        den = Ops::mulAdd(x2, Ops::broadcast(9.0f), Ops::broadcast(27.0f));
+    }
+
+    // sharcSaturate, lane for lane. previous holds the unsaturated writes
+    // one step earlier (only read by soft2x).
+    template <typename Ops, SharcSaturation Saturation>
+    SHARC_KERNEL_INLINE typename Ops::Vec saturate(typename Ops::Vec x, typename Ops::Vec previous) noexcept
+    {
+        if constexpr (Saturation == SharcSaturation::soft)
+        {
+            typename Ops::Vec num, den;
+            softClipTerms<Ops>(x, num, den);
+            return Ops::div(num, den);
+        }
+        else if constexpr (Saturation == SharcSaturation::soft2x)
+        {
+            // x + ((f(x) - x) + (f(mid) - mid)) / 2 = (f(x) + f(mid)) / 2 + (x - mid) / 2,
+            // with both curve points over one divide
+            const auto half = Ops::broadcast(0.5f);
+            const auto mid = Ops::mul(Ops::add(previous, x), half);
+            typename Ops::Vec numX, denX, numMid, denMid;
+            softClipTerms<Ops>(x, numX, denX);
+            softClipTerms<Ops>(mid, numMid, denMid);
+
+            const auto curve = Ops::div(Ops::mulAdd(numX, denMid, Ops::mul(numMid, denX)), Ops::mul(denX, denMid));
+            return hardClip<Ops>(Ops::mul(Ops::add(curve, Ops::sub(x, mid)), half));
+        }
+        else
+        {
+            return hardClip<Ops>(x);
+        }
+    }
+
+    // Block form of SharcFeedbackFilter (see there) over one step of
+    // interleaved frames (`width` frames in lo / hi), L and R side by side.
+    // x[-1], x[-2] are carried as frame pairs; y[-1], y[-2] are read
+    // straight from the end of the last output, which keeps the
+    // step-to-step dependency down to one store / load. save() hands the
+    // state back to the ring for the per-frame head / tail.
+    template <typename Ops, bool Enabled>
+    struct FrameFilter
+    {
+        using Vec = typename Ops::Vec;
+        static constexpr int width = Ops::width;
+        static_assert(width <= SharcFeedbackFilter::maxFrames, "Filter tables are too short for this ISA");
+
+        FrameFilter(const SharcFeedbackFilter* f, SharcWriteState* s) noexcept : filter(f), state(s)
+        {
+            if constexpr (Enabled)
+            {
+                for (int ch = 0; ch < 2; ++ch)
+                {
+                    history[ch] = state[ch].filter[0];
+                    history[2 + ch] = state[ch].filter[1];
+                    y[width - 2 + ch] = state[ch].filter[2];
+                    y[width - 4 + ch] = state[ch].filter[3];
+                }
+            }
+        }
+
+        SHARC_KERNEL_INLINE void process(Vec& lo, Vec& hi) noexcept
+        {
+            if constexpr (Enabled)
+            {
+                Ops::store(x, lo);
+                Ops::store(x + width, hi);
+
+                // Frame j reaches the frames from j on; lo only holds the
+                // first half. Two sums each, the carried output last.
+                const float* h = filter->impulsePairs + 2 * SharcFeedbackFilter::maxFrames;
+                const auto* r = filter->stateResponsePairs;
+                const Vec x1 = Ops::broadcastPair(history), x2 = Ops::broadcastPair(history + 2);
+
+                Vec lo0 = Ops::mulAdd(x1, Ops::loadu(r[0]), Ops::mul(x2, Ops::loadu(r[1])));
+                Vec hi0 = Ops::mulAdd(x1, Ops::loadu(r[0] + width), Ops::mul(x2, Ops::loadu(r[1] + width)));
+                Vec lo1 = Ops::broadcast(0.0f), hi1 = lo1;
+
+                for (int j = 0; j < width / 2; j += 2)
+                {
+                    lo0 = Ops::mulAdd(Ops::broadcastPair(x + 2 * j), Ops::loadu(h - 2 * j), lo0);
+                    lo1 = Ops::mulAdd(Ops::broadcastPair(x + 2 * j + 2), Ops::loadu(h - 2 * j - 2), lo1);
+                }
+
+                for (int j = 0; j < width; j += 2)
+                {
+                    hi0 = Ops::mulAdd(Ops::broadcastPair(x + 2 * j), Ops::loadu(h + width - 2 * j), hi0);
+                    hi1 = Ops::mulAdd(Ops::broadcastPair(x + 2 * j + 2), Ops::loadu(h + width - 2 * j - 2), hi1);
+                }
+
+                const Vec y1 = Ops::broadcastPair(y + width - 2), y2 = Ops::broadcastPair(y + width - 4);
+                lo = Ops::add(Ops::add(lo0, lo1), Ops::mulAdd(y1, Ops::loadu(r[2]), Ops::mul(y2, Ops::loadu(r[3]))));
+                hi = Ops::add(Ops::add(hi0, hi1), Ops::mulAdd(y1, Ops::loadu(r[2] + width), Ops::mul(y2, Ops::loadu(r[3] + width))));
+
+                Ops::store(y, hi);
+                std::memcpy(history, x + 2 * width - 2, 2 * sizeof(float));
+                std::memcpy(history + 2, x + 2 * width - 4, 2 * sizeof(float));
+            }
+            else
+            {
+                static_cast<void>(lo);
+                static_cast<void>(hi);
+            }
+        }
+
+        void save() noexcept
+        {
+            if constexpr (Enabled)
+            {
+                for (int ch = 0; ch < 2; ++ch)
+                {
+                    state[ch].filter[0] = history[ch];
+                    state[ch].filter[1] = history[2 + ch];
+                    state[ch].filter[2] = y[width - 2 + ch];
+                    state[ch].filter[3] = y[width - 4 + ch];
+                }
+            }
+        }
+
+        const SharcFeedbackFilter* filter;
+        SharcWriteState* state;
+        alignas(64) float x[2 * width];
+        alignas(64) float y[width] {};
+        alignas(16) float history[4] {};    // x[-1] L R, x[-2] L R
+    };
+
+    // The same for a mono bank row: `width` samples of one channel
+    template <typename Ops, bool Enabled>
+    struct RowFilter
+    {
+        using Vec = typename Ops::Vec;
+        static constexpr int width = Ops::width;
+        static_assert(width <= SharcFeedbackFilter::maxFrames, "Filter tables are too short for this ISA");
+
+        RowFilter(const SharcFeedbackFilter* f, SharcWriteState& s) noexcept : filter(f), state(s)
+        {
+            if constexpr (Enabled)
+            {
+                history[0] = state.filter[0];
+                history[1] = state.filter[1];
+                y[width - 1] = state.filter[2];
+                y[width - 2] = state.filter[3];
+            }
+        }
+
+        SHARC_KERNEL_INLINE void process(Vec& samples) noexcept
+        {
+            if constexpr (Enabled)
+            {
+                Ops::store(x, samples);
+
+                const float* h = filter->impulse + SharcFeedbackFilter::maxFrames;
+                const auto* r = filter->stateResponse;
+
+                Vec sum0 = Ops::mulAdd(Ops::broadcast(history[0]), Ops::loadu(r[0]),
+                                       Ops::mul(Ops::broadcast(history[1]), Ops::loadu(r[1])));
+                Vec sum1 = Ops::broadcast(0.0f);
+
+                for (int j = 0; j < width; j += 2)
+                {
+                    sum0 = Ops::mulAdd(Ops::broadcast(x[j]), Ops::loadu(h - j), sum0);
+                    sum1 = Ops::mulAdd(Ops::broadcast(x[j + 1]), Ops::loadu(h - j - 1), sum1);
+                }
+
+                samples = Ops::add(Ops::add(sum0, sum1),
+                                   Ops::mulAdd(Ops::broadcast(y[width - 1]), Ops::loadu(r[2]),
+                                               Ops::mul(Ops::broadcast(y[width - 2]), Ops::loadu(r[3]))));
+
+                Ops::store(y, samples);
+                history[0] = x[width - 1];
+                history[1] = x[width - 2];
+            }
+            else
+            {
+                static_cast<void>(samples);
+            }
+        }
+
+        void save() noexcept
+        {
+            if constexpr (Enabled)
+            {
+                state.filter[0] = history[0];
+                state.filter[1] = history[1];
+                state.filter[2] = y[width - 1];
+                state.filter[3] = y[width - 2];
+            }
+        }
+
+        const SharcFeedbackFilter* filter;
+        SharcWriteState& state;
+        alignas(64) float x[width];
+        alignas(64) float y[width] {};
+        float history[2] {};                // x[-1], x[-2]
+    };
+
+    template <typename Ops>
+    struct GainRamp
+    {
+        typename Ops::Vec start, step;
+
+        GainRamp(float startValue, float stepValue) noexcept
+            : start(Ops::broadcast(startValue)), step(Ops::broadcast(stepValue)) {}
+
+        typename Ops::Vec at(typename Ops::Vec frame) const noexcept { return Ops::mulAdd(frame, step, start); }
+    };
+
+    template <typename Ops, typename Sample, bool Ramped, int NumTaps, SharcSaturation Saturation, bool Filtered, int Mix>
+    inline void processFramesImpl(SharcRing& ring,
+        const float* inputLeft, const float* inputRight,
+        float* outputLeft, float* outputRight,
+        int numFrames, const SharcKernelParams& params) noexcept
+    {
+        using Vec = typename Ops::Vec;
+        constexpr int width = Ops::width;
+        constexpr uintptr_t registerBytes = sizeof(Sample) * width;
+        static_assert(2 * width <= 32, "laneFrameOffsets is too short for this ISA");
+        constexpr bool readsDelay = (Mix & (mixWet | mixFeedback)) != 0;
+
+        // The fraction is the same for every frame: the delay is constant
+        const int mask = ring.mask;
+        const auto start = sharcReadPosition(ring.writeIndex, params.delay, mask);
+        const int readOffset = (ring.writeIndex - start.older) & mask;
+
+        float weights[4];
+        sharcTapWeights(params.interpolation, start.fraction, weights);
+
+        // NumTaps == 2 uses taps older / older+1, NumTaps == 4 adds older-1 / older+2
+        constexpr int firstTap = NumTaps == 4 ? -1 : 0;
+        constexpr int lastTap = NumTaps == 4 ? 2 : 1;
+        static_assert(width + lastTap - firstTap <= SharcRing::guardFrames, "Tap window overruns the guard region");
+
+        Vec tapWeights[4];
+        for (int m = firstTap; m <= lastTap; ++m)
+            tapWeights[m + 1] = Ops::broadcast(weights[m + 1]);
+
+        // Tap heads: fixed offsets too, L/R gains interleaved into the weights
+        const SharcTapTable* taps = (Mix & mixWet) != 0 ? params.taps : nullptr;
+        const int numHeads = taps != nullptr ? taps->numTaps : 0;
+        int headOffsets[SharcTapTable::maxTaps];
+        Vec headWeights[SharcTapTable::maxTaps][4];
+
+        for (int t = 0; t < numHeads; ++t)
+        {
+            const auto head = sharcReadPosition(ring.writeIndex, taps->getDelay(t, params.delay), mask);
+            headOffsets[t] = (ring.writeIndex - head.older) & mask;
+
+            float c[4];
+            sharcTapWeights(params.interpolation, head.fraction, c);
+
+            for (int m = firstTap; m <= lastTap; ++m)
+            {
+                const float pair[2] = { c[m + 1] * taps->gainLeft[t], c[m + 1] * taps->gainRight[t] };
+                headWeights[t][m + 1] = Ops::broadcastPair(pair);
+            }
+        }
+
+        // Pre-load constants into SIMD registers
+        const GainRamp<Ops> dryRamp(params.dry, params.dryStep);
+        const GainRamp<Ops> wetRamp(params.wet, params.wetStep);
+        const GainRamp<Ops> fbRamp(params.feedback, params.feedbackStep);
+        const GainRamp<Ops> crossRamp(params.cross, params.crossStep);
+        const Vec frameAdvance = Ops::broadcast(static_cast<float>(width));
+
+        Sample* const frames = ring.data<Sample>();
+        int i = 0;
+
+        // Head: per frame until the write head sits on a register boundary
+        while (i < numFrames
+               && (reinterpret_cast<uintptr_t>(frames + 2 * ring.writeIndex) & (registerBytes - 1)) != 0)
+        {
+            sharcProcessFrame<Sample>(ring, inputLeft[i], inputRight[i],
+                outputLeft[i], outputRight[i], params.at(i), params.interpolation, params.saturation);
+            ++i;
+        }
+
+        // Main loop: no edge splitting, the mask and guard handle the wrap
+        Vec frameLo = Ops::add(Ops::load(laneFrameOffsets), Ops::broadcast(static_cast<float>(i)));
+        Vec frameHi = Ops::add(Ops::load(laneFrameOffsets + width), Ops::broadcast(static_cast<float>(i)));
+
+        // soft2x: unsaturated writes of the previous register; only its
+        // last frame is ever read
+        alignas(64) float lastLanes[width] {};
+        Vec previousHi = Ops::broadcast(0.0f);
+
+        if constexpr (Saturation == SharcSaturation::soft2x)
+        {
+            lastLanes[width - 2] = ring.writeState[0].saturation;
+            lastLanes[width - 1] = ring.writeState[1].saturation;
+            previousHi = Ops::load(lastLanes);
+        }
+
+        FrameFilter<Ops, Filtered> filter(ring.filter, ring.writeState);
+
+        // Stereo routing (see SharcKernelParams): one pair swap each, L and
+        // R being neighbours in the register. Ping-pong keeps the sum in
+        // the left lanes only.
+        const bool crossed = (Mix & mixFeedback) != 0 && params.isCrossed();
+        const bool pingPong = params.pingPong;
+        const float pingPongPair[2] = { 0.5f, 0.0f };
+        const Vec pingPongWeights = Ops::broadcastPair(pingPongPair);
+
+        for (; i + width <= numFrames; i += width)
+        {
+            const int w = ring.writeIndex;
+            const Sample* readFrame = frames + 2 * ((w - readOffset + firstTap) & mask);
+
+            Vec dryLo = dryRamp.start, dryHi = dryRamp.start;
+            Vec wetLo = wetRamp.start, wetHi = wetRamp.start;
+            Vec fbLo = fbRamp.start, fbHi = fbRamp.start;
+            Vec crossLo = crossRamp.start, crossHi = crossRamp.start;
+
+            if constexpr (Ramped)
+            {
+                dryLo = dryRamp.at(frameLo); dryHi = dryRamp.at(frameHi);
+                wetLo = wetRamp.at(frameLo); wetHi = wetRamp.at(frameHi);
+                fbLo = fbRamp.at(frameLo);   fbHi = fbRamp.at(frameHi);
+                crossLo = crossRamp.at(frameLo); crossHi = crossRamp.at(frameHi);
+                frameLo = Ops::add(frameLo, frameAdvance);
+                frameHi = Ops::add(frameHi, frameAdvance);
+            }
+
+            Vec inLo, inHi;
+            Ops::interleave(Ops::loadu(inputLeft + i), Ops::loadu(inputRight + i), inLo, inHi);
+
+            // 1. Read delayed sample: fixed-weight FIR over contiguous taps
+            Vec delayedLo = inLo, delayedHi = inHi;
+
+            if constexpr (readsDelay)
+            {
+                delayedLo = Ops::mul(loadRing<Ops>(readFrame), tapWeights[firstTap + 1]);
+                delayedHi = Ops::mul(loadRing<Ops>(readFrame + width), tapWeights[firstTap + 1]);
+
+                for (int m = firstTap + 1; m <= lastTap; ++m)
+                {
+                    delayedLo = Ops::mulAdd(loadRing<Ops>(readFrame + 2 * (m - firstTap)), tapWeights[m + 1], delayedLo);
+                    delayedHi = Ops::mulAdd(loadRing<Ops>(readFrame + 2 * (m - firstTap) + width), tapWeights[m + 1], delayedHi);
+                }
+            }
+
+            // 1b. Tap heads, heard instead of the feedback head
+            Vec heardLo = delayedLo, heardHi = delayedHi;
+
+            if (numHeads > 0)
+            {
+                heardLo = heardHi = Ops::broadcast(0.0f);
+
+                for (int t = 0; t < numHeads; ++t)
+                {
+                    const Sample* headFrame = frames + 2 * ((w - headOffsets[t] + firstTap) & mask);
+
+                    for (int m = firstTap; m <= lastTap; ++m)
+                    {
+                        heardLo = Ops::mulAdd(loadRing<Ops>(headFrame + 2 * (m - firstTap)), headWeights[t][m + 1], heardLo);
+                        heardHi = Ops::mulAdd(loadRing<Ops>(headFrame + 2 * (m - firstTap) + width), headWeights[t][m + 1], heardHi);
+                    }
+                }
+            }
+
+            // 2. Mix and output
+            Vec outLeft, outRight;
+            Ops::deinterleave(mixOutput<Ops, Mix>(inLo, heardLo, dryLo, wetLo),
+                              mixOutput<Ops, Mix>(inHi, heardHi, dryHi, wetHi),
+                              outLeft, outRight);
+            Ops::storeu(outputLeft + i, outLeft);
+            Ops::storeu(outputRight + i, outRight);
+
+            // 2b. Stereo routing of what goes back into the ring
+            Vec sendLo = inLo, sendHi = inHi;
+            Vec fedLo = delayedLo, fedHi = delayedHi;
+
+            if (pingPong)
+            {
+                sendLo = Ops::mul(Ops::add(inLo, Ops::swapPairs(inLo)), pingPongWeights);
+                sendHi = Ops::mul(Ops::add(inHi, Ops::swapPairs(inHi)), pingPongWeights);
+            }
+
+            if (crossed)
+            {
+                fedLo = Ops::mulAdd(crossLo, Ops::sub(Ops::swapPairs(delayedLo), delayedLo), delayedLo);
+                fedHi = Ops::mulAdd(crossHi, Ops::sub(Ops::swapPairs(delayedHi), delayedHi), delayedHi);
+            }
+
+            // 3./4. Update delay line with STABLE FORMULA + damping + clip / saturation
+            Vec feedLo = feedbackInput<Ops, Mix>(sendLo, fedLo, fbLo);
+            Vec feedHi = feedbackInput<Ops, Mix>(sendHi, fedHi, fbHi);
+            filter.process(feedLo, feedHi);
+            Vec previousLo = previousHi;
+
+            if constexpr (Saturation == SharcSaturation::soft2x)
+            {
+                previousLo = Ops::previousFrames(previousHi, feedLo);
+                previousHi = Ops::previousFrames(feedLo, feedHi);
+            }
+
+            storeFrames<Ops, Sample>(ring, w, saturate<Ops, Saturation>(feedLo, previousLo));
+            storeFrames<Ops, Sample>(ring, (w + width / 2) & mask, saturate<Ops, Saturation>(feedHi, previousHi));
+
+            if constexpr (Saturation == SharcSaturation::soft2x)
+                previousHi = feedHi;
+
+            // 5. Circular buffer wraparound
+            ring.writeIndex = (w + width) & mask;
+        }
+
+        if constexpr (Saturation == SharcSaturation::soft2x)
+        {
+            Ops::store(lastLanes, previousHi);
+            ring.writeState[0].saturation = lastLanes[width - 2];
+            ring.writeState[1].saturation = lastLanes[width - 1];
+        }
+
+        filter.save();
+
+        // Tail: fewer than `width` frames left
+        for (; i < numFrames; ++i)
+            sharcProcessFrame<Sample>(ring, inputLeft[i], inputRight[i],
+                outputLeft[i], outputRight[i], params.at(i), params.interpolation, params.saturation);
+    }
+
+    // Finds the Mix variant for `mix` (mixAll down to 0), once per block
+    template <typename Ops, typename Sample, bool Ramped, int NumTaps, SharcSaturation Saturation, bool Filtered, int Mix = mixAll>
+    inline void processFramesWithMix(int mix, SharcRing& ring,
+        const float* inputLeft, const float* inputRight,
+        float* outputLeft, float* outputRight,
+        int numFrames, const SharcKernelParams& params) noexcept
+    {
+        if constexpr (Mix > 0)
+        {
+            if (mix != Mix)
+                return processFramesWithMix<Ops, Sample, Ramped, NumTaps, Saturation, Filtered, Mix - 1>(mix, ring, inputLeft, inputRight,
+                    outputLeft, outputRight, numFrames, params);
+        }
+
+        processFramesImpl<Ops, Sample, Ramped, NumTaps, Saturation, Filtered, Mix>(ring, inputLeft, inputRight, outputLeft, outputRight, numFrames, params);
+    }
+
+    template <typename Ops, typename Sample, bool Ramped, int NumTaps, bool Filtered>
+    inline void processFramesWithSaturation(SharcRing& ring,
+        const float* inputLeft, const float* inputRight,
+        float* outputLeft, float* outputRight,
+        int numFrames, const SharcKernelParams& params) noexcept
+    {
+        const int mix = getMixFlags(params);
+
+        switch (params.saturation)
+        {
+            case SharcSaturation::soft:
+                return processFramesWithMix<Ops, Sample, Ramped, NumTaps, SharcSaturation::soft, Filtered>(mix, ring,
+                    inputLeft, inputRight, outputLeft, outputRight, numFrames, params);
+
+            case SharcSaturation::soft2x:
+                return processFramesWithMix<Ops, Sample, Ramped, NumTaps, SharcSaturation::soft2x, Filtered>(mix, ring,
+                    inputLeft, inputRight, outputLeft, outputRight, numFrames, params);
+
+            case SharcSaturation::hard:
+            default:
+                return processFramesWithMix<Ops, Sample, Ramped, NumTaps, SharcSaturation::hard, Filtered>(mix, ring,
+                    inputLeft, inputRight, outputLeft, outputRight, numFrames, params);
+        }
+    }
+
+    template <typename Ops, typename Sample, bool Ramped, int NumTaps>
+    inline void processFramesWithFilter(SharcRing& ring,
+        const float* inputLeft, const float* inputRight,
+        float* outputLeft, float* outputRight,
+        int numFrames, const SharcKernelParams& params) noexcept
+    {
+        if (ring.filter != nullptr && ring.filter->active)
+            processFramesWithSaturation<Ops, Sample, Ramped, NumTaps, true>(ring, inputLeft, inputRight, outputLeft, outputRight, numFrames, params);
+        else
+            processFramesWithSaturation<Ops, Sample, Ramped, NumTaps, false>(ring, inputLeft, inputRight, outputLeft, outputRight, numFrames, params);
+    }
+
+    template <typename Ops, typename Sample, bool Ramped>
+    inline void processFramesWithTaps(SharcRing& ring,
+        const float* inputLeft, const float* inputRight,
+        float* outputLeft, float* outputRight,
+        int numFrames, const SharcKernelParams& params) noexcept
+    {
+        if (params.interpolation == SharcInterpolation::linear)
+            processFramesWithFilter<Ops, Sample, Ramped, 2>(ring, inputLeft, inputRight, outputLeft, outputRight, numFrames, params);
+        else
+            processFramesWithFilter<Ops, Sample, Ramped, 4>(ring, inputLeft, inputRight, outputLeft, outputRight, numFrames, params);
+    }
+
+    //==============================================================================
+    // A frozen ring (SharcFreezeLoop): the loop's frames straight to the mix,
+    // two loads and one multiply-add per register pair. Nothing is written,
+    // so there is no alignment head, and each run stops at the ring end,
+    // so no load relies on the guard copy.
+    template <typename Ops, typename Sample, bool Ramped>
+    inline void processFrozenFramesImpl(SharcRing& ring,
+        const float* inputLeft, const float* inputRight,
+        float* outputLeft, float* outputRight,
+        int numFrames, const SharcKernelParams& params) noexcept
+    {
+        using Vec = typename Ops::Vec;
+        constexpr int width = Ops::width;
+
+        const GainRamp<Ops> dryRamp(params.dry, params.dryStep);
+        const GainRamp<Ops> wetRamp(params.wet, params.wetStep);
+        const Vec lanesLo = Ops::load(laneFrameOffsets);
+        const Vec lanesHi = Ops::load(laneFrameOffsets + width);
+        const Sample* const frames = ring.data<Sample>();
+
+        sharcForEachFrozenRun(ring.freeze, ring.writeIndex, ring.length, ring.mask, numFrames,
+            [&](int position, int first, int count)
+            {
+                const Sample* loop = frames + 2 * position;
+                int j = 0;
+
+                for (; j + width <= count; j += width)
+                {
+                    const int i = first + j;
+                    Vec dryLo = dryRamp.start, dryHi = dryRamp.start;
+                    Vec wetLo = wetRamp.start, wetHi = wetRamp.start;
+
+                    if constexpr (Ramped)
+                    {
+                        const Vec frame = Ops::broadcast(static_cast<float>(i));
+                        const Vec frameLo = Ops::add(lanesLo, frame), frameHi = Ops::add(lanesHi, frame);
+                        dryLo = dryRamp.at(frameLo); dryHi = dryRamp.at(frameHi);
+                        wetLo = wetRamp.at(frameLo); wetHi = wetRamp.at(frameHi);
+                    }
+
+                    Vec inLo, inHi;
+                    Ops::interleave(Ops::loadu(inputLeft + i), Ops::loadu(inputRight + i), inLo, inHi);
+
+                    Vec outLeft, outRight;
+                    Ops::deinterleave(mixOutput<Ops, mixDry | mixWet>(inLo, loadRing<Ops>(loop + 2 * j), dryLo, wetLo),
+                                      mixOutput<Ops, mixDry | mixWet>(inHi, loadRing<Ops>(loop + 2 * j + width), dryHi, wetHi),
+                                      outLeft, outRight);
+                    Ops::storeu(outputLeft + i, outLeft);
+                    Ops::storeu(outputRight + i, outRight);
+                }
+
+                for (; j < count; ++j)
+                {
+                    const int i = first + j;
+                    const auto gains = params.at(i);
+                    const float input[2] = { inputLeft[i], inputRight[i] };
+                    float output[2];
+
+                    sharcFrozenStep<2>(loop + 2 * j, input, output, gains.dry, gains.wet);
+                    outputLeft[i] = output[0];
+                    outputRight[i] = output[1];
+                }
+            });
+
+        ring.freeze.advance(numFrames);
+    }
+
+    template <typename Ops, typename Sample>
+    inline void processFramesOf(SharcRing& ring,
+        const float* inputLeft, const float* inputRight,
+        float* outputLeft, float* outputRight,
+        int numFrames, const SharcKernelParams& params) noexcept
+    {
+        // Frozen: delay, taps, feedback and routing play no part
+        if (ring.freeze.isActive())
+        {
+            if (params.isRamping())
+                processFrozenFramesImpl<Ops, Sample, true>(ring, inputLeft, inputRight, outputLeft, outputRight, numFrames, params);
+            else
+                processFrozenFramesImpl<Ops, Sample, false>(ring, inputLeft, inputRight, outputLeft, outputRight, numFrames, params);
+            return;
+        }
+
+        // Gliding delay / allpass: per-frame positions, no shared fraction
+        if (params.isDelayMoving() || params.interpolation == SharcInterpolation::allpass)
+        {
+            for (int i = 0; i < numFrames; ++i)
+                sharcProcessFrame<Sample>(ring, inputLeft[i], inputRight[i],
+                    outputLeft[i], outputRight[i], params.at(i), params.interpolation, params.saturation);
+            return;
+        }
+
+        // Constant gains (the steady state) skip the per-lane ramp entirely
+        if (params.isRamping())
+            processFramesWithTaps<Ops, Sample, true>(ring, inputLeft, inputRight, outputLeft, outputRight, numFrames, params);
+        else
+            processFramesWithTaps<Ops, Sample, false>(ring, inputLeft, inputRight, outputLeft, outputRight, numFrames, params);
+
+        // Streamed stores are weakly ordered, and a host may run the next
+        // block on another thread after only a plain release store
+        if (std::is_same_v<Sample, float> && ring.streamWrites)
+            Ops::fence();
+    }
+
+    template <typename Ops>
+    inline void processFrames(SharcRing& ring,
+        const float* inputLeft, const float* inputRight,
+        float* outputLeft, float* outputRight,
+        int numFrames, const SharcKernelParams& params) noexcept
+    {
+        if (ring.format == SharcRingFormat::int16)
+            processFramesOf<Ops, int16_t>(ring, inputLeft, inputRight, outputLeft, outputRight, numFrames, params);
+        else
+            processFramesOf<Ops, float>(ring, inputLeft, inputRight, outputLeft, outputRight, numFrames, params);
+    }
+
+    //==============================================================================
+    // One mono bank row. Same structure as processFramesImpl, but a register
+    // is `width` samples of one channel, so an aligned write never straddles
+    // the (power-of-two) ring end.
+    template <typename Ops, typename Sample, bool Ramped, int NumTaps, SharcSaturation Saturation, bool Filtered, int Mix>
+    inline void processRowImpl(Sample* row, int length, int mask, int writeIndex,
+        const float* input, float* output,
+        int numFrames, const SharcKernelParams& params, float& allpassState, const SharcFeedbackFilter* filter, SharcWriteState& writeState) noexcept
+    {
+        using Vec = typename Ops::Vec;
+        constexpr int width = Ops::width;
+        constexpr uintptr_t registerBytes = sizeof(Sample) * width;
+        static_assert(width <= 16, "laneSampleOffsets is too short for this ISA");
+        constexpr bool readsDelay = (Mix & (mixWet | mixFeedback)) != 0;
+
+        const auto start = sharcReadPosition(writeIndex, params.delay, mask);
+        const int readOffset = (writeIndex - start.older) & mask;
+
+        float weights[4];
+        sharcTapWeights(params.interpolation, start.fraction, weights);
+
+        constexpr int firstTap = NumTaps == 4 ? -1 : 0;
+        constexpr int lastTap = NumTaps == 4 ? 2 : 1;
+        static_assert(width + lastTap - firstTap <= SharcRing::guardFrames, "Tap window overruns the guard region");
+
+        Vec tapWeights[4];
+        for (int m = firstTap; m <= lastTap; ++m)
+            tapWeights[m + 1] = Ops::broadcast(weights[m + 1]);
+
+        // Tap heads (mono: gain only)
+        const SharcTapTable* taps = (Mix & mixWet) != 0 ? params.taps : nullptr;
+        const int numHeads = taps != nullptr ? taps->numTaps : 0;
+        int headOffsets[SharcTapTable::maxTaps];
+        Vec headWeights[SharcTapTable::maxTaps][4];
+
+        for (int t = 0; t < numHeads; ++t)
+        {
+            const auto head = sharcReadPosition(writeIndex, taps->getDelay(t, params.delay), mask);
+            headOffsets[t] = (writeIndex - head.older) & mask;
+
+            float c[4];
+            sharcTapWeights(params.interpolation, head.fraction, c);
+
+            for (int m = firstTap; m <= lastTap; ++m)
+                headWeights[t][m + 1] = Ops::broadcast(c[m + 1] * taps->gain[t]);
+        }
+
+        const GainRamp<Ops> dryRamp(params.dry, params.dryStep);
+        const GainRamp<Ops> wetRamp(params.wet, params.wetStep);
+        const GainRamp<Ops> fbRamp(params.feedback, params.feedbackStep);
+        const Vec frameAdvance = Ops::broadcast(static_cast<float>(width));
+
+        int i = 0;
+        int w = writeIndex;
+
+        auto processSample = [&]() noexcept
+        {
+            sharcProcessStep<1>(row, length, mask, w, input + i, output + i,
+                params.at(i), params.interpolation, &allpassState, params.saturation, filter, &writeState);
+            w = (w + 1) & mask;
+            ++i;
+        };
+
+        // Head: per sample until the write head sits on a register boundary
+        while (i < numFrames && (reinterpret_cast<uintptr_t>(row + w) & (registerBytes - 1)) != 0)
+            processSample();
+
+        Vec frame = Ops::add(Ops::load(laneSampleOffsets), Ops::broadcast(static_cast<float>(i)));
+
+        // soft2x: unsaturated writes of the previous register
+        alignas(64) float lastLanes[width] {};
+        Vec previous = Ops::broadcast(0.0f);
+
+        if constexpr (Saturation == SharcSaturation::soft2x)
+        {
+            lastLanes[width - 1] = writeState.saturation;
+            previous = Ops::load(lastLanes);
+        }
+
+        RowFilter<Ops, Filtered> rowFilter(filter, writeState);
+
+        for (; i + width <= numFrames; i += width)
+        {
+            const Sample* readSample = row + ((w - readOffset + firstTap) & mask);
+
+            Vec dry = dryRamp.start, wet = wetRamp.start, fb = fbRamp.start;
+
+            if constexpr (Ramped)
+            {
+                dry = dryRamp.at(frame);
+                wet = wetRamp.at(frame);
+                fb = fbRamp.at(frame);
+                frame = Ops::add(frame, frameAdvance);
+            }
+
+            const Vec in = Ops::loadu(input + i);
+
+            // 1. Read delayed sample: fixed-weight FIR over contiguous taps
+            Vec delayed = in;
+
+            if constexpr (readsDelay)
+            {
+                delayed = Ops::mul(loadRing<Ops>(readSample), tapWeights[firstTap + 1]);
+
+                for (int m = firstTap + 1; m <= lastTap; ++m)
+                    delayed = Ops::mulAdd(loadRing<Ops>(readSample + (m - firstTap)), tapWeights[m + 1], delayed);
+            }
+
+            // 1b. Tap heads, heard instead of the feedback head
+            Vec heard = delayed;
+
+            if (numHeads > 0)
+            {
+                heard = Ops::broadcast(0.0f);
+
+                for (int t = 0; t < numHeads; ++t)
+                {
+                    const Sample* headSample = row + ((w - headOffsets[t] + firstTap) & mask);
+
+                    for (int m = firstTap; m <= lastTap; ++m)
+                        heard = Ops::mulAdd(loadRing<Ops>(headSample + (m - firstTap)), headWeights[t][m + 1], heard);
+                }
+            }
+
+            // 2. Mix and output
+            Ops::storeu(output + i, mixOutput<Ops, Mix>(in, heard, dry, wet));
+
+            // 3./4. Update delay line with STABLE FORMULA + damping + clip / saturation
+            Vec feed = feedbackInput<Ops, Mix>(in, delayed, fb);
+            rowFilter.process(feed);
+            const Vec written = saturate<Ops, Saturation>(feed, Ops::previousSamples(previous, feed));
+            storeRing<Ops>(row + w, written);
+
+            if constexpr (Saturation == SharcSaturation::soft2x)
+                previous = feed;
+
+            if (w < SharcRing::guardFrames)
+                storeRing<Ops>(row + w + length, written);
+
+            // 5. Circular buffer wraparound
+            w = (w + width) & mask;
+        }
+
+        if constexpr (Saturation == SharcSaturation::soft2x)
+        {
+            Ops::store(lastLanes, previous);
+            writeState.saturation = lastLanes[width - 1];
+        }
+
+        rowFilter.save();
+
+        while (i < numFrames)
+            processSample();
+    }
+
+    template <typename Ops, typename Sample, bool Ramped, int NumTaps, SharcSaturation Saturation, bool Filtered, int Mix = mixAll>
+    inline void processRowWithMix(int mix, Sample* row, int length, int mask, int writeIndex,
+        const float* input, float* output,
+        int numFrames, const SharcKernelParams& params, float& allpassState, const SharcFeedbackFilter* filter, SharcWriteState& writeState) noexcept
+    {
+        if constexpr (Mix > 0)
+        {
+            if (mix != Mix)
+                return processRowWithMix<Ops, Sample, Ramped, NumTaps, Saturation, Filtered, Mix - 1>(mix, row, length, mask, writeIndex,
+                    input, output, numFrames, params, allpassState, filter, writeState);
+        }
+
+        processRowImpl<Ops, Sample, Ramped, NumTaps, Saturation, Filtered, Mix>(row, length, mask, writeIndex, input, output,
+            numFrames, params, allpassState, filter, writeState);
+    }
+
+    template <typename Ops, typename Sample, bool Ramped, int NumTaps, bool Filtered>
+    inline void processRowWithSaturation(Sample* row, int length, int mask, int writeIndex,
+        const float* input, float* output,
+        int numFrames, const SharcKernelParams& params, float& allpassState, const SharcFeedbackFilter* filter, SharcWriteState& writeState) noexcept
+    {
+        const int mix = getMixFlags(params);
+
+        switch (params.saturation)
+        {
+            case SharcSaturation::soft:
+                return processRowWithMix<Ops, Sample, Ramped, NumTaps, SharcSaturation::soft, Filtered>(mix, row, length, mask, writeIndex,
+                    input, output, numFrames, params, allpassState, filter, writeState);
+
+            case SharcSaturation::soft2x:
+                return processRowWithMix<Ops, Sample, Ramped, NumTaps, SharcSaturation::soft2x, Filtered>(mix, row, length, mask, writeIndex,
+                    input, output, numFrames, params, allpassState, filter, writeState);
+
+            case SharcSaturation::hard:
+            default:
+                return processRowWithMix<Ops, Sample, Ramped, NumTaps, SharcSaturation::hard, Filtered>(mix, row, length, mask, writeIndex,
+                    input, output, numFrames, params, allpassState, filter, writeState);
+        }
+    }
+
+    template <typename Ops, typename Sample, bool Ramped, int NumTaps>
+    inline void processRowWithFilter(Sample* row, int length, int mask, int writeIndex,
+        const float* input, float* output,
+        int numFrames, const SharcKernelParams& params, float& allpassState, const SharcFeedbackFilter* filter, SharcWriteState& writeState) noexcept
+    {
+        if (filter != nullptr && filter->active)
+            processRowWithSaturation<Ops, Sample, Ramped, NumTaps, true>(row, length, mask, writeIndex, input, output,
+                numFrames, params, allpassState, filter, writeState);
+        else
+            processRowWithSaturation<Ops, Sample, Ramped, NumTaps, false>(row, length, mask, writeIndex, input, output,
+                numFrames, params, allpassState, filter, writeState);
+    }
+
+    template <typename Ops, typename Sample>
+    inline void processRow(Sample* row, int length, int mask, int writeIndex,
+        const float* input, float* output,
+        int numFrames, const SharcKernelParams& params, float& allpassState, const SharcFeedbackFilter* filter, SharcWriteState& writeState) noexcept
+    {
+        if (params.isDelayMoving() || params.interpolation == SharcInterpolation::allpass)
+        {
+            for (int i = 0; i < numFrames; ++i)
+            {
+                sharcProcessStep<1>(row, length, mask, writeIndex, input + i, output + i,
+                    params.at(i), params.interpolation, &allpassState, params.saturation, filter, &writeState);
+                writeIndex = (writeIndex + 1) & mask;
+            }
+            return;
+        }
+
+        const bool linear = params.interpolation == SharcInterpolation::linear;
+
+        if (params.isRamping())
+        {
+            if (linear) processRowWithFilter<Ops, Sample, true, 2>(row, length, mask, writeIndex, input, output, numFrames, params, allpassState, filter, writeState);
+            else        processRowWithFilter<Ops, Sample, true, 4>(row, length, mask, writeIndex, input, output, numFrames, params, allpassState, filter, writeState);
+        }
+        else
+        {
+            if (linear) processRowWithFilter<Ops, Sample, false, 2>(row, length, mask, writeIndex, input, output, numFrames, params, allpassState, filter, writeState);
+            else        processRowWithFilter<Ops, Sample, false, 4>(row, length, mask, writeIndex, input, output, numFrames, params, allpassState, filter, writeState);
+        }
+    }
+
+    // One row of a frozen bank, as processFrozenFramesImpl
+    template <typename Ops, typename Sample, bool Ramped>
+    inline void processFrozenRowImpl(const Sample* row, SharcFreezeLoop loop, int length, int mask, int writeIndex,
+        const float* input, float* output, int numFrames, const SharcKernelParams& params) noexcept
+    {
+        using Vec = typename Ops::Vec;
+        constexpr int width = Ops::width;
+
+        const GainRamp<Ops> dryRamp(params.dry, params.dryStep);
+        const GainRamp<Ops> wetRamp(params.wet, params.wetStep);
+        const Vec lanes = Ops::load(laneSampleOffsets);
+
+        sharcForEachFrozenRun(loop, writeIndex, length, mask, numFrames, [&](int position, int first, int count)
+        {
+            const Sample* samples = row + position;
+            int j = 0;
+
+            for (; j + width <= count; j += width)
+            {
+                const int i = first + j;
+                Vec dry = dryRamp.start, wet = wetRamp.start;
+
+                if constexpr (Ramped)
+                {
+                    const Vec frame = Ops::add(lanes, Ops::broadcast(static_cast<float>(i)));
+                    dry = dryRamp.at(frame);
+                    wet = wetRamp.at(frame);
+                }
+
+                Ops::storeu(output + i, mixOutput<Ops, mixDry | mixWet>(Ops::loadu(input + i), loadRing<Ops>(samples + j), dry, wet));
+            }
+
+            for (; j < count; ++j)
+            {
+                const int i = first + j;
+                const auto gains = params.at(i);
+                sharcFrozenStep<1>(samples + j, input + i, output + i, gains.dry, gains.wet);
+            }
+        });
+    }
+
+    template <typename Ops, typename Sample>
+    inline void processFrozenRow(const Sample* row, SharcFreezeLoop loop, int length, int mask, int writeIndex,
+        const float* input, float* output, int numFrames, const SharcKernelParams& params) noexcept
+    {
+        if (params.isRamping())
+            processFrozenRowImpl<Ops, Sample, true>(row, loop, length, mask, writeIndex, input, output, numFrames, params);
+        else
+            processFrozenRowImpl<Ops, Sample, false>(row, loop, length, mask, writeIndex, input, output, numFrames, params);
+    }
+
+    // Every channel in one call, row by row (rows and host buffers are
+    // both planar, so each row streams contiguously)
+    template <typename Ops>
+    inline void processBank(SharcBankRing& ring,
+        const float* const* inputs, float* const* outputs,
+        int numFrames, const SharcKernelParams* channelParams) noexcept
+    {
+        if (ring.freeze.isActive())
+        {
+            for (int ch = 0; ch < ring.numChannels; ++ch)
+            {
+                if (ring.format == SharcRingFormat::int16)
+                    processFrozenRow<Ops>(ring.row<int16_t>(ch), ring.freeze, ring.length, ring.mask, ring.writeIndex,
+                        inputs[ch], outputs[ch], numFrames, channelParams[ch]);
+                else
+                    processFrozenRow<Ops>(ring.row<float>(ch), ring.freeze, ring.length, ring.mask, ring.writeIndex,
+                        inputs[ch], outputs[ch], numFrames, channelParams[ch]);
+            }
+
+            ring.freeze.advance(numFrames);
+            return;
+        }
+
+        for (int ch = 0; ch < ring.numChannels; ++ch)
+        {
+            if (ring.format == SharcRingFormat::int16)
+                processRow<Ops>(ring.row<int16_t>(ch), ring.length, ring.mask, ring.writeIndex,
+                    inputs[ch], outputs[ch], numFrames, channelParams[ch], ring.allpassState[ch], ring.filter, ring.writeState[ch]);
+            else
+                processRow<Ops>(ring.row<float>(ch), ring.length, ring.mask, ring.writeIndex,
+                    inputs[ch], outputs[ch], numFrames, channelParams[ch], ring.allpassState[ch], ring.filter, ring.writeState[ch]);
+        }
+
+        ring.writeIndex = (ring.writeIndex + numFrames) & ring.mask;
+    }
+}
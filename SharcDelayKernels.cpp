@@ -0,0 +1,383 @@
+/*
+  SHARC Echo/Delay Effect Plugin - Kernel Registry Implementation
+  JUCE 8.0.11
+*/
+
+#include <JuceHeader.h>
+#include "SharcDelayKernels.h"
+
+//==============================================================================
+// Scalar reference. Each interpolation / saturation pair gets its own loop,
+// so the per-sample switches fold away. The in-place and out-of-place
+// entry points differ only in their restrict-qualified pointers: host
+// buffers, ring and carried state never overlap, so the compiler can keep
+// the state in registers instead of reloading it after every store. In
+// place, input and output are the same restrict pointer.
+//
+// The loops are flattened: left to itself the compiler calls
+// sharcProcessStep once per sample, with the modes as runtime arguments.
+// The ring's sample type (float or int16, see SharcRingFormat) is
+// deduced from the ring pointer, so each format gets its own loops too.
+#if defined(__GNUC__) || defined(__clang__)
+ #define SHARC_SCALAR_FLATTEN __attribute__((flatten))
+#else
+ #define SHARC_SCALAR_FLATTEN
+#endif
+
+namespace
+{
+    template <int Channels, SharcInterpolation Mode, SharcSaturation Saturation, typename Sample>
+    SHARC_KERNEL_INLINE void scalarSteps(Sample* frames, int length, int mask, int writeIndex,
+        const float* const* inputs, float* const* outputs, int numFrames,
+        const SharcKernelParams& params, float* allpassState,
+        const SharcFeedbackFilter* filter, SharcWriteState* writeState) noexcept
+    {
+        int w = writeIndex;
+
+        for (int i = 0; i < numFrames; ++i)
+        {
+            float input[Channels], output[Channels];
+
+            for (int ch = 0; ch < Channels; ++ch)
+                input[ch] = inputs[ch][i];
+
+            sharcProcessStep<Channels>(frames, length, mask, w, input, output, params.at(i),
+                Mode, allpassState, Saturation, filter, writeState);
+
+            for (int ch = 0; ch < Channels; ++ch)
+                outputs[ch][i] = output[ch];
+
+            w = (w + 1) & mask;
+        }
+    }
+
+    // A frozen ring (SharcFreezeLoop): the loop's frames straight to the mix
+    template <int Channels, typename Sample>
+    void scalarFrozenSteps(const Sample* frames, SharcFreezeLoop loop, int length, int mask, int writeIndex,
+        const float* const* inputs, float* const* outputs, int numFrames, const SharcKernelParams& params) noexcept
+    {
+        sharcForEachFrozenRun(loop, writeIndex, length, mask, numFrames, [&](int position, int first, int count)
+        {
+            for (int i = first; i < first + count; ++i)
+            {
+                float input[Channels], output[Channels];
+
+                for (int ch = 0; ch < Channels; ++ch)
+                    input[ch] = inputs[ch][i];
+
+                const auto gains = params.at(i);
+                sharcFrozenStep<Channels>(frames + Channels * (position + i - first), input, output, gains.dry, gains.wet);
+
+                for (int ch = 0; ch < Channels; ++ch)
+                    outputs[ch][i] = output[ch];
+            }
+        });
+    }
+
+    template <SharcInterpolation Mode, SharcSaturation Saturation, typename Sample>
+    SHARC_SCALAR_FLATTEN void scalarFrames(Sample* SHARC_RESTRICT frames, int length, int mask, int writeIndex,
+        const float* SHARC_RESTRICT inputLeft, const float* SHARC_RESTRICT inputRight,
+        float* SHARC_RESTRICT outputLeft, float* SHARC_RESTRICT outputRight, int numFrames,
+        const SharcKernelParams& params, float* SHARC_RESTRICT allpassState,
+        const SharcFeedbackFilter* filter, SharcWriteState* SHARC_RESTRICT writeState) noexcept
+    {
+        const float* inputs[] = { inputLeft, inputRight };
+        float* outputs[] = { outputLeft, outputRight };
+        scalarSteps<2, Mode, Saturation>(frames, length, mask, writeIndex, inputs, outputs, numFrames,
+            params, allpassState, filter, writeState);
+    }
+
+    template <SharcInterpolation Mode, SharcSaturation Saturation, typename Sample>
+    SHARC_SCALAR_FLATTEN void scalarFramesInPlace(Sample* SHARC_RESTRICT frames, int length, int mask, int writeIndex,
+        float* SHARC_RESTRICT left, float* SHARC_RESTRICT right, int numFrames,
+        const SharcKernelParams& params, float* SHARC_RESTRICT allpassState,
+        const SharcFeedbackFilter* filter, SharcWriteState* SHARC_RESTRICT writeState) noexcept
+    {
+        const float* inputs[] = { left, right };
+        float* outputs[] = { left, right };
+        scalarSteps<2, Mode, Saturation>(frames, length, mask, writeIndex, inputs, outputs, numFrames,
+            params, allpassState, filter, writeState);
+    }
+
+    template <SharcInterpolation Mode, SharcSaturation Saturation, typename Sample>
+    SHARC_SCALAR_FLATTEN void scalarRow(Sample* SHARC_RESTRICT row, int length, int mask, int writeIndex,
+        const float* SHARC_RESTRICT input, float* SHARC_RESTRICT output, int numFrames,
+        const SharcKernelParams& params, float* SHARC_RESTRICT allpassState,
+        const SharcFeedbackFilter* filter, SharcWriteState* SHARC_RESTRICT writeState) noexcept
+    {
+        const float* inputs[] = { input };
+        float* outputs[] = { output };
+        scalarSteps<1, Mode, Saturation>(row, length, mask, writeIndex, inputs, outputs, numFrames,
+            params, allpassState, filter, writeState);
+    }
+
+    template <SharcInterpolation Mode, SharcSaturation Saturation, typename Sample>
+    SHARC_SCALAR_FLATTEN void scalarRowInPlace(Sample* SHARC_RESTRICT row, int length, int mask, int writeIndex,
+        float* SHARC_RESTRICT samples, int numFrames,
+        const SharcKernelParams& params, float* SHARC_RESTRICT allpassState,
+        const SharcFeedbackFilter* filter, SharcWriteState* SHARC_RESTRICT writeState) noexcept
+    {
+        const float* inputs[] = { samples };
+        float* outputs[] = { samples };
+        scalarSteps<1, Mode, Saturation>(row, length, mask, writeIndex, inputs, outputs, numFrames,
+            params, allpassState, filter, writeState);
+    }
+
+    // Compile-time interpolation / saturation for fn(mode, saturation)
+    template <SharcInterpolation Mode, typename Fn>
+    void withSaturation(SharcSaturation saturation, Fn&& fn)
+    {
+        using Interp = std::integral_constant<SharcInterpolation, Mode>;
+
+        switch (saturation)
+        {
+            case SharcSaturation::soft:     return fn(Interp(), std::integral_constant<SharcSaturation, SharcSaturation::soft>());
+            case SharcSaturation::soft2x:   return fn(Interp(), std::integral_constant<SharcSaturation, SharcSaturation::soft2x>());
+            case SharcSaturation::hard:
+            default:                        return fn(Interp(), std::integral_constant<SharcSaturation, SharcSaturation::hard>());
+        }
+    }
+
+    template <typename Fn>
+    void withModes(const SharcKernelParams& params, Fn&& fn)
+    {
+        switch (params.interpolation)
+        {
+            case SharcInterpolation::linear:    return withSaturation<SharcInterpolation::linear>(params.saturation, fn);
+            case SharcInterpolation::lagrange:  return withSaturation<SharcInterpolation::lagrange>(params.saturation, fn);
+            case SharcInterpolation::allpass:   return withSaturation<SharcInterpolation::allpass>(params.saturation, fn);
+            case SharcInterpolation::hermite:
+            default:                            return withSaturation<SharcInterpolation::hermite>(params.saturation, fn);
+        }
+    }
+}
+
+void SharcDelayKernels::detail::processScalar(SharcRing& ring,
+    const float* inputLeft, const float* inputRight,
+    float* outputLeft, float* outputRight,
+    int numFrames, const SharcKernelParams& params) noexcept
+{
+    if (ring.freeze.isActive())
+    {
+        const float* inputs[] = { inputLeft, inputRight };
+        float* outputs[] = { outputLeft, outputRight };
+
+        if (ring.format == SharcRingFormat::int16)
+            scalarFrozenSteps<2>(ring.compact, ring.freeze, ring.length, ring.mask, ring.writeIndex, inputs, outputs, numFrames, params);
+        else
+            scalarFrozenSteps<2>(ring.frames, ring.freeze, ring.length, ring.mask, ring.writeIndex, inputs, outputs, numFrames, params);
+
+        ring.freeze.advance(numFrames);
+        return;
+    }
+
+    const bool inPlace = inputLeft == outputLeft && inputRight == outputRight;
+
+    auto process = [&](auto* frames)
+    {
+        withModes(params, [&](auto mode, auto saturation)
+        {
+            if (inPlace)
+                scalarFramesInPlace<mode, saturation>(frames, ring.length, ring.mask, ring.writeIndex,
+                    outputLeft, outputRight, numFrames, params, ring.allpassState, ring.filter, ring.writeState);
+            else
+                scalarFrames<mode, saturation>(frames, ring.length, ring.mask, ring.writeIndex,
+                    inputLeft, inputRight, outputLeft, outputRight, numFrames, params, ring.allpassState, ring.filter, ring.writeState);
+        });
+    };
+
+    if (ring.format == SharcRingFormat::int16)
+        process(ring.compact);
+    else
+        process(ring.frames);
+
+    ring.writeIndex = (ring.writeIndex + numFrames) & ring.mask;
+}
+
+void SharcDelayKernels::detail::processBankScalar(SharcBankRing& ring,
+    const float* const* inputs, float* const* outputs,
+    int numFrames, const SharcKernelParams* channelParams) noexcept
+{
+    if (ring.freeze.isActive())
+    {
+        for (int ch = 0; ch < ring.numChannels; ++ch)
+        {
+            if (ring.format == SharcRingFormat::int16)
+                scalarFrozenSteps<1>(ring.row<int16_t>(ch), ring.freeze, ring.length, ring.mask, ring.writeIndex,
+                    inputs + ch, outputs + ch, numFrames, channelParams[ch]);
+            else
+                scalarFrozenSteps<1>(ring.row<float>(ch), ring.freeze, ring.length, ring.mask, ring.writeIndex,
+                    inputs + ch, outputs + ch, numFrames, channelParams[ch]);
+        }
+
+        ring.freeze.advance(numFrames);
+        return;
+    }
+
+    for (int ch = 0; ch < ring.numChannels; ++ch)
+    {
+        const auto& params = channelParams[ch];
+
+        auto process = [&](auto* row)
+        {
+            withModes(params, [&](auto mode, auto saturation)
+            {
+                if (inputs[ch] == outputs[ch])
+                    scalarRowInPlace<mode, saturation>(row, ring.length, ring.mask, ring.writeIndex,
+                        outputs[ch], numFrames, params, ring.allpassState + ch, ring.filter, ring.writeState + ch);
+                else
+                    scalarRow<mode, saturation>(row, ring.length, ring.mask, ring.writeIndex,
+                        inputs[ch], outputs[ch], numFrames, params, ring.allpassState + ch, ring.filter, ring.writeState + ch);
+            });
+        };
+
+        if (ring.format == SharcRingFormat::int16)
+            process(ring.row<int16_t>(ch));
+        else
+            process(ring.row<float>(ch));
+    }
+
+    ring.writeIndex = (ring.writeIndex + numFrames) & ring.mask;
+}
+
+//==============================================================================
+namespace
+{
+    // CPUID is queried once, the first time anything asks
+    struct CpuFeatures
+    {
+        bool sse2 = false;
+        bool avx2 = false;
+        bool avx512 = false;
+        bool neon = false;
+
+        CpuFeatures()
+        {
+           #if SHARC_KERNELS_X86
+            sse2 = juce::SystemStats::hasSSE2();
+            avx2 = sse2 && juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3();
+            avx512 = avx2 && juce::SystemStats::hasAVX512F();
+           #endif
+
+           #if SHARC_KERNELS_NEON
+            neon = true;
+           #endif
+        }
+    };
+
+    const CpuFeatures& getCpuFeatures() noexcept
+    {
+        static const CpuFeatures features;
+        return features;
+    }
+}
+
+//==============================================================================
+bool SharcDelayKernels::isSupported(SharcKernelIsa isa) noexcept
+{
+    const auto& cpu = getCpuFeatures();
+
+    switch (isa)
+    {
+        case SharcKernelIsa::automatic:
+        case SharcKernelIsa::scalar:    return true;
+        case SharcKernelIsa::sse2:      return cpu.sse2;
+        case SharcKernelIsa::avx2:      return cpu.avx2;
+        case SharcKernelIsa::avx512:    return cpu.avx512;
+        case SharcKernelIsa::neon:      return cpu.neon;
+    }
+
+    return false;
+}
+
+SharcKernelIsa SharcDelayKernels::getBestAvailable() noexcept
+{
+    for (auto isa : { SharcKernelIsa::avx512, SharcKernelIsa::avx2, SharcKernelIsa::neon, SharcKernelIsa::sse2 })
+        if (isSupported(isa))
+            return isa;
+
+    return SharcKernelIsa::scalar;
+}
+
+SharcKernelIsa SharcDelayKernels::resolve(SharcKernelIsa requested) noexcept
+{
+    if (requested == SharcKernelIsa::automatic)
+        return getBestAvailable();
+
+    auto isa = requested;
+
+    while (!isSupported(isa))
+    {
+        switch (isa)
+        {
+            case SharcKernelIsa::avx512:    isa = SharcKernelIsa::avx2; break;
+            case SharcKernelIsa::avx2:      isa = SharcKernelIsa::sse2; break;
+            default:                        return SharcKernelIsa::scalar;
+        }
+    }
+
+    return isa;
+}
+
+SharcKernelFn SharcDelayKernels::getKernel(SharcKernelIsa isa) noexcept
+{
+    if (!isSupported(isa))
+        return detail::processScalar;
+
+    switch (isa)
+    {
+       #if SHARC_KERNELS_X86
+        case SharcKernelIsa::sse2:      return detail::processSSE2;
+        case SharcKernelIsa::avx2:      return detail::processAVX2;
+        case SharcKernelIsa::avx512:    return detail::processAVX512;
+       #endif
+
+       #if SHARC_KERNELS_NEON
+        case SharcKernelIsa::neon:      return detail::processNEON;
+       #endif
+
+        case SharcKernelIsa::automatic: return getKernel(getBestAvailable());
+        default:                        break;
+    }
+
+    return detail::processScalar;
+}
+
+SharcBankKernelFn SharcDelayKernels::getBankKernel(SharcKernelIsa isa) noexcept
+{
+    if (!isSupported(isa))
+        return detail::processBankScalar;
+
+    switch (isa)
+    {
+       #if SHARC_KERNELS_X86
+        case SharcKernelIsa::sse2:      return detail::processBankSSE2;
+        case SharcKernelIsa::avx2:      return detail::processBankAVX2;
+        case SharcKernelIsa::avx512:    return detail::processBankAVX512;
+       #endif
+
+       #if SHARC_KERNELS_NEON
+        case SharcKernelIsa::neon:      return detail::processBankNEON;
+       #endif
+
+        case SharcKernelIsa::automatic: return getBankKernel(getBestAvailable());
+        default:                        break;
+    }
+
+    return detail::processBankScalar;
+}
+
+const char* SharcDelayKernels::getName(SharcKernelIsa isa) noexcept
+{
+    switch (isa)
+    {
+        case SharcKernelIsa::automatic: return "Auto";
+        case SharcKernelIsa::scalar:    return "Scalar";
+        case SharcKernelIsa::sse2:      return "SSE2";
+        case SharcKernelIsa::avx2:      return "AVX2";
+        case SharcKernelIsa::avx512:    return "AVX-512";
+        case SharcKernelIsa::neon:      return "NEON";
+    }
+
+    return "Unknown";
+}
@@ -0,0 +1,899 @@
+/*
+  SHARC Echo/Delay Effect Plugin - Kernel Registry
+  JUCE 8.0.11 - Runtime CPU dispatch for the feedback/mix loop
+
+  Each ISA variant lives in its own translation unit
+  (SharcDelayKernels_SSE2.cpp, _AVX2.cpp, _AVX512.cpp, _NEON.cpp) and is
+  compiled for that instruction set with a target pragma, so the shipped
+  binary stays portable. The variant is resolved once from CPUID / the
+  platform and handed to SharcDelayLine as a plain function pointer.
+
+  This header is deliberately JUCE-free: it is included by the ISA units
+  before their target pragmas, and nothing in it may be compiled for a
+  wider instruction set than the host baseline.
+*/
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(_MSC_VER)
+ #include <intrin.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+ #define SHARC_KERNELS_X86 1
+#else
+ #define SHARC_KERNELS_X86 0
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+ #define SHARC_KERNELS_NEON 1
+#else
+ #define SHARC_KERNELS_NEON 0
+#endif
+
+// For helpers the compilers otherwise leave out of line in the large
+// kernel instantiations
+#if defined(_MSC_VER)
+ #define SHARC_KERNEL_INLINE __forceinline
+#else
+ #define SHARC_KERNEL_INLINE inline __attribute__((always_inline))
+#endif
+
+// No-overlap promise on kernel pointers (see SharcKernelFn)
+#define SHARC_RESTRICT __restrict
+
+//==============================================================================
+// Values match the choice indices of the "mode" parameter
+enum class SharcKernelIsa
+{
+    automatic = 0,
+    scalar,
+    sse2,
+    avx2,
+    avx512,
+    neon
+};
+
+// Values match the choice indices of the "interp" parameter
+enum class SharcInterpolation
+{
+    linear = 0,
+    hermite,    // 4-point, 3rd-order Hermite (Catmull-Rom)
+    lagrange,   // 4-point, 3rd-order Lagrange
+    allpass     // 1st-order Thiran allpass (recursive, per frame)
+};
+
+// Values match the choice indices of the "sat" parameter. Every mode keeps
+// ring writes inside +-1.
+enum class SharcSaturation
+{
+    hard = 0,   // clamp to +-1 (the original safety clip)
+    soft,       // rational tanh approximation, saturates at |x| = 3
+    soft2x      // soft, evaluated at 2x on the feedback path (see sharcSaturate)
+};
+
+// Values match the choice indices of the "memory" parameter: how ring
+// history is stored (see sharcRingValue / sharcRingSample)
+enum class SharcRingFormat
+{
+    float32 = 0,
+    int16       // 16-bit fixed point, half the memory and bandwidth
+};
+
+struct SharcTapTable;
+
+struct SharcFrameParams
+{
+    float feedback;
+    float wet;
+    float dry;
+    double delay;
+    const SharcTapTable* taps;  // extra read heads, or null (see SharcTapTable)
+    float cross;                // stereo feedback matrix, see SharcKernelParams
+    bool pingPong;
+};
+
+// Values at the first frame plus a per-frame increment. A linear ramp keeps
+// every kernel branch-free and vectorisable: lane k of a register simply
+// sees start + step * k. Delay is in (fractional) samples.
+//
+// Stereo rings (Channels == 2) also take a 2x2 feedback matrix,
+//   [1 - cross, cross; cross, 1 - cross],
+// applied to the delayed pair before the feedback multiply: 0 keeps L and
+// R independent, 1 swaps them on every pass. Its rows sum to 1, so the
+// loop gain is still `feedback`. pingPong sends the input's mono sum
+// (L + R) / 2 into the left side only; with cross = 1 the echoes then
+// alternate L, R, L... Bank rows are mono and ignore both.
+struct SharcKernelParams
+{
+    float feedback;
+    float wet;
+    float dry;
+    double delay = 48000.0;
+
+    float feedbackStep = 0.0f;
+    float wetStep = 0.0f;
+    float dryStep = 0.0f;
+    double delayStep = 0.0;
+
+    float cross = 0.0f;
+    float crossStep = 0.0f;
+    bool pingPong = false;
+
+    SharcInterpolation interpolation = SharcInterpolation::linear;
+    SharcSaturation saturation = SharcSaturation::hard;
+    const SharcTapTable* taps = nullptr;
+
+    bool isRamping() const noexcept
+    {
+        return feedbackStep != 0.0f || wetStep != 0.0f || dryStep != 0.0f || crossStep != 0.0f;
+    }
+
+    bool isCrossed() const noexcept { return cross != 0.0f || crossStep != 0.0f; }
+
+    bool isDelayMoving() const noexcept { return delayStep != 0.0; }
+
+    SharcFrameParams at(int frame) const noexcept
+    {
+        const auto f = static_cast<float>(frame);
+        return { feedback + feedbackStep * f, wet + wetStep * f, dry + dryStep * f,
+                 delay + delayStep * static_cast<double>(frame), taps, cross + crossStep * f, pingPong };
+    }
+
+    SharcKernelParams advancedBy(int numFrames) const noexcept
+    {
+        auto next = *this;
+        const auto p = at(numFrames);
+        next.feedback = p.feedback;
+        next.wet = p.wet;
+        next.dry = p.dry;
+        next.delay = p.delay;
+        next.cross = p.cross;
+        return next;
+    }
+};
+
+//==============================================================================
+// Feedback damping: a one-pole low cut and a one-pole high cut (bilinear),
+// multiplied out into one direct-form-I biquad that every ring write goes
+// through before the saturation.
+//
+// The recursion runs sample by sample, so the vector kernels use its
+// block form instead: the output at step k of a register is
+//   sum over j <= k of h[k - j] * x[j]  +  response to the carried state,
+// with h the impulse response and the state (x[-1], x[-2], y[-1], y[-2])
+// responses tabulated here. Each register then costs one broadcast and
+// one multiply-add per frame plus four for the state, and the L/R (or
+// bank) lanes are filtered side by side.
+struct SharcFeedbackFilter
+{
+    static constexpr int maxFrames = 16;        // frames per vector step (AVX-512 stereo)
+    static constexpr float lowCutOff = 20.0f;   // at or below: no low cut
+    static constexpr float highCutOff = 20000.0f; // at or above: no high cut
+
+    // y = b0 x + b1 x[-1] + b2 x[-2] - a1 y[-1] - a2 y[-2]
+    float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+    bool active = false;
+
+    // impulse[maxFrames + k] = h[k], zero in front so a load at
+    // maxFrames - j gives h[k - j] for every lane k
+    alignas(64) float impulse[2 * maxFrames] {};
+    alignas(64) float stateResponse[4][maxFrames] {};
+
+    // The same with every value twice, for interleaved L/R frames
+    alignas(64) float impulsePairs[4 * maxFrames] {};
+    alignas(64) float stateResponsePairs[4][2 * maxFrames] {};
+
+    float getLowCut() const noexcept { return lowCut; }
+    float getHighCut() const noexcept { return highCut; }
+
+    // Redesigns when anything changed. Returns true if the filter was
+    // just switched on (its owner then clears the stale history).
+    bool setCutoffs(double sampleRate, float lowCutHz, float highCutHz) noexcept
+    {
+        if (sampleRate == designedRate && lowCutHz == lowCut && highCutHz == highCut)
+            return false;
+
+        const bool wasActive = active;
+        designedRate = sampleRate;
+        lowCut = lowCutHz;
+        highCut = highCutHz;
+
+        const double maxCutoff = 0.45 * sampleRate;
+        const bool useLowCut = lowCutHz > lowCutOff;
+        const bool useHighCut = highCutHz < highCutOff && highCutHz < maxCutoff;
+        active = useLowCut || useHighCut;
+
+        // First-order sections (n0 + n1 z^-1) / (1 + d1 z^-1)
+        double hn0 = 1.0, hn1 = 0.0, hd1 = 0.0;
+        double ln0 = 1.0, ln1 = 0.0, ld1 = 0.0;
+
+        if (useLowCut)
+        {
+            const double k = std::tan(pi * std::fmin(static_cast<double>(lowCutHz), maxCutoff) / sampleRate);
+            hn0 = 1.0 / (1.0 + k);
+            hn1 = -hn0;
+            hd1 = (k - 1.0) / (k + 1.0);
+        }
+
+        if (useHighCut)
+        {
+            const double k = std::tan(pi * static_cast<double>(highCutHz) / sampleRate);
+            ln0 = k / (1.0 + k);
+            ln1 = ln0;
+            ld1 = (k - 1.0) / (k + 1.0);
+        }
+
+        b0 = static_cast<float>(hn0 * ln0);
+        b1 = static_cast<float>(hn0 * ln1 + hn1 * ln0);
+        b2 = static_cast<float>(hn1 * ln1);
+        a1 = static_cast<float>(hd1 + ld1);
+        a2 = static_cast<float>(hd1 * ld1);
+
+        fillTables();
+        return active && !wasActive;
+    }
+
+    // One sample; state is x[-1], x[-2], y[-1], y[-2]
+    float process(float x, float (&state)[4]) const noexcept
+    {
+        const float y = b0 * x + b1 * state[0] + b2 * state[1] - a1 * state[2] - a2 * state[3];
+        state[1] = state[0];
+        state[0] = x;
+        state[3] = state[2];
+        state[2] = y;
+        return y;
+    }
+
+private:
+    static constexpr double pi = 3.14159265358979323846;
+
+    // Runs the recursion from a unit input / unit state (linearity does
+    // the rest)
+    void fillTables() noexcept
+    {
+        for (int source = 0; source < 5; ++source)
+        {
+            double state[4] {};
+            double x = source == 0 ? 1.0 : 0.0;
+
+            if (source > 0)
+                state[source - 1] = 1.0;
+
+            for (int k = 0; k < maxFrames; ++k)
+            {
+                const double y = b0 * x + b1 * state[0] + b2 * state[1] - a1 * state[2] - a2 * state[3];
+                state[1] = state[0];
+                state[0] = x;
+                state[3] = state[2];
+                state[2] = y;
+                x = 0.0;
+
+                const auto value = static_cast<float>(y);
+                float* mono = source == 0 ? impulse + maxFrames : stateResponse[source - 1];
+                float* pairs = source == 0 ? impulsePairs + 2 * maxFrames : stateResponsePairs[source - 1];
+
+                mono[k] = value;
+                pairs[2 * k] = pairs[2 * k + 1] = value;
+            }
+        }
+    }
+
+    double designedRate = 0.0;
+    float lowCut = lowCutOff, highCut = highCutOff;
+};
+
+// What one channel's ring writes carry from sample to sample
+struct SharcWriteState
+{
+    float saturation = 0.0f;    // previous unsaturated write (soft2x)
+    float filter[4] {};         // feedback filter x[-1], x[-2], y[-1], y[-2]
+};
+
+// Freeze: the ring becomes read-only and the output loops over the
+// `length` frames that end at the write head, which stays put until the
+// loop has played out after a release (see SharcDelayLine::setFreeze).
+// length 0: not frozen.
+struct SharcFreezeLoop
+{
+    int length = 0;
+    int phase = 0;              // next frame of the loop, 0 .. length - 1
+
+    bool isActive() const noexcept { return length > 0; }
+
+    void advance(int numFrames) noexcept { phase = (phase + numFrames) % length; }
+};
+
+// Interleaved stereo ring with a separate write head. The read head sits
+// `delay` samples behind it, so changing the delay never moves the wrap
+// point or discards history.
+//
+// length is a power of two, so positions wrap with `& mask` instead of a
+// compare-and-branch. The first guardFrames frames are mirrored past the
+// end, so a tap window starting anywhere in the ring can be read with
+// plain contiguous loads and never straddles the wrap.
+//
+// The history is float, or int16 when format says so (then `compact`
+// holds it and `frames` is null); the kernels convert on load and store.
+struct SharcRing
+{
+    static constexpr int guardFrames = 32;  // >= widest register + 4 taps
+
+    float* frames = nullptr;    // length + guardFrames interleaved L/R frames
+    int16_t* compact = nullptr; // the same, SharcRingFormat::int16
+    SharcRingFormat format = SharcRingFormat::float32;
+    int length = 0;
+    int mask = 0;               // length - 1
+    int writeIndex = 0;
+    float allpassState[2] {};   // previous allpass output per channel
+    SharcWriteState writeState[2];
+    const SharcFeedbackFilter* filter = nullptr;  // owned by SharcDelayLine
+    SharcFreezeLoop freeze;     // see SharcDelayLine::setFreeze()
+
+    // Vector kernels write a float ring with non-temporal stores (set per
+    // block by SharcDelayLine for long delays); the scalar path ignores it
+    bool streamWrites = false;
+
+    template <typename Sample>
+    Sample* data() const noexcept
+    {
+        if constexpr (std::is_same_v<Sample, int16_t>)
+            return compact;
+        else
+            return frames;
+    }
+};
+
+// Planar rings for SharcDelayBank: one mono row per channel in a single
+// block, same power-of-two length, mask and guard layout as SharcRing.
+// Rows share the write head, so the whole bank advances together.
+struct SharcBankRing
+{
+    float* samples = nullptr;       // numChannels rows of `stride` floats
+    int16_t* compact = nullptr;     // the same, SharcRingFormat::int16
+    SharcRingFormat format = SharcRingFormat::float32;
+    float* allpassState = nullptr;  // one per channel
+    SharcWriteState* writeState = nullptr;          // one per channel
+    const SharcFeedbackFilter* filter = nullptr;    // shared by every row
+    int numChannels = 0;
+    int length = 0;
+    int mask = 0;                   // length - 1
+    int stride = 0;                 // length + guardFrames (whole cache lines)
+    int writeIndex = 0;
+    SharcFreezeLoop freeze;         // every row loops over the same frames
+
+    float* row(int channel) const noexcept { return samples + channel * stride; }
+
+    template <typename Sample>
+    Sample* row(int channel) const noexcept
+    {
+        if constexpr (std::is_same_v<Sample, int16_t>)
+            return compact + channel * stride;
+        else
+            return samples + channel * stride;
+    }
+};
+
+//==============================================================================
+// Ring sample <-> float. int16 maps +-1 (the write range of every
+// SharcSaturation mode) to +-32767 and truncates toward zero like the
+// vector conversions, so every kernel stores the same codes. Truncation
+// also lets a decaying tail reach zero: rounding to nearest would hold it
+// at one LSB as soon as feedback is above 0.5.
+constexpr float sharcCompactScale = 32767.0f;
+
+SHARC_KERNEL_INLINE float sharcRingValue(float sample) noexcept { return sample; }
+
+SHARC_KERNEL_INLINE float sharcRingValue(int16_t sample) noexcept
+{
+    return static_cast<float>(sample) * (1.0f / sharcCompactScale);
+}
+
+template <typename Sample>
+SHARC_KERNEL_INLINE Sample sharcRingSample(float value) noexcept
+{
+    if constexpr (std::is_same_v<Sample, int16_t>)
+        return static_cast<int16_t>(static_cast<int>(value * sharcCompactScale));
+    else
+        return value;
+}
+
+// Processes numFrames frames, advancing (and wrapping) ring.writeIndex.
+// Each output is either its input (in place) or does not overlap it at
+// all; a partial overlap would be overwritten before it is read. Requires
+// params.delay >= the kernel's minimum (see SharcDelayLine::minDelaySamples).
+using SharcKernelFn = void (*)(SharcRing& ring,
+    const float* inputLeft, const float* inputRight,
+    float* outputLeft, float* outputRight,
+    int numFrames, const SharcKernelParams& params) noexcept;
+
+// Processes numFrames frames of every bank channel in one call. Each
+// channel has its own params (delay, gains, ramps, interpolation); the
+// rows are planar like the host buffers. Same overlap (per channel) and
+// minimum delay rules as SharcKernelFn.
+using SharcBankKernelFn = void (*)(SharcBankRing& ring,
+    const float* const* inputs, float* const* outputs,
+    int numFrames, const SharcKernelParams* channelParams) noexcept;
+
+//==============================================================================
+// Multi-tap: extra read heads over the same ring, one compact table. Each
+// head reads at a fraction of the feedback delay, so the heads follow the
+// delay (and tempo sync) and never reach past the ring. The output then
+// hears the gain / pan weighted sum of the heads instead of the feedback
+// head; what is written back is unchanged. The arrays are parallel, so a
+// kernel walks every head in one pass.
+struct SharcTapTable
+{
+    static constexpr int maxTaps = 8;
+
+    int numTaps = 0;
+    float ratio[maxTaps] {};        // head delay / feedback delay, (0, 1]
+    float gain[maxTaps] {};         // mono rows (SharcDelayBank)
+    float gainLeft[maxTaps] {};     // gain with the pan applied (stereo)
+    float gainRight[maxTaps] {};
+
+    // Balance pan (-1 left .. 1 right): the centre keeps both sides at
+    // full gain
+    void setTap(int index, float delayRatio, float tapGain, float pan) noexcept
+    {
+        ratio[index] = std::fmin(1.0f, std::fmax(0.0f, delayRatio));
+        gain[index] = tapGain;
+        gainLeft[index] = tapGain * std::fmin(1.0f, 1.0f - pan);
+        gainRight[index] = tapGain * std::fmin(1.0f, 1.0f + pan);
+    }
+
+    // Never closer than one guard region to the write head: a vector step
+    // must not read frames it is about to write
+    double getDelay(int index, double delay) const noexcept
+    {
+        return std::fmax(static_cast<double>(SharcRing::guardFrames), delay * static_cast<double>(ratio[index]));
+    }
+};
+
+//==============================================================================
+// Software prefetch of the cache line holding p into L1. Only a hint: it
+// never faults, and is a no-op where the compiler has no intrinsic.
+SHARC_KERNEL_INLINE void sharcPrefetch(const void* p) noexcept
+{
+   #if defined(_MSC_VER) && SHARC_KERNELS_X86
+    _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+   #elif defined(_MSC_VER) && SHARC_KERNELS_NEON
+    __prefetch(p);
+   #elif defined(__GNUC__)
+    __builtin_prefetch(p, 0, 3);
+   #else
+    (void) p;
+   #endif
+}
+
+// Prefetches numFrames ring frames from `first` on (any value, wrapped
+// through the mask), one hint per 64-byte line. Rings (and bank rows) are
+// cache-line aligned, so lines hold whole frames and never straddle the
+// wrap.
+template <int numChannels, typename Sample>
+inline void sharcPrefetchFrames(const Sample* frames, int mask, int first, int numFrames) noexcept
+{
+    constexpr int framesPerLine = 64 / (numChannels * static_cast<int>(sizeof(Sample)));
+    const int end = (first & mask) + numFrames;
+
+    for (int f = first & mask & ~(framesPerLine - 1); f < end; f += framesPerLine)
+        sharcPrefetch(frames + numChannels * (f & mask));
+}
+
+inline void sharcPrefetchFrames(const SharcRing& ring, int first, int numFrames) noexcept
+{
+    if (ring.format == SharcRingFormat::int16)
+        sharcPrefetchFrames<2>(ring.compact, ring.mask, first, numFrames);
+    else
+        sharcPrefetchFrames<2>(ring.frames, ring.mask, first, numFrames);
+}
+
+//==============================================================================
+// Read position `delay` samples behind writeIndex, as the older of the two
+// neighbouring frames plus a fraction t in [0, 1) towards the newer one.
+struct SharcReadPosition
+{
+    int older;
+    float fraction;
+};
+
+inline SharcReadPosition sharcReadPosition(int writeIndex, double delay, int mask) noexcept
+{
+    // delay is always positive, so truncation is floor (and avoids a libm
+    // call on baseline x86-64)
+    const int whole = static_cast<int>(delay);
+    const auto frac = static_cast<float>(delay - whole);
+    const int offset = whole + (frac > 0.0f ? 1 : 0);
+
+    return { (writeIndex - offset) & mask, frac > 0.0f ? 1.0f - frac : 0.0f };
+}
+
+// FIR weights for taps at older-1, older, older+1, older+2
+inline void sharcTapWeights(SharcInterpolation mode, float t, float (&w)[4]) noexcept
+{
+    switch (mode)
+    {
+        case SharcInterpolation::hermite:
+            w[0] = ((-0.5f * t + 1.0f) * t - 0.5f) * t;
+            w[1] = (1.5f * t - 2.5f) * t * t + 1.0f;
+            w[2] = ((-1.5f * t + 2.0f) * t + 0.5f) * t;
+            w[3] = (0.5f * t - 0.5f) * t * t;
+            break;
+
+        case SharcInterpolation::lagrange:
+            w[0] = -t * (t - 1.0f) * (t - 2.0f) / 6.0f;
+            w[1] = (t + 1.0f) * (t - 1.0f) * (t - 2.0f) * 0.5f;
+            w[2] = -(t + 1.0f) * t * (t - 2.0f) * 0.5f;
+            w[3] = (t + 1.0f) * t * (t - 1.0f) / 6.0f;
+            break;
+
+        case SharcInterpolation::linear:
+        case SharcInterpolation::allpass:
+        default:
+            w[0] = 0.0f;
+            w[1] = 1.0f - t;
+            w[2] = t;
+            w[3] = 0.0f;
+            break;
+    }
+}
+
+//==============================================================================
+inline float sharcHardClip(float x) noexcept
+{
+    return x < -1.0f ? -1.0f : (x > 1.0f ? 1.0f : x);
+}
+
+// tanh approximation x (27 + x^2) / (27 + 9 x^2): within 2.5% of tanh,
+// reaches exactly +-1 with zero slope at |x| = 3 and is clamped beyond
+inline float sharcSoftClip(float x) noexcept
+{
+    x = x < -3.0f ? -3.0f : (x > 3.0f ? 3.0f : x);
+    const float x2 = x * x;
+    return x * (27.0f + x2) / (27.0f + 9.0f * x2);
+}
+
+// The write saturation. soft2x also evaluates the curve halfway between
+// this sample and the previous one (linear 2x upsampling) and averages
+// the two, but only for what the curve changes (f(x) - x): quiet signals
+// pass essentially unfiltered, and the harmonics it adds alias less.
+// previous holds the last unsaturated write of the channel.
+inline float sharcSaturate(float x, SharcSaturation mode, float& previous) noexcept
+{
+    switch (mode)
+    {
+        case SharcSaturation::soft:
+            return sharcSoftClip(x);
+
+        case SharcSaturation::soft2x:
+        {
+            const float mid = 0.5f * (previous + x);
+            previous = x;
+            return sharcHardClip(x + 0.5f * ((sharcSoftClip(x) - x) + (sharcSoftClip(mid) - mid)));
+        }
+
+        case SharcSaturation::hard:
+        default:
+            return sharcHardClip(x);
+    }
+}
+
+// Mix + write of the stable feedback formula for one channel. Shared by
+// every kernel for heads and tails so they all round identically.
+// `heard` is what the output mixes in: the delayed sample, or the sum of
+// the tap heads. `send` and `delayed` are what the ring gets back: the
+// input and the feedback head, after any stereo routing.
+inline void sharcWriteSample(float& slot, float input, float send, float delayed, float heard, float& output,
+    const SharcFrameParams& params, SharcSaturation saturation,
+    const SharcFeedbackFilter* filter, SharcWriteState& state) noexcept
+{
+    // 2. Mix and output
+    output = (input * params.dry) + (heard * params.wet);
+
+    // 3. STABLE FORMULA: input + (feedback * delayed)
+    //    This ensures exponential decay, not growth
+    float newSample = send + (params.feedback * delayed);
+
+    // 4. Damping, then clip or saturate to prevent overflow (safety)
+    if (filter != nullptr && filter->active)
+        newSample = filter->process(newSample, state.filter);
+
+    slot = sharcSaturate(newSample, saturation, state.saturation);
+}
+
+// Weighted sum of every tap head for one time step. Heads interpolate
+// like the feedback head, except that the allpass (which needs state per
+// head) becomes Hermite.
+template <int Channels, typename Sample>
+inline void sharcReadTaps(const Sample* frames, int mask, int w, double delay,
+    const SharcTapTable& taps, SharcInterpolation mode, float* heard) noexcept
+{
+    if (mode == SharcInterpolation::allpass)
+        mode = SharcInterpolation::hermite;
+
+    for (int ch = 0; ch < Channels; ++ch)
+        heard[ch] = 0.0f;
+
+    for (int t = 0; t < taps.numTaps; ++t)
+    {
+        const auto pos = sharcReadPosition(w, taps.getDelay(t, delay), mask);
+        const Sample* xm1 = frames + Channels * ((pos.older - 1) & mask);
+
+        float c[4];
+        sharcTapWeights(mode, pos.fraction, c);
+
+        for (int ch = 0; ch < Channels; ++ch)
+        {
+            const float g = Channels == 2 ? (ch == 0 ? taps.gainLeft[t] : taps.gainRight[t]) : taps.gain[t];
+            heard[ch] += g * (c[0] * sharcRingValue(xm1[ch]) + c[1] * sharcRingValue(xm1[ch + Channels])
+                            + c[2] * sharcRingValue(xm1[ch + 2 * Channels]) + c[3] * sharcRingValue(xm1[ch + 3 * Channels]));
+        }
+    }
+}
+
+// Stereo routing of one frame (see SharcKernelParams): ping-pong's mono
+// send, then the feedback matrix. Written as the vector kernels do it.
+inline void sharcRouteStereo(const float* input, const float* delayed, const SharcFrameParams& params,
+    float* send, float* fed) noexcept
+{
+    if (params.pingPong)
+    {
+        send[0] = (input[0] + input[1]) * 0.5f;
+        send[1] = 0.0f;
+    }
+
+    if (params.cross != 0.0f)
+    {
+        fed[0] = params.cross * (delayed[1] - delayed[0]) + delayed[0];
+        fed[1] = params.cross * (delayed[0] - delayed[1]) + delayed[1];
+    }
+}
+
+// One time step of Channels interleaved samples at write position w:
+// fractional read, mix and write (including the guard mirror). The
+// caller advances w. frames must have length + guardFrames steps.
+template <int Channels, typename Sample = float>
+inline void sharcProcessStep(Sample* frames, int length, int mask, int w,
+    const float* input, float* output, const SharcFrameParams& params,
+    SharcInterpolation mode, float* allpassState,
+    SharcSaturation saturation, const SharcFeedbackFilter* filter, SharcWriteState* writeState) noexcept
+{
+    const auto pos = sharcReadPosition(w, params.delay, mask);
+
+    // Taps older-1 .. older+2 are contiguous thanks to the guard region
+    const Sample* xm1 = frames + Channels * ((pos.older - 1) & mask);
+    const Sample* x0 = frames + Channels * pos.older;
+    const Sample* x1 = x0 + Channels;
+
+    // 1. Read delayed sample (fractional)
+    float delayed[Channels];
+
+    if (mode == SharcInterpolation::allpass)
+    {
+        const float eta = pos.fraction / (2.0f - pos.fraction);
+
+        for (int ch = 0; ch < Channels; ++ch)
+        {
+            delayed[ch] = eta * (sharcRingValue(x1[ch]) - allpassState[ch]) + sharcRingValue(x0[ch]);
+            allpassState[ch] = delayed[ch];
+        }
+    }
+    else if (mode == SharcInterpolation::linear)
+    {
+        for (int ch = 0; ch < Channels; ++ch)
+            delayed[ch] = sharcRingValue(x0[ch]) + pos.fraction * (sharcRingValue(x1[ch]) - sharcRingValue(x0[ch]));
+    }
+    else
+    {
+        float c[4];
+        sharcTapWeights(mode, pos.fraction, c);
+
+        for (int ch = 0; ch < Channels; ++ch)
+            delayed[ch] = c[0] * sharcRingValue(xm1[ch]) + c[1] * sharcRingValue(xm1[ch + Channels])
+                        + c[2] * sharcRingValue(xm1[ch + 2 * Channels]) + c[3] * sharcRingValue(xm1[ch + 3 * Channels]);
+    }
+
+    // Tap heads replace the feedback head in the output
+    float heard[Channels];
+    const float* mixed = delayed;
+
+    if (params.taps != nullptr)
+    {
+        sharcReadTaps<Channels>(frames, mask, w, params.delay, *params.taps, mode, heard);
+        mixed = heard;
+    }
+
+    float send[Channels], fed[Channels];
+
+    for (int ch = 0; ch < Channels; ++ch)
+    {
+        send[ch] = input[ch];
+        fed[ch] = delayed[ch];
+    }
+
+    if constexpr (Channels == 2)
+        sharcRouteStereo(input, delayed, params, send, fed);
+
+    Sample* frame = frames + Channels * w;
+
+    for (int ch = 0; ch < Channels; ++ch)
+    {
+        float written;
+        sharcWriteSample(written, input[ch], send[ch], fed[ch], mixed[ch], output[ch], params, saturation, filter, writeState[ch]);
+        frame[ch] = sharcRingSample<Sample>(written);
+    }
+
+    if (w < SharcRing::guardFrames)
+        for (int ch = 0; ch < Channels; ++ch)
+            frame[Channels * length + ch] = frame[ch];
+}
+
+// One stereo frame with a fractional read, then advance the write head
+template <typename Sample = float>
+inline void sharcProcessFrame(SharcRing& ring, float inLeft, float inRight,
+    float& outLeft, float& outRight, const SharcFrameParams& params,
+    SharcInterpolation mode, SharcSaturation saturation) noexcept
+{
+    const float input[2] = { inLeft, inRight };
+    float output[2];
+
+    sharcProcessStep<2>(ring.data<Sample>(), ring.length, ring.mask, ring.writeIndex,
+        input, output, params, mode, ring.allpassState, saturation, ring.filter, ring.writeState);
+
+    outLeft = output[0];
+    outRight = output[1];
+
+    // 5. Circular buffer wraparound
+    ring.writeIndex = (ring.writeIndex + 1) & ring.mask;
+}
+
+//==============================================================================
+// Frozen rings: the loop's frames go straight to the mix. No write, no
+// feedback multiply and no clip, so a frozen loop is a pure streaming read
+// and replays exactly, pass after pass.
+
+// Calls fn(position, firstFrame, numFrames) for each run of the next
+// numFrames loop frames that is contiguous in the ring as well as the
+// loop. The caller advances the loop once it has played every row.
+template <typename Fn>
+inline void sharcForEachFrozenRun(SharcFreezeLoop loop, int writeIndex, int length, int mask,
+    int numFrames, Fn&& fn) noexcept
+{
+    for (int i = 0; i < numFrames;)
+    {
+        const int position = (writeIndex - loop.length + loop.phase) & mask;
+        const int run = std::min({ numFrames - i, loop.length - loop.phase, length - position });
+
+        fn(position, i, run);
+
+        i += run;
+        loop.advance(run);
+    }
+}
+
+// One time step of a frozen ring, same mix as sharcWriteSample
+template <int Channels, typename Sample>
+SHARC_KERNEL_INLINE void sharcFrozenStep(const Sample* frame, const float* input, float* output,
+    float dry, float wet) noexcept
+{
+    for (int ch = 0; ch < Channels; ++ch)
+        output[ch] = (input[ch] * dry) + (sharcRingValue(frame[ch]) * wet);
+}
+
+// Once, as a loop is taken: its last fadeFrames frames crossfade into the
+// frames just before its start, so the wrap back to the start carries on
+// the signal instead of jumping. Reads fadeFrames of history older than
+// the loop (the ring must hold loopLength + fadeFrames), so the frozen
+// passes themselves stay read-only.
+template <int Channels, typename Sample>
+inline void sharcFadeLoopSeam(Sample* frames, int length, int mask, int writeIndex,
+    int loopLength, int fadeFrames) noexcept
+{
+    for (int i = 0; i < fadeFrames; ++i)
+    {
+        const float in = static_cast<float>(i + 1) / static_cast<float>(fadeFrames + 1);
+        const int w = (writeIndex - fadeFrames + i) & mask;
+        const Sample* before = frames + Channels * ((w - loopLength) & mask);
+        Sample* frame = frames + Channels * w;
+
+        for (int ch = 0; ch < Channels; ++ch)
+        {
+            const float end = sharcRingValue(frame[ch]);
+            frame[ch] = sharcRingSample<Sample>(end + in * (sharcRingValue(before[ch]) - end));
+        }
+
+        if (w < SharcRing::guardFrames)
+            for (int ch = 0; ch < Channels; ++ch)
+                frame[Channels * length + ch] = frame[ch];
+    }
+}
+
+// A released loop playing out: each frame is mixed as in sharcFrozenStep,
+// then overwritten with the input, written at feedback 0 (send, damping
+// and saturation as sharcWriteSample). The loop ends at the write head, so
+// once it has run out and the head moves on, that input lies one loop
+// behind it and its echoes come on time. Frame by frame, since each frame
+// is read before it is written. The caller advances the loop.
+template <int Channels, typename Sample>
+inline void sharcReleaseFrozenSteps(Sample* frames, SharcFreezeLoop loop, int length, int mask, int writeIndex,
+    const float* const* inputs, float* const* outputs, int numFrames, const SharcKernelParams& params,
+    const SharcFeedbackFilter* filter, SharcWriteState* writeState) noexcept
+{
+    const float silent[Channels] {};
+
+    sharcForEachFrozenRun(loop, writeIndex, length, mask, numFrames, [&](int position, int first, int count)
+    {
+        for (int i = first; i < first + count; ++i)
+        {
+            const int w = position + i - first;
+            Sample* frame = frames + Channels * w;
+
+            auto frameParams = params.at(i);
+            frameParams.feedback = 0.0f;
+
+            float input[Channels], send[Channels], fed[Channels];
+
+            for (int ch = 0; ch < Channels; ++ch)
+                input[ch] = send[ch] = inputs[ch][i];
+
+            if constexpr (Channels == 2)
+                sharcRouteStereo(input, silent, frameParams, send, fed);
+
+            for (int ch = 0; ch < Channels; ++ch)
+            {
+                float written;
+                sharcWriteSample(written, input[ch], send[ch], 0.0f, sharcRingValue(frame[ch]), outputs[ch][i],
+                    frameParams, params.saturation, filter, writeState[ch]);
+                frame[ch] = sharcRingSample<Sample>(written);
+            }
+
+            if (w < SharcRing::guardFrames)
+                for (int ch = 0; ch < Channels; ++ch)
+                    frame[Channels * length + ch] = frame[ch];
+        }
+    });
+}
+
+//==============================================================================
+namespace SharcDelayKernels
+{
+    // True if this build contains the variant and the CPU can run it
+    bool isSupported(SharcKernelIsa isa) noexcept;
+
+    // Widest supported variant (what "Auto" resolves to)
+    SharcKernelIsa getBestAvailable() noexcept;
+
+    // Auto -> best available; a forced ISA the CPU lacks steps down to the
+    // next narrower supported one (AVX-512 -> AVX2 -> SSE2 -> Scalar).
+    SharcKernelIsa resolve(SharcKernelIsa requested) noexcept;
+
+    // Never null: unsupported variants return the scalar kernel
+    SharcKernelFn getKernel(SharcKernelIsa isa) noexcept;
+    SharcBankKernelFn getBankKernel(SharcKernelIsa isa) noexcept;
+
+    const char* getName(SharcKernelIsa isa) noexcept;
+
+    namespace detail
+    {
+        void processScalar(SharcRing&, const float*, const float*, float*, float*, int, const SharcKernelParams&) noexcept;
+        void processBankScalar(SharcBankRing&, const float* const*, float* const*, int, const SharcKernelParams*) noexcept;
+
+       #if SHARC_KERNELS_X86
+        void processSSE2(SharcRing&, const float*, const float*, float*, float*, int, const SharcKernelParams&) noexcept;
+        void processAVX2(SharcRing&, const float*, const float*, float*, float*, int, const SharcKernelParams&) noexcept;
+        void processAVX512(SharcRing&, const float*, const float*, float*, float*, int, const SharcKernelParams&) noexcept;
+        void processBankSSE2(SharcBankRing&, const float* const*, float* const*, int, const SharcKernelParams*) noexcept;
+        void processBankAVX2(SharcBankRing&, const float* const*, float* const*, int, const SharcKernelParams*) noexcept;
+        void processBankAVX512(SharcBankRing&, const float* const*, float* const*, int, const SharcKernelParams*) noexcept;
+       #endif
+
+       #if SHARC_KERNELS_NEON
+        void processNEON(SharcRing&, const float*, const float*, float*, float*, int, const SharcKernelParams&) noexcept;
+        void processBankNEON(SharcBankRing&, const float* const*, float* const*, int, const SharcKernelParams*) noexcept;
+       #endif
+    }
+}
@@ -0,0 +1,119 @@
+/*
+  SHARC Echo/Delay Effect Plugin - AVX2 Kernel
+  JUCE 8.0.11 - 8 floats per register, fused multiply-add
+*/
+
+#include "SharcDelayKernels.h"
+
+#if SHARC_KERNELS_X86
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+ #pragma clang attribute push (__attribute__((target("avx2,fma"))), apply_to = function)
+#elif defined(__GNUC__)
+ #pragma GCC push_options
+ #pragma GCC target("avx2,fma")
+#endif
+
+namespace
+{
+    struct AVX2Ops
+    {
+        using Vec = __m256;
+        static constexpr int width = 8;
+
+        static Vec broadcast(float x) noexcept            { return _mm256_set1_ps(x); }
+        static Vec load(const float* p) noexcept          { return _mm256_load_ps(p); }
+        static Vec loadu(const float* p) noexcept         { return _mm256_loadu_ps(p); }
+        static void store(float* p, Vec v) noexcept       { _mm256_store_ps(p, v); }
+        static void storeu(float* p, Vec v) noexcept      { _mm256_storeu_ps(p, v); }
+        static void stream(float* p, Vec v) noexcept      { _mm256_stream_ps(p, v); }
+        static void fence() noexcept                      { _mm_sfence(); }
+
+        // 8 int16 <-> 8 floats; the pack works per lane, so pack the halves
+        static Vec loadCompact(const int16_t* p) noexcept
+        {
+            const __m256i s = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+            return _mm256_mul_ps(_mm256_cvtepi32_ps(s), _mm256_set1_ps(1.0f / sharcCompactScale));
+        }
+
+        static void storeCompact(int16_t* p, Vec v) noexcept
+        {
+            const __m256i i = _mm256_cvttps_epi32(_mm256_mul_ps(v, _mm256_set1_ps(sharcCompactScale)));
+            _mm_store_si128(reinterpret_cast<__m128i*>(p), _mm_packs_epi32(_mm256_castsi256_si128(i), _mm256_extracti128_si256(i, 1)));
+        }
+        static Vec add(Vec a, Vec b) noexcept             { return _mm256_add_ps(a, b); }
+        static Vec sub(Vec a, Vec b) noexcept             { return _mm256_sub_ps(a, b); }
+        static Vec mul(Vec a, Vec b) noexcept             { return _mm256_mul_ps(a, b); }
+        static Vec div(Vec a, Vec b) noexcept             { return _mm256_div_ps(a, b); }
+        static Vec mulAdd(Vec a, Vec b, Vec c) noexcept   { return _mm256_fmadd_ps(a, b, c); }
+        static Vec min(Vec a, Vec b) noexcept             { return _mm256_min_ps(a, b); }
+        static Vec max(Vec a, Vec b) noexcept             { return _mm256_max_ps(a, b); }
+
+        // unpack works per 128-bit lane, so fix the lane order afterwards
+        static void interleave(Vec l, Vec r, Vec& lo, Vec& hi) noexcept
+        {
+            const Vec a = _mm256_unpacklo_ps(l, r); // L0 R0 L1 R1 | L4 R4 L5 R5
+            const Vec b = _mm256_unpackhi_ps(l, r); // L2 R2 L3 R3 | L6 R6 L7 R7
+            lo = _mm256_permute2f128_ps(a, b, 0x20);
+            hi = _mm256_permute2f128_ps(a, b, 0x31);
+        }
+
+        static void deinterleave(Vec lo, Vec hi, Vec& l, Vec& r) noexcept
+        {
+            const Vec a = _mm256_permute2f128_ps(lo, hi, 0x20); // L0 R0 L1 R1 | L4 R4 L5 R5
+            const Vec b = _mm256_permute2f128_ps(lo, hi, 0x31); // L2 R2 L3 R3 | L6 R6 L7 R7
+            l = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            r = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        }
+
+        // Shifts across the 128-bit lanes go through [p4..p7 | c0..c3]
+        static Vec previousFrames(Vec prev, Vec cur) noexcept
+        {
+            const Vec t = _mm256_permute2f128_ps(prev, cur, 0x21);
+            return _mm256_shuffle_ps(t, cur, _MM_SHUFFLE(1, 0, 3, 2)); // p6 p7 c0 c1 | c2 c3 c4 c5
+        }
+
+        static Vec previousSamples(Vec prev, Vec cur) noexcept
+        {
+            const Vec t = _mm256_permute2f128_ps(prev, cur, 0x21);
+            return _mm256_castsi256_ps(_mm256_alignr_epi8(_mm256_castps_si256(cur), _mm256_castps_si256(t), 12)); // p7 c0 .. c6
+        }
+
+        static Vec broadcastPair(const float* p) noexcept
+        {
+            return _mm256_castpd_ps(_mm256_broadcast_sd(reinterpret_cast<const double*>(p)));
+        }
+
+        static Vec swapPairs(Vec a) noexcept
+        {
+            return _mm256_permute_ps(a, _MM_SHUFFLE(2, 3, 0, 1));
+        }
+    };
+}
+
+#include "SharcDelayKernelBody.h"
+
+void SharcDelayKernels::detail::processAVX2(SharcRing& ring,
+    const float* inputLeft, const float* inputRight,
+    float* outputLeft, float* outputRight,
+    int numFrames, const SharcKernelParams& params) noexcept
+{
+    processFrames<AVX2Ops>(ring, inputLeft, inputRight, outputLeft, outputRight, numFrames, params);
+}
+
+void SharcDelayKernels::detail::processBankAVX2(SharcBankRing& ring,
+    const float* const* inputs, float* const* outputs,
+    int numFrames, const SharcKernelParams* channelParams) noexcept
+{
+    processBank<AVX2Ops>(ring, inputs, outputs, numFrames, channelParams);
+}
+
+#if defined(__clang__)
+ #pragma clang attribute pop
+#elif defined(__GNUC__)
+ #pragma GCC pop_options
+#endif
+
+#endif // SHARC_KERNELS_X86
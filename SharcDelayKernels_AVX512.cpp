@@ -0,0 +1,118 @@
+/*
+  SHARC Echo/Delay Effect Plugin - AVX-512 Kernel
+  JUCE 8.0.11 - 16 floats per register, fused multiply-add
+*/
+
+#include "SharcDelayKernels.h"
+
+#if SHARC_KERNELS_X86
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+ #pragma clang attribute push (__attribute__((target("avx512f"))), apply_to = function)
+#elif defined(__GNUC__)
+ #pragma GCC push_options
+ #pragma GCC target("avx512f")
+#endif
+
+namespace
+{
+    struct AVX512Ops
+    {
+        using Vec = __m512;
+        static constexpr int width = 16;
+
+        static Vec broadcast(float x) noexcept            { return _mm512_set1_ps(x); }
+        static Vec load(const float* p) noexcept          { return _mm512_load_ps(p); }
+        static Vec loadu(const float* p) noexcept         { return _mm512_loadu_ps(p); }
+        static void store(float* p, Vec v) noexcept       { _mm512_store_ps(p, v); }
+        static void storeu(float* p, Vec v) noexcept      { _mm512_storeu_ps(p, v); }
+        static void stream(float* p, Vec v) noexcept      { _mm512_stream_ps(p, v); }
+        static void fence() noexcept                      { _mm_sfence(); }
+
+        // 16 int16 <-> 16 floats (vpmovsxwd / vpmovsdw)
+        static Vec loadCompact(const int16_t* p) noexcept
+        {
+            const __m512i s = _mm512_cvtepi16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+            return _mm512_mul_ps(_mm512_cvtepi32_ps(s), _mm512_set1_ps(1.0f / sharcCompactScale));
+        }
+
+        static void storeCompact(int16_t* p, Vec v) noexcept
+        {
+            const __m512i i = _mm512_cvttps_epi32(_mm512_mul_ps(v, _mm512_set1_ps(sharcCompactScale)));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(p), _mm512_cvtsepi32_epi16(i));
+        }
+        static Vec add(Vec a, Vec b) noexcept             { return _mm512_add_ps(a, b); }
+        static Vec sub(Vec a, Vec b) noexcept             { return _mm512_sub_ps(a, b); }
+        static Vec mul(Vec a, Vec b) noexcept             { return _mm512_mul_ps(a, b); }
+        static Vec div(Vec a, Vec b) noexcept             { return _mm512_div_ps(a, b); }
+        static Vec mulAdd(Vec a, Vec b, Vec c) noexcept   { return _mm512_fmadd_ps(a, b, c); }
+        static Vec min(Vec a, Vec b) noexcept             { return _mm512_min_ps(a, b); }
+        static Vec max(Vec a, Vec b) noexcept             { return _mm512_max_ps(a, b); }
+
+        // Two-source permutes: index bit 4 selects the second operand
+        static void interleave(Vec l, Vec r, Vec& lo, Vec& hi) noexcept
+        {
+            const __m512i loIdx = _mm512_setr_epi32(0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23);
+            const __m512i hiIdx = _mm512_setr_epi32(8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31);
+            lo = _mm512_permutex2var_ps(l, loIdx, r);
+            hi = _mm512_permutex2var_ps(l, hiIdx, r);
+        }
+
+        static void deinterleave(Vec lo, Vec hi, Vec& l, Vec& r) noexcept
+        {
+            const __m512i evenIdx = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+            const __m512i oddIdx = _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+            l = _mm512_permutex2var_ps(lo, evenIdx, hi);
+            r = _mm512_permutex2var_ps(lo, oddIdx, hi);
+        }
+
+        // alignr over cur:prev -> [p14 p15 c0 .. c13] / [p15 c0 .. c14]
+        static Vec previousFrames(Vec prev, Vec cur) noexcept
+        {
+            return _mm512_castsi512_ps(_mm512_alignr_epi32(_mm512_castps_si512(cur), _mm512_castps_si512(prev), 14));
+        }
+
+        static Vec previousSamples(Vec prev, Vec cur) noexcept
+        {
+            return _mm512_castsi512_ps(_mm512_alignr_epi32(_mm512_castps_si512(cur), _mm512_castps_si512(prev), 15));
+        }
+
+        static Vec broadcastPair(const float* p) noexcept
+        {
+            const __m128 pair = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(p));
+            return _mm512_castpd_ps(_mm512_broadcastsd_pd(_mm_castps_pd(pair)));
+        }
+
+        static Vec swapPairs(Vec a) noexcept
+        {
+            return _mm512_permute_ps(a, _MM_SHUFFLE(2, 3, 0, 1));
+        }
+    };
+}
+
+#include "SharcDelayKernelBody.h"
+
+void SharcDelayKernels::detail::processAVX512(SharcRing& ring,
+    const float* inputLeft, const float* inputRight,
+    float* outputLeft, float* outputRight,
+    int numFrames, const SharcKernelParams& params) noexcept
+{
+    processFrames<AVX512Ops>(ring, inputLeft, inputRight, outputLeft, outputRight, numFrames, params);
+}
+
+void SharcDelayKernels::detail::processBankAVX512(SharcBankRing& ring,
+    const float* const* inputs, float* const* outputs,
+    int numFrames, const SharcKernelParams* channelParams) noexcept
+{
+    processBank<AVX512Ops>(ring, inputs, outputs, numFrames, channelParams);
+}
+
+#if defined(__clang__)
+ #pragma clang attribute pop
+#elif defined(__GNUC__)
+ #pragma GCC pop_options
+#endif
+
+#endif // SHARC_KERNELS_X86
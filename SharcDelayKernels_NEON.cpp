@@ -0,0 +1,103 @@
+/*
+  SHARC Echo/Delay Effect Plugin - NEON Kernel
+  JUCE 8.0.11 - 4 floats per register (Apple Silicon / AArch64 baseline)
+*/
+
+#include "SharcDelayKernels.h"
+
+#if SHARC_KERNELS_NEON
+
+#include <arm_neon.h>
+
+namespace
+{
+    struct NEONOps
+    {
+        using Vec = float32x4_t;
+        static constexpr int width = 4;
+
+        static Vec broadcast(float x) noexcept            { return vdupq_n_f32(x); }
+        static Vec load(const float* p) noexcept          { return vld1q_f32(p); }
+        static Vec loadu(const float* p) noexcept         { return vld1q_f32(p); }
+        static void store(float* p, Vec v) noexcept       { vst1q_f32(p, v); }
+        static void storeu(float* p, Vec v) noexcept      { vst1q_f32(p, v); }
+        static void stream(float* p, Vec v) noexcept      { vst1q_f32(p, v); }   // no non-temporal intrinsic
+        static void fence() noexcept                      {}
+
+        // 4 int16 <-> 4 floats; vcvtq_s32_f32 truncates toward zero
+        static Vec loadCompact(const int16_t* p) noexcept
+        {
+            return vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vld1_s16(p))), 1.0f / sharcCompactScale);
+        }
+
+        static void storeCompact(int16_t* p, Vec v) noexcept
+        {
+            vst1_s16(p, vqmovn_s32(vcvtq_s32_f32(vmulq_n_f32(v, sharcCompactScale))));
+        }
+        static Vec add(Vec a, Vec b) noexcept             { return vaddq_f32(a, b); }
+        static Vec sub(Vec a, Vec b) noexcept             { return vsubq_f32(a, b); }
+        static Vec mul(Vec a, Vec b) noexcept             { return vmulq_f32(a, b); }
+        static Vec min(Vec a, Vec b) noexcept             { return vminq_f32(a, b); }
+        static Vec max(Vec a, Vec b) noexcept             { return vmaxq_f32(a, b); }
+
+        static Vec mulAdd(Vec a, Vec b, Vec c) noexcept
+        {
+           #if defined(__aarch64__) || defined(_M_ARM64)
+            return vfmaq_f32(c, a, b);
+           #else
+            return vmlaq_f32(c, a, b);
+           #endif
+        }
+
+        static Vec div(Vec a, Vec b) noexcept
+        {
+           #if defined(__aarch64__) || defined(_M_ARM64)
+            return vdivq_f32(a, b);
+           #else
+            // ARMv7 has no vector divide: estimate plus two Newton steps
+            Vec r = vrecpeq_f32(b);
+            r = vmulq_f32(vrecpsq_f32(b, r), r);
+            r = vmulq_f32(vrecpsq_f32(b, r), r);
+            return vmulq_f32(a, r);
+           #endif
+        }
+
+        static void interleave(Vec l, Vec r, Vec& lo, Vec& hi) noexcept
+        {
+            const float32x4x2_t z = vzipq_f32(l, r);
+            lo = z.val[0];
+            hi = z.val[1];
+        }
+
+        static void deinterleave(Vec lo, Vec hi, Vec& l, Vec& r) noexcept
+        {
+            const float32x4x2_t u = vuzpq_f32(lo, hi);
+            l = u.val[0];
+            r = u.val[1];
+        }
+
+        static Vec previousFrames(Vec prev, Vec cur) noexcept  { return vextq_f32(prev, cur, 2); }
+        static Vec previousSamples(Vec prev, Vec cur) noexcept { return vextq_f32(prev, cur, 3); }
+        static Vec broadcastPair(const float* p) noexcept  { const float32x2_t pair = vld1_f32(p); return vcombine_f32(pair, pair); }
+        static Vec swapPairs(Vec a) noexcept               { return vrev64q_f32(a); }
+    };
+}
+
+#include "SharcDelayKernelBody.h"
+
+void SharcDelayKernels::detail::processNEON(SharcRing& ring,
+    const float* inputLeft, const float* inputRight,
+    float* outputLeft, float* outputRight,
+    int numFrames, const SharcKernelParams& params) noexcept
+{
+    processFrames<NEONOps>(ring, inputLeft, inputRight, outputLeft, outputRight, numFrames, params);
+}
+
+void SharcDelayKernels::detail::processBankNEON(SharcBankRing& ring,
+    const float* const* inputs, float* const* outputs,
+    int numFrames, const SharcKernelParams* channelParams) noexcept
+{
+    processBank<NEONOps>(ring, inputs, outputs, numFrames, channelParams);
+}
+
+#endif // SHARC_KERNELS_NEON
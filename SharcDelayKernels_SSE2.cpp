@@ -0,0 +1,117 @@
+/*
+  SHARC Echo/Delay Effect Plugin - SSE2 Kernel
+  JUCE 8.0.11 - 4 floats per register (x86 baseline)
+*/
+
+#include "SharcDelayKernels.h"
+
+#if SHARC_KERNELS_X86
+
+#include <emmintrin.h>
+
+#if defined(__clang__)
+ #pragma clang attribute push (__attribute__((target("sse2"))), apply_to = function)
+#elif defined(__GNUC__)
+ #pragma GCC push_options
+ #pragma GCC target("sse2")
+#endif
+
+namespace
+{
+    struct SSE2Ops
+    {
+        using Vec = __m128;
+        static constexpr int width = 4;
+
+        static Vec broadcast(float x) noexcept            { return _mm_set1_ps(x); }
+        static Vec load(const float* p) noexcept          { return _mm_load_ps(p); }
+        static Vec loadu(const float* p) noexcept         { return _mm_loadu_ps(p); }
+        static void store(float* p, Vec v) noexcept       { _mm_store_ps(p, v); }
+        static void storeu(float* p, Vec v) noexcept      { _mm_storeu_ps(p, v); }
+        static void stream(float* p, Vec v) noexcept      { _mm_stream_ps(p, v); }
+        static void fence() noexcept                      { _mm_sfence(); }
+
+        // 4 int16 <-> 4 floats; unpack + arithmetic shift sign-extends
+        static Vec loadCompact(const int16_t* p) noexcept
+        {
+            const __m128i s = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+            return _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16)), _mm_set1_ps(1.0f / sharcCompactScale));
+        }
+
+        static void storeCompact(int16_t* p, Vec v) noexcept
+        {
+            const __m128i i = _mm_cvttps_epi32(_mm_mul_ps(v, _mm_set1_ps(sharcCompactScale)));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_packs_epi32(i, i));
+        }
+        static Vec add(Vec a, Vec b) noexcept             { return _mm_add_ps(a, b); }
+        static Vec sub(Vec a, Vec b) noexcept             { return _mm_sub_ps(a, b); }
+        static Vec mul(Vec a, Vec b) noexcept             { return _mm_mul_ps(a, b); }
+        static Vec div(Vec a, Vec b) noexcept             { return _mm_div_ps(a, b); }
+        static Vec mulAdd(Vec a, Vec b, Vec c) noexcept   { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+        static Vec min(Vec a, Vec b) noexcept             { return _mm_min_ps(a, b); }
+        static Vec max(Vec a, Vec b) noexcept             { return _mm_max_ps(a, b); }
+
+        // L0..L3, R0..R3 -> [L0 R0 L1 R1], [L2 R2 L3 R3]
+        static void interleave(Vec l, Vec r, Vec& lo, Vec& hi) noexcept
+        {
+            lo = _mm_unpacklo_ps(l, r);
+            hi = _mm_unpackhi_ps(l, r);
+        }
+
+        static void deinterleave(Vec lo, Vec hi, Vec& l, Vec& r) noexcept
+        {
+            l = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+            r = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+        }
+
+        // [p0 p1 p2 p3], [c0 c1 c2 c3] -> [p2 p3 c0 c1]
+        static Vec previousFrames(Vec prev, Vec cur) noexcept
+        {
+            return _mm_shuffle_ps(prev, cur, _MM_SHUFFLE(1, 0, 3, 2));
+        }
+
+        // -> [p3 c0 c1 c2] (no palignr before SSSE3)
+        static Vec previousSamples(Vec prev, Vec cur) noexcept
+        {
+            const Vec t = _mm_shuffle_ps(prev, cur, _MM_SHUFFLE(0, 0, 3, 3)); // p3 p3 c0 c0
+            return _mm_shuffle_ps(t, cur, _MM_SHUFFLE(2, 1, 2, 0));
+        }
+
+        static Vec broadcastPair(const float* p) noexcept
+        {
+            const Vec pair = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(p));
+            return _mm_movelh_ps(pair, pair);
+        }
+
+        // [a0 a1 a2 a3] -> [a1 a0 a3 a2] (each frame's L and R swapped)
+        static Vec swapPairs(Vec a) noexcept
+        {
+            return _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1));
+        }
+    };
+}
+
+#include "SharcDelayKernelBody.h"
+
+void SharcDelayKernels::detail::processSSE2(SharcRing& ring,
+    const float* inputLeft, const float* inputRight,
+    float* outputLeft, float* outputRight,
+    int numFrames, const SharcKernelParams& params) noexcept
+{
+    processFrames<SSE2Ops>(ring, inputLeft, inputRight, outputLeft, outputRight, numFrames, params);
+}
+
+void SharcDelayKernels::detail::processBankSSE2(SharcBankRing& ring,
+    const float* const* inputs, float* const* outputs,
+    int numFrames, const SharcKernelParams* channelParams) noexcept
+{
+    processBank<SSE2Ops>(ring, inputs, outputs, numFrames, channelParams);
+}
+
+#if defined(__clang__)
+ #pragma clang attribute pop
+#elif defined(__GNUC__)
+ #pragma GCC pop_options
+#endif
+
+#endif // SHARC_KERNELS_X86
@@ -0,0 +1,751 @@
+/*
+  SHARC Echo/Delay Effect Plugin - Delay Line
+  JUCE 8.0.11 - Host-independent DSP core
+
+  Kept free of any AudioProcessor dependency so the benchmark harness
+  (Benchmark/SharcDelayBenchmark.cpp) can drive it without a host.
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <cmath>
+#include "SharcDelayKernels.h"
+#include "SharcRingStorage.h"
+
+//==============================================================================
+// Input-silence / tail-energy tracker. Once the input goes quiet, the
+// ring's content can only decay: it loses the feedback gain once per pass
+// of the delay, starting from at most 0 dB (every SharcSaturation mode
+// keeps writes inside +-1; the feedback filter only takes energy out).
+// After getTailLength() samples of silent input nothing above -120 dB is
+// left on the read path and the owner may skip its kernel entirely.
+//==============================================================================
+class SharcSilenceTracker
+{
+public:
+    static constexpr float threshold = 1.0e-6f;    // -120 dB
+
+    enum class State
+    {
+        running,        // process normally
+        fallingAsleep,  // tail just decayed: clear the ring, then skip
+        asleep          // ring is empty and input still silent: skip
+    };
+
+    // Same unit in as out (samples or seconds). floor: the (linear) level
+    // the ring has decayed below at the end
+    static double getTailLength(double delay, float feedback, float floor = threshold) noexcept
+    {
+        double passes = 1.0;
+
+        if (feedback > floor)
+            passes += std::ceil(std::log(static_cast<double>(floor)) / std::log(static_cast<double>(feedback)));
+
+        return passes * delay;
+    }
+
+    // History was put back into the ring: decay it from the start
+    void wake() noexcept
+    {
+        asleep = false;
+        silentSamples = 0;
+    }
+
+    // Call once per block, before processing. maxDelay / maxFeedback are
+    // the largest values the block will use.
+    State update(const float* const* inputs, int numChannels, int numSamples,
+        double maxDelay, float maxFeedback) noexcept
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const auto range = juce::FloatVectorOperations::findMinAndMax(inputs[ch], numSamples);
+
+            if (juce::jmax(-range.getStart(), range.getEnd()) > threshold)
+            {
+                silentSamples = 0;
+                asleep = false;
+                return State::running;
+            }
+        }
+
+        if (asleep)
+            return State::asleep;
+
+        silentSamples += numSamples;
+
+        if (static_cast<double>(silentSamples) < getTailLength(maxDelay, maxFeedback))
+            return State::running;
+
+        asleep = true;
+        return State::fallingAsleep;
+    }
+
+    // The ring was just cleared: nothing to decay
+    void setAsleep() noexcept
+    {
+        asleep = true;
+        silentSamples = 0;
+    }
+
+    bool isAsleep() const noexcept { return asleep; }
+
+    // Output while asleep: input * dry (the delayed signal is zero)
+    static void applyDry(const float* input, float* output, int numSamples, float dry, float dryStep) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+            output[i] = input[i] * (dry + dryStep * static_cast<float>(i));
+    }
+
+    // Double I/O: wet (float, from the kernels) + input * dry in double.
+    // The ramp starts firstFrame frames into the block.
+    static void addDry(const double* input, const float* wet, double* output, int numSamples,
+        float dry, float dryStep, int firstFrame) noexcept
+    {
+        const double start = static_cast<double>(dry) + static_cast<double>(dryStep) * firstFrame;
+        const double step = dryStep;
+
+        for (int i = 0; i < numSamples; ++i)
+            output[i] = static_cast<double>(wet[i]) + input[i] * (start + step * i);
+    }
+
+private:
+    juce::int64 silentSamples = 0;
+    bool asleep = false;
+};
+
+//==============================================================================
+// SHARC-style Stereo Delay Line (CORRECTED STABLE ALGORITHM)
+// Formula: buffer[w] = input[n] + (feedback * delayed[n-D])
+//          output[n] = (input[n] * dry) + (delayed[n-D] * wet)
+//
+// The write head w walks the whole ring; the read head sits D (fractional)
+// samples behind it and is interpolated (linear, Hermite, Lagrange or
+// allpass). Moving D never changes the wrap point, so history survives
+// delay changes and D can glide tape-style or be modulated.
+//
+// Storage: L/R history is kept as interleaved frames [L0 R0 L1 R1 ...] in a
+// single cache-line aligned block. One stream of lines per sample instead
+// of two. The ring is a power of two long (positions wrap with a mask) and
+// is followed by a small guard region mirroring its first frames, so no
+// read window ever has to be split at the wrap point. SharcRingStorage
+// sizes it for the delay in use and grows it on request (see
+// reserveDelay()), so short delays don't pay for a 5 s buffer.
+//
+// The SIMD path runs whichever SharcDelayKernels variant was resolved for
+// this CPU (see SharcDelayKernels.h). Both paths sleep (dry signal only,
+// no kernel) once the input is silent and the feedback tail has decayed.
+//
+// Long delays are memory-bound: a frame written now is read back seconds
+// later, long after it has left the private caches. Once the shortest read
+// distance reaches setStreamingThreshold(), every block first prefetches
+// the feedback head's read window, so its lines are fetched in parallel
+// instead of one miss at a time as the kernel gets to them. The ring can
+// then also be written with non-temporal stores (setNonTemporalWrites(),
+// vector kernels only): no read-for-ownership and no eviction of the hot
+// working set, but slower on the machines measured so far, so it is off
+// unless the benchmark's memory-bound mode shows a gain.
+//
+// setRingFormat(SharcRingFormat::int16) keeps the history as 16-bit fixed
+// point instead: half the memory (and bandwidth) per second of delay, at
+// about -90 dB of added noise on the echoes. The kernels convert as they
+// load and store, so only the ring changes; the switch is asynchronous and
+// carries the history over, like a growth.
+//
+// Float and double I/O share the same float ring and kernels: a double
+// ring would double the memory and need a second set of kernels for what
+// is an echo path. Double buffers are narrowed ioChunkFrames at a time
+// (the copies stay in L1) and the dry signal is added back in double, so
+// the dry path keeps full 64-bit precision and only the echoes are float.
+//
+// setFreeze() turns the ring into a read-only loop of the last delay's
+// worth of frames: no write, no feedback multiply and no clip, so a frozen
+// line costs one streaming read plus the mix and replays its loop exactly
+// (feedback stays capped at maxFeedback; a loop needs no feedback of 1).
+//==============================================================================
+class SharcDelayLine
+{
+public:
+    static constexpr int numChannels = 2;
+
+    // Shortest delay the vector kernels accept: one AVX-512 step (16 frames)
+    // plus the interpolator's look-ahead must already be written.
+    static constexpr double minDelaySamples = 32.0;
+    static constexpr float maxFeedback = 0.99f;
+
+    // Frames per narrowing step of the double entry points
+    static constexpr int ioChunkFrames = 128;
+
+    // Read distance (in ring bytes) from which a block prefetches (and, if
+    // enabled, streams its writes): past a typical per-core L2
+    static constexpr size_t defaultStreamingThreshold = size_t(1) << 20;
+
+    // Frames prefetched per block, at most: the hardware prefetcher has
+    // picked up the stream by then
+    static constexpr int maxPrefetchFrames = 256;
+
+    // Crossfade at a freeze loop's seam (see sharcFadeLoopSeam), at most
+    // half the loop
+    static constexpr double freezeSeamSeconds = 0.005;
+
+    SharcDelayLine() = default;
+
+    // Allocates; call off the audio thread. The ring is sized for
+    // initialDelaySeconds (default: the maximum) and grows on demand up to
+    // maxDelaySeconds.
+    void prepare(double sRate, float maxDelaySeconds = 5.0f, float initialDelaySeconds = -1.0f)
+    {
+        this->sRate = sRate;
+
+        // Calculate max delay line size
+        maxDelaySamples = static_cast<int>(sRate * maxDelaySeconds);
+        delayLimit = maxDelaySamples;
+
+        const double initial = initialDelaySeconds < 0.0f ? maxDelaySamples
+                                                          : juce::jmin(static_cast<double>(maxDelaySamples), initialDelaySeconds * sRate);
+        storage.prepare(1, numChannels, static_cast<int>(std::ceil(initial)), maxDelaySamples, ringFormat);
+        feedbackFilter.setCutoffs(sRate, feedbackFilter.getLowCut(), feedbackFilter.getHighCut());
+
+        // Resolve the SIMD kernel for this CPU once, up front
+        setKernel(requestedKernel);
+
+        // Zero delay line
+        reset();
+        prepared = true;
+    }
+
+    // Auto, Scalar or a forced ISA. Unsupported ISAs step down to the next
+    // narrower one. Cheap (table lookup) once prepare() has run.
+    void setKernel(SharcKernelIsa requested) noexcept
+    {
+        requestedKernel = requested;
+        activeKernel = SharcDelayKernels::resolve(requested);
+        kernel = SharcDelayKernels::getKernel(activeKernel);
+    }
+
+    SharcKernelIsa getRequestedKernel() const noexcept { return requestedKernel; }
+    SharcKernelIsa getActiveKernel() const noexcept { return activeKernel; }
+
+    // 0 streams every block, SIZE_MAX never (see the class comment)
+    void setStreamingThreshold(size_t bytes) noexcept { streamingThreshold = bytes; }
+    size_t getStreamingThreshold() const noexcept { return streamingThreshold; }
+
+    // Non-temporal ring writes while streaming (off by default)
+    void setNonTemporalWrites(bool shouldStream) noexcept { nonTemporalWrites = shouldStream; }
+    bool getNonTemporalWrites() const noexcept { return nonTemporalWrites; }
+
+    // Whether the last processed block was past the streaming threshold
+    bool isStreaming() const noexcept { return streaming; }
+
+    // Float or 16-bit history. Any thread; once prepared, the ring is
+    // converted on the next adoption (see serviceStorage()).
+    void setRingFormat(SharcRingFormat format) noexcept
+    {
+        ringFormat = format;
+        storage.requestFormat(format);
+    }
+
+    SharcRingFormat getRingFormat() const noexcept { return ringFormat; }
+
+    // Lowers (or restores) the usable maximum without reallocating; capped
+    // at the prepare() maximum
+    void setMaxDelaySeconds(float seconds) noexcept
+    {
+        delayLimit = juce::jlimit(static_cast<int>(minDelaySamples), maxDelaySamples, static_cast<int>(seconds * sRate));
+    }
+
+    // Audio thread: asks for a ring that holds delaySamples (e.g. a glide's
+    // target, ahead of the glide). Grows asynchronously via serviceStorage();
+    // delays are clamped to the current ring until then.
+    void reserveDelay(double delaySamples) noexcept
+    {
+        storage.request(juce::jmin(static_cast<double>(delayLimit), delaySamples));
+    }
+
+    // Message thread: allocates / frees ring memory the audio thread asked
+    // for. Call whenever needsStorageService() was seen true.
+    void serviceStorage() { storage.service(); }
+    bool needsStorageService() const noexcept { return storage.needsService(); }
+
+    // Message thread, audio stopped: returns the ring to SharcMemoryPool.
+    // Processing is a no-op until the next prepare().
+    void releaseStorage() noexcept
+    {
+        prepared = false;
+        storage.release();
+        reset();
+    }
+
+    void setInterpolation(SharcInterpolation mode) noexcept
+    {
+        ramps.interpolation = mode;
+    }
+
+    void setSaturation(SharcSaturation mode) noexcept
+    {
+        ramps.saturation = mode;
+    }
+
+    // Output tap heads (copied). numTaps == 0 hears the feedback head, as
+    // a plain single-tap delay.
+    void setTaps(const SharcTapTable& newTaps) noexcept
+    {
+        taps = newTaps;
+    }
+
+    // Feedback damping in Hz; SharcFeedbackFilter::lowCutOff / highCutOff
+    // switch a side off. Cheap unless a cutoff changed (then one redesign).
+    void setFeedbackFilter(float lowCutHz, float highCutHz) noexcept
+    {
+        if (feedbackFilter.setCutoffs(sRate, lowCutHz, highCutHz))
+            for (auto& state : ring.writeState)
+                std::fill(std::begin(state.filter), std::end(state.filter), 0.0f);
+    }
+
+    // Step changes (no ramp)
+    void setDelaySeconds(float seconds)
+    {
+        reserveDelay(seconds * sRate);
+        ramps.delay = clampDelay(seconds * sRate);
+        ramps.delayStep = 0.0;
+    }
+
+    void setFeedback(float fb)
+    {
+        ramps.feedback = juce::jlimit(0.0f, maxFeedback, fb);
+        ramps.feedbackStep = 0.0f;
+    }
+
+    void setWetMix(float wet)
+    {
+        ramps.wet = juce::jlimit(0.0f, 1.0f, wet);
+        ramps.wetStep = 0.0f;
+    }
+
+    void setDryMix(float dry)
+    {
+        ramps.dry = juce::jlimit(0.0f, 1.0f, dry);
+        ramps.dryStep = 0.0f;
+    }
+
+    // Share of each side's echo fed back into the other (the feedback
+    // matrix, see SharcKernelParams): 0 = independent, 1 = swapped
+    void setCrossFeedback(float cross)
+    {
+        ramps.cross = juce::jlimit(0.0f, 1.0f, cross);
+        ramps.crossStep = 0.0f;
+    }
+
+    // Mono sum into the left side only; with cross feedback at 1, a
+    // ping-pong
+    void setPingPong(bool shouldPingPong) noexcept
+    {
+        ramps.pingPong = shouldPingPong;
+    }
+
+    // Freeze: from the next block the output loops over the last delay's
+    // worth of history (rounded to whole frames, see SharcFreezeLoop), its
+    // seam crossfaded once as it is taken. The ring is then only read, so
+    // the loop neither decays nor clips and the feedback, routing and tap
+    // settings wait until it is released; the input is heard dry only. A
+    // release plays the loop to its end, where the write head stopped,
+    // recording the input over each frame played, and the line carries on
+    // from there: no copy and no jump, and the input echoes on time.
+    void setFreeze(bool shouldFreeze) noexcept { freezeRequested = shouldFreeze; }
+    bool isFrozen() const noexcept { return ring.freeze.isActive(); }
+
+    // Linear ramps (delay in samples) for the next processBlock call only,
+    // see SharcParameterEngine. Values end at start + step * numSamples and
+    // hold there until the next call.
+    void setParameterRamps(const SharcKernelParams& newRamps) noexcept
+    {
+        ramps = newRamps;
+        ramps.feedback = juce::jlimit(0.0f, maxFeedback, ramps.feedback);
+        ramps.cross = juce::jlimit(0.0f, 1.0f, ramps.cross);
+        reserveDelay(ramps.delay);
+        ramps.delay = clampDelay(ramps.delay);
+    }
+
+    // Only the written part of the ring is cleared (dirty high-water mark)
+    void reset()
+    {
+        storage.clear();
+        ring = SharcRing();
+        pointRingAtStorage();
+        ring.filter = &feedbackFilter;
+
+        // Empty ring: nothing to do until the input has signal
+        silence.setAsleep();
+    }
+
+    bool isAsleep() const noexcept { return silence.isAsleep(); }
+
+    // Audio thread: the history the read heads can still reach (the newest
+    // frames, oldest first, as interleaved float), for a state snapshot.
+    // Returns the number of frames written; none while asleep.
+    int copyHistory(float* destination, int maxFrames) const noexcept
+    {
+        if (!prepared || silence.isAsleep())
+            return 0;
+
+        const int numFrames = juce::jmin(maxFrames, storage.getLength(),
+                                         static_cast<int>(std::ceil(ramps.delay)) + SharcRingStorage::tapFrames);
+        storage.readHistory(destination, numFrames, ring.writeIndex);
+        return numFrames;
+    }
+
+    // Audio thread: puts a copyHistory() snapshot back behind the write
+    // head; the tail then decays as if it had never stopped
+    void restoreHistory(const float* source, int numFrames) noexcept
+    {
+        if (!prepared || numFrames <= 0)
+            return;
+
+        storage.writeHistory(source, numFrames, ring.writeIndex);
+        silence.wake();
+    }
+
+    // Scalar version - CORRECTED STABLE FORMULA
+    // Out of place: inputs and outputs must not overlap (in place has its
+    // own overload below)
+    void processBlockScalar(const float* SHARC_RESTRICT inputLeft, const float* SHARC_RESTRICT inputRight,
+        float* SHARC_RESTRICT outputLeft, float* SHARC_RESTRICT outputRight, int numSamples) noexcept
+    {
+        processScalar(inputLeft, inputRight, outputLeft, outputRight, numSamples);
+    }
+
+    // In place: the host buffer is input and output (zero copy)
+    void processBlockScalar(float* left, float* right, int numSamples) noexcept
+    {
+        processScalar(left, right, left, right, numSamples);
+    }
+
+    // SIMD version - runtime-dispatched kernel (no modulo in inner loop!)
+    // The kernel keeps delay-line writes register-aligned; host buffers have
+    // no alignment guarantee and are loaded unaligned. Same in-place /
+    // out-of-place contract as the scalar version.
+    void processBlockSIMD(const float* SHARC_RESTRICT inputLeft, const float* SHARC_RESTRICT inputRight,
+        float* SHARC_RESTRICT outputLeft, float* SHARC_RESTRICT outputRight, int numSamples) noexcept
+    {
+        processSIMD(inputLeft, inputRight, outputLeft, outputRight, numSamples);
+    }
+
+    void processBlockSIMD(float* left, float* right, int numSamples) noexcept
+    {
+        processSIMD(left, right, left, right, numSamples);
+    }
+
+    // 64-bit host buffers, same contract as the float versions
+    void processBlockScalar(const double* SHARC_RESTRICT inputLeft, const double* SHARC_RESTRICT inputRight,
+        double* SHARC_RESTRICT outputLeft, double* SHARC_RESTRICT outputRight, int numSamples) noexcept
+    {
+        processDoubleBlock(inputLeft, inputRight, outputLeft, outputRight, numSamples, false);
+    }
+
+    void processBlockScalar(double* left, double* right, int numSamples) noexcept
+    {
+        processDoubleBlock(left, right, left, right, numSamples, false);
+    }
+
+    void processBlockSIMD(const double* SHARC_RESTRICT inputLeft, const double* SHARC_RESTRICT inputRight,
+        double* SHARC_RESTRICT outputLeft, double* SHARC_RESTRICT outputRight, int numSamples) noexcept
+    {
+        processDoubleBlock(inputLeft, inputRight, outputLeft, outputRight, numSamples, true);
+    }
+
+    void processBlockSIMD(double* left, double* right, int numSamples) noexcept
+    {
+        processDoubleBlock(left, right, left, right, numSamples, true);
+    }
+
+private:
+    // Both entry points end here: outputs are their inputs or disjoint
+    void processScalar(const float* inputLeft, const float* inputRight,
+        float* outputLeft, float* outputRight, int numSamples) noexcept
+    {
+        if (!prepared) return;
+
+        updateStorage();
+
+        if (playFrozen(false, inputLeft, inputRight, outputLeft, outputRight, numSamples))
+            return;
+
+        if (skipSilentBlock(inputLeft, inputRight, outputLeft, outputRight, numSamples))
+            return;
+
+        const auto params = clampedForBlock(numSamples);
+        prepareLongDelay(params, numSamples);
+
+        // The reference loop, specialised per mode (see SharcDelayKernels.cpp)
+        SharcDelayKernels::detail::processScalar(ring, inputLeft, inputRight, outputLeft, outputRight,
+            numSamples, params);
+
+        storage.markWritten(numSamples);
+        finishRamps(numSamples);
+    }
+
+    void processSIMD(const float* inputLeft, const float* inputRight,
+        float* outputLeft, float* outputRight, int numSamples) noexcept
+    {
+        if (!prepared) return;
+
+        updateStorage();
+
+        if (playFrozen(true, inputLeft, inputRight, outputLeft, outputRight, numSamples))
+            return;
+
+        if (skipSilentBlock(inputLeft, inputRight, outputLeft, outputRight, numSamples))
+            return;
+
+        const auto params = clampedForBlock(numSamples);
+        prepareLongDelay(params, numSamples);
+
+        kernel(ring, inputLeft, inputRight, outputLeft, outputRight, numSamples, params);
+
+        storage.markWritten(numSamples);
+        finishRamps(numSamples);
+    }
+
+    // Past the threshold (no read head comes back to a write within that
+    // much history): prefetches the feedback head's 4-tap window for this
+    // block and picks the ring store. Tap heads are left to the hardware
+    // prefetcher; each is one more sequential stream, and prefetching
+    // all of them measured slower.
+    void prepareLongDelay(const SharcKernelParams& params, int numSamples) noexcept
+    {
+        double shortest = params.delay;
+
+        for (int t = 0; t < taps.numTaps; ++t)
+            shortest = juce::jmin(shortest, taps.getDelay(t, params.delay));
+
+        const double bytesPerFrame = numChannels * (ring.format == SharcRingFormat::int16 ? sizeof(int16_t) : sizeof(float));
+        streaming = shortest * bytesPerFrame >= static_cast<double>(streamingThreshold);
+        ring.streamWrites = streaming && nonTemporalWrites;
+
+        if (streaming)
+            sharcPrefetchFrames(ring, ring.writeIndex - static_cast<int>(params.delay) - 2,
+                juce::jmin(numSamples, maxPrefetchFrames) + 4);
+    }
+
+    // Clamped to what the current ring holds until a grown one is adopted
+    double clampDelay(double samples) const noexcept
+    {
+        const int usable = juce::jmax(static_cast<int>(minDelaySamples), juce::jmin(delayLimit, storage.getAvailableDelay()));
+        return juce::jlimit(minDelaySamples, static_cast<double>(usable), samples);
+    }
+
+    void pointRingAtStorage() noexcept
+    {
+        ring.frames = storage.data();
+        ring.compact = storage.compactData();
+        ring.format = storage.getFormat();
+        ring.length = storage.getLength();
+        ring.mask = ring.length - 1;
+    }
+
+    // Adopts a grown (or converted) ring if one is ready (history is
+    // carried over)
+    void updateStorage() noexcept
+    {
+        if (storage.adoptPending(ring.writeIndex))
+            pointRingAtStorage();
+    }
+
+    // Keeps a delay glide inside [minDelaySamples, maxDelaySamples]
+    SharcKernelParams clampedForBlock(int numSamples) const noexcept
+    {
+        auto params = ramps;
+
+        if (params.isDelayMoving() && numSamples > 0)
+        {
+            const double end = clampDelay(params.delay + params.delayStep * numSamples);
+            params.delayStep = (end - params.delay) / numSamples;
+        }
+
+        params.taps = taps.numTaps > 0 ? &taps : nullptr;
+        return params;
+    }
+
+    // Frozen, or asked to be (see setFreeze()): plays the loop and returns
+    // true. Once a release reaches the end of the loop, the rest of the
+    // block runs normally.
+    bool playFrozen(bool simd, const float* inputLeft, const float* inputRight,
+        float* outputLeft, float* outputRight, int numSamples) noexcept
+    {
+        if (freezeRequested && !ring.freeze.isActive())
+        {
+            ring.freeze.length = juce::jlimit(static_cast<int>(minDelaySamples), ring.length, juce::roundToInt(ramps.delay));
+            ring.freeze.phase = 0;
+
+            const int fadeFrames = juce::jmin(juce::roundToInt(sRate * freezeSeamSeconds), ring.freeze.length / 2,
+                                              ring.length - ring.freeze.length);
+
+            if (ring.format == SharcRingFormat::int16)
+                sharcFadeLoopSeam<numChannels>(ring.compact, ring.length, ring.mask, ring.writeIndex, ring.freeze.length, fadeFrames);
+            else
+                sharcFadeLoopSeam<numChannels>(ring.frames, ring.length, ring.mask, ring.writeIndex, ring.freeze.length, fadeFrames);
+        }
+
+        if (!ring.freeze.isActive())
+            return false;
+
+        const int remaining = freezeRequested ? numSamples : (ring.freeze.length - ring.freeze.phase) % ring.freeze.length;
+        const int played = juce::jmin(remaining, numSamples);
+
+        if (played > 0 && freezeRequested)
+            (simd ? kernel : SharcDelayKernels::detail::processScalar)(ring, inputLeft, inputRight,
+                outputLeft, outputRight, played, ramps);
+        else if (played > 0)
+            releaseFrozen(inputLeft, inputRight, outputLeft, outputRight, played);
+
+        if (freezeRequested || ring.freeze.phase != 0)
+        {
+            finishRamps(numSamples);
+            return true;
+        }
+
+        // Back at the write head: at the delay the loop was taken with, the
+        // feedback head reads on from the start of the loop, just as the
+        // loop would have
+        ring.freeze = SharcFreezeLoop();
+        silence.wake();
+
+        if (played == numSamples)
+        {
+            finishRamps(numSamples);
+            return true;
+        }
+
+        ramps = ramps.advancedBy(played);
+
+        if (simd)
+            processSIMD(inputLeft + played, inputRight + played, outputLeft + played, outputRight + played, numSamples - played);
+        else
+            processScalar(inputLeft + played, inputRight + played, outputLeft + played, outputRight + played, numSamples - played);
+
+        return true;
+    }
+
+    // The rest of a released loop, see sharcReleaseFrozenSteps (scalar:
+    // it lasts one loop at most)
+    void releaseFrozen(const float* inputLeft, const float* inputRight,
+        float* outputLeft, float* outputRight, int numSamples) noexcept
+    {
+        const float* inputs[] = { inputLeft, inputRight };
+        float* outputs[] = { outputLeft, outputRight };
+
+        if (ring.format == SharcRingFormat::int16)
+            sharcReleaseFrozenSteps<numChannels>(ring.compact, ring.freeze, ring.length, ring.mask, ring.writeIndex,
+                inputs, outputs, numSamples, ramps, ring.filter, ring.writeState);
+        else
+            sharcReleaseFrozenSteps<numChannels>(ring.frames, ring.freeze, ring.length, ring.mask, ring.writeIndex,
+                inputs, outputs, numSamples, ramps, ring.filter, ring.writeState);
+
+        // A loop reaching back past the ring's start writes frames only a
+        // clear knew about
+        if (ring.writeIndex < ring.freeze.length)
+            storage.markWritten(ring.length);
+
+        ring.freeze.advance(numSamples);
+    }
+
+    // Silent input on a decayed (or empty) ring: dry signal only
+    bool skipSilentBlock(const float* inputLeft, const float* inputRight,
+        float* outputLeft, float* outputRight, int numSamples) noexcept
+    {
+        const float* inputs[] = { inputLeft, inputRight };
+        const auto params = clampedForBlock(numSamples);
+        const auto end = params.at(numSamples);
+
+        const auto state = silence.update(inputs, numChannels, numSamples,
+            juce::jmax(params.delay, end.delay), juce::jmax(params.feedback, end.feedback));
+
+        if (state == SharcSilenceTracker::State::running)
+            return false;
+
+        // What is left is below -120 dB on the current read path, but a
+        // longer delay could still reach older history
+        if (state == SharcSilenceTracker::State::fallingAsleep)
+            reset();
+
+        SharcSilenceTracker::applyDry(inputLeft, outputLeft, numSamples, params.dry, params.dryStep);
+        SharcSilenceTracker::applyDry(inputRight, outputRight, numSamples, params.dry, params.dryStep);
+
+        finishRamps(numSamples);
+        return true;
+    }
+
+    // Each chunk runs the float path on its share of the ramps with the dry
+    // gain at zero (which also selects the cheaper wet-only kernels); the
+    // dry ramp is then applied to the double input
+    void processDoubleBlock(const double* inputLeft, const double* inputRight,
+        double* outputLeft, double* outputRight, int numSamples, bool simd) noexcept
+    {
+        if (!prepared || numSamples <= 0) return;
+
+        const auto blockRamps = ramps;
+        const double* inputs[] = { inputLeft, inputRight };
+        double* outputs[] = { outputLeft, outputRight };
+
+        for (int offset = 0; offset < numSamples; offset += ioChunkFrames)
+        {
+            const int chunk = juce::jmin(ioChunkFrames, numSamples - offset);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                for (int i = 0; i < chunk; ++i)
+                    chunkInput[ch][i] = static_cast<float>(inputs[ch][offset + i]);
+
+            ramps = blockRamps.advancedBy(offset);
+            ramps.dry = ramps.dryStep = 0.0f;
+
+            if (simd)
+                processSIMD(chunkInput[0], chunkInput[1], chunkOutput[0], chunkOutput[1], chunk);
+            else
+                processScalar(chunkInput[0], chunkInput[1], chunkOutput[0], chunkOutput[1], chunk);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                SharcSilenceTracker::addDry(inputs[ch] + offset, chunkOutput[ch], outputs[ch] + offset, chunk,
+                    blockRamps.dry, blockRamps.dryStep, offset);
+        }
+
+        ramps.dry = blockRamps.at(numSamples).dry;
+        ramps.dryStep = 0.0f;
+    }
+
+    void finishRamps(int numSamples) noexcept
+    {
+        if (!ramps.isRamping() && !ramps.isDelayMoving())
+            return;
+
+        ramps = clampedForBlock(numSamples).advancedBy(numSamples);
+        ramps.feedbackStep = ramps.wetStep = ramps.dryStep = ramps.crossStep = 0.0f;
+        ramps.delayStep = 0.0;
+    }
+
+    SharcRingStorage storage;
+    SharcRing ring;
+    SharcFeedbackFilter feedbackFilter;
+    SharcTapTable taps;
+    SharcSilenceTracker silence;
+    int maxDelaySamples = 240000;
+    int delayLimit = 240000;        // setMaxDelaySeconds(), <= maxDelaySamples
+    size_t streamingThreshold = defaultStreamingThreshold;
+    bool nonTemporalWrites = false;
+    bool streaming = false;
+    bool freezeRequested = false;
+    SharcRingFormat ringFormat = SharcRingFormat::float32;
+
+    SharcKernelParams ramps { 0.3f, 0.5f, 0.5f };
+
+    // Narrowed double I/O, one chunk
+    float chunkInput[numChannels][ioChunkFrames];
+    float chunkOutput[numChannels][ioChunkFrames];
+
+    SharcKernelIsa requestedKernel = SharcKernelIsa::automatic;
+    SharcKernelIsa activeKernel = SharcKernelIsa::scalar;
+    SharcKernelFn kernel = SharcDelayKernels::detail::processScalar;
+
+    double sRate = 48000.0;
+    bool prepared = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SharcDelayLine)
+};
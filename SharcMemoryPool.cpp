@@ -0,0 +1,320 @@
+/*
+  SHARC Echo/Delay Effect Plugin - Shared Memory Pool Implementation
+  JUCE 8.0.11
+*/
+
+#include <JuceHeader.h>
+#include "SharcMemoryPool.h"
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#if SHARC_USE_MEMORY_POOL
+ #if JUCE_WINDOWS
+  #include <windows.h>
+ #else
+  #include <sys/mman.h>
+  #include <unistd.h>
+ #endif
+#endif
+
+#if SHARC_USE_MEMORY_POOL
+
+//==============================================================================
+namespace
+{
+    constexpr size_t hugePageSize = size_t(2) << 20;
+
+    // A few instances' worth of rings: enough for the churn of a session
+    // load, small next to what the session itself holds
+    constexpr size_t maxCachedBytes = size_t(16) << 20;
+
+    size_t roundUp(size_t bytes, size_t granularity) noexcept
+    {
+        return (bytes + granularity - 1) / granularity * granularity;
+    }
+
+    size_t getPageSize() noexcept
+    {
+        static const size_t pageSize = []
+        {
+           #if JUCE_WINDOWS
+            SYSTEM_INFO info;
+            GetSystemInfo(&info);
+            return static_cast<size_t>(info.dwPageSize);
+           #else
+            return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+           #endif
+        }();
+
+        return pageSize;
+    }
+
+    // The last bytes of every mapping, past what the caller asked for. The
+    // pool keeps its bookkeeping there, so release() never allocates.
+    struct Trailer
+    {
+        Trailer* next;          // free list, while cached
+        bool onHugePages;
+    };
+
+    // Caller bytes plus the trailer. Blocks of at least one huge page are
+    // rounded to whole huge pages.
+    size_t getMappedSize(size_t bytes) noexcept
+    {
+        const size_t total = bytes + sizeof(Trailer);
+        return roundUp(total, total >= hugePageSize ? hugePageSize : getPageSize());
+    }
+
+    Trailer* getTrailer(void* block, size_t size) noexcept
+    {
+        return reinterpret_cast<Trailer*>(static_cast<char*>(block) + size - sizeof(Trailer));
+    }
+
+    // The block a trailer ends
+    void* getBlock(Trailer* trailer, size_t size) noexcept
+    {
+        return reinterpret_cast<char*>(trailer) + sizeof(Trailer) - size;
+    }
+
+    //==============================================================================
+    // Page-aligned mapping of `bytes` (already rounded), or nullptr. The
+    // OS hands out zero pages; the caller touches them.
+    void* mapPages(size_t bytes, bool& onHugePages) noexcept
+    {
+        onHugePages = false;
+
+       #if JUCE_WINDOWS
+        // Needs SeLockMemoryPrivilege; most machines fall through
+        if (const size_t largePage = GetLargePageMinimum(); largePage != 0 && bytes % largePage == 0)
+        {
+            if (auto* p = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE))
+            {
+                onHugePages = true;
+                return p;
+            }
+        }
+
+        return VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+       #else
+        if (bytes < hugePageSize)
+        {
+            void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            return p == MAP_FAILED ? nullptr : p;
+        }
+
+        // Over-map, then trim to a huge-page boundary so THP can back it
+        const size_t padded = bytes + hugePageSize;
+        void* raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (raw == MAP_FAILED)
+            return nullptr;
+
+        auto* base = static_cast<char*>(raw);
+        auto* aligned = reinterpret_cast<char*>(roundUp(reinterpret_cast<uintptr_t>(base), hugePageSize));
+
+        if (aligned > base)
+            munmap(base, static_cast<size_t>(aligned - base));
+
+        if (const size_t tail = static_cast<size_t>(base + padded - (aligned + bytes)); tail > 0)
+            munmap(aligned + bytes, tail);
+
+       #if defined(MADV_HUGEPAGE)
+        onHugePages = madvise(aligned, bytes, MADV_HUGEPAGE) == 0;
+       #endif
+
+        return aligned;
+       #endif
+    }
+
+    void unmapPages(void* p, size_t bytes) noexcept
+    {
+       #if JUCE_WINDOWS
+        juce::ignoreUnused(bytes);
+        VirtualFree(p, 0, MEM_RELEASE);
+       #else
+        munmap(p, bytes);
+       #endif
+    }
+
+    //==============================================================================
+    // Released blocks wait on one intrusive list per mapped size (a block
+    // size is a ring size, so there are only ever a few)
+    struct FreeList
+    {
+        size_t size = 0;
+        Trailer* first = nullptr;
+    };
+
+    struct Pool
+    {
+        static constexpr int maxFreeLists = 16;
+
+        juce::CriticalSection lock;
+        FreeList freeLists[maxFreeLists];
+        SharcMemoryPool::Stats stats;
+
+        ~Pool()
+        {
+            for (auto& list : freeLists)
+            {
+                while (auto* trailer = list.first)
+                {
+                    list.first = trailer->next;
+                    unmapPages(getBlock(trailer, list.size), list.size);
+                }
+            }
+        }
+
+        // The list for `size`, an empty one to take it over, or null
+        FreeList* findList(size_t size, bool orEmpty) noexcept
+        {
+            FreeList* empty = nullptr;
+
+            for (auto& list : freeLists)
+            {
+                if (list.first != nullptr && list.size == size)
+                    return &list;
+
+                if (list.first == nullptr && empty == nullptr)
+                    empty = &list;
+            }
+
+            if (orEmpty && empty != nullptr)
+                empty->size = size;
+
+            return orEmpty ? empty : nullptr;
+        }
+
+        void unmap(void* block, size_t size, bool onHugePages) noexcept
+        {
+            unmapPages(block, size);
+            stats.mappedBytes -= size;
+
+            if (onHugePages)
+                stats.hugePageBytes -= size;
+        }
+    };
+
+    Pool& getPool()
+    {
+        static Pool pool;
+        return pool;
+    }
+}
+
+//==============================================================================
+void* SharcMemoryPool::allocate(size_t bytes)
+{
+    const size_t size = getMappedSize(juce::jmax(bytes, size_t(1)));
+    auto& pool = getPool();
+    void* block = nullptr;
+    bool onHugePages = false;
+
+    {
+        const juce::ScopedLock sl(pool.lock);
+
+        if (auto* list = pool.findList(size, false))
+        {
+            auto* trailer = list->first;
+            list->first = trailer->next;
+            block = getBlock(trailer, size);
+            onHugePages = trailer->onHugePages;
+            pool.stats.cachedBytes -= size;
+        }
+    }
+
+    if (block == nullptr)
+    {
+        block = mapPages(size, onHugePages);
+
+        if (block == nullptr)
+            throw std::bad_alloc();
+
+        const juce::ScopedLock sl(pool.lock);
+        pool.stats.mappedBytes += size;
+
+        if (onHugePages)
+            pool.stats.hugePageBytes += size;
+    }
+
+    // Zero (reused blocks) and pre-fault (fresh ones) here, not on the
+    // audio thread's first write
+    std::memset(block, 0, size - sizeof(Trailer));
+    *getTrailer(block, size) = { nullptr, onHugePages };
+
+    const juce::ScopedLock sl(pool.lock);
+    ++pool.stats.blocksInUse;
+    return block;
+}
+
+void SharcMemoryPool::release(void* block, size_t bytes) noexcept
+{
+    if (block == nullptr)
+        return;
+
+    const size_t size = getMappedSize(juce::jmax(bytes, size_t(1)));
+    auto& pool = getPool();
+    auto* trailer = getTrailer(block, size);
+    const juce::ScopedLock sl(pool.lock);
+    --pool.stats.blocksInUse;
+
+    if (pool.stats.cachedBytes + size <= maxCachedBytes)
+    {
+        if (auto* list = pool.findList(size, true))
+        {
+            trailer->next = list->first;
+            list->first = trailer;
+            pool.stats.cachedBytes += size;
+            return;
+        }
+    }
+
+    pool.unmap(block, size, trailer->onHugePages);
+}
+
+void SharcMemoryPool::trim() noexcept
+{
+    auto& pool = getPool();
+    const juce::ScopedLock sl(pool.lock);
+
+    for (auto& list : pool.freeLists)
+    {
+        while (auto* trailer = list.first)
+        {
+            list.first = trailer->next;
+            pool.unmap(getBlock(trailer, list.size), list.size, trailer->onHugePages);
+        }
+    }
+
+    pool.stats.cachedBytes = 0;
+}
+
+SharcMemoryPool::Stats SharcMemoryPool::getStats() noexcept
+{
+    auto& pool = getPool();
+    const juce::ScopedLock sl(pool.lock);
+    return pool.stats;
+}
+
+#else
+
+//==============================================================================
+// Pool disabled: plain cache-line aligned heap blocks
+void* SharcMemoryPool::allocate(size_t bytes)
+{
+    void* block = ::operator new(juce::jmax(bytes, size_t(1)), std::align_val_t(64));
+    std::memset(block, 0, bytes);
+    return block;
+}
+
+void SharcMemoryPool::release(void* block, size_t) noexcept
+{
+    ::operator delete(block, std::align_val_t(64));
+}
+
+void SharcMemoryPool::trim() noexcept {}
+
+SharcMemoryPool::Stats SharcMemoryPool::getStats() noexcept { return {}; }
+
+#endif
@@ -0,0 +1,55 @@
+/*
+  SHARC Echo/Delay Effect Plugin - Shared Memory Pool
+  JUCE 8.0.11 - Process-wide, page-aligned delay memory
+
+  Every plugin instance in the process draws its delay rings
+  (SharcRingStorage blocks) from one pool instead of the general heap.
+  Blocks are mapped straight from the OS, page aligned, and on huge pages
+  where the platform allows (Linux THP, Windows large pages), which helps
+  TLB reach on sessions with hundreds of instances. Blocks that are
+  released go to a per-size cache, so instance churn while a session
+  loads reuses memory instead of fragmenting the heap. The cache is
+  small (16 MB); anything past it goes straight back to the OS. The
+  pool's bookkeeping lives in a trailer at the end of each block, so it
+  never allocates node memory of its own and release() cannot fail.
+
+  Returned blocks are zeroed and already touched (pre-faulted), so the
+  audio thread never takes a first-touch page fault on them.
+
+  Any thread but a realtime audio thread: allocate/release may map memory
+  and take the pool's lock. Rings are grown by the message thread, and
+  inline by offline renders (the render thread, or a render-pool worker
+  for its channel group), so calls can come from several threads at once.
+  Build with SHARC_USE_MEMORY_POOL=0 to fall back to aligned operator new.
+*/
+
+#pragma once
+#include <cstddef>
+
+#ifndef SHARC_USE_MEMORY_POOL
+ #define SHARC_USE_MEMORY_POOL 1
+#endif
+
+namespace SharcMemoryPool
+{
+    // At least `bytes` of zeroed memory, aligned to at least a cache line
+    // (a page when pooled). Throws std::bad_alloc on failure.
+    void* allocate(size_t bytes);
+
+    // `bytes` must be the value passed to allocate()
+    void release(void* block, size_t bytes) noexcept;
+
+    // Unmaps every cached (unused) block, e.g. before measuring with
+    // getStats()
+    void trim() noexcept;
+
+    struct Stats
+    {
+        size_t mappedBytes = 0;     // held from the OS, in use or cached
+        size_t cachedBytes = 0;     // released, waiting for reuse
+        size_t hugePageBytes = 0;   // part of mappedBytes on huge pages
+        int blocksInUse = 0;
+    };
+
+    Stats getStats() noexcept;
+}
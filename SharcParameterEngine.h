@@ -0,0 +1,293 @@
+/*
+  SHARC Echo/Delay Effect Plugin - Parameter Engine
+  JUCE 8.0.11 - Allocation-free, lock-free parameter smoothing
+
+  Resolves the APVTS atomics once at construction, so the audio thread
+  never does a string lookup. Once per block it advances a linear
+  smoother for feedback, wet and dry and turns it into a start value plus
+  a per-sample slope (SharcKernelParams). The kernels apply that ramp
+  branch-free, which removes the zipper noise from block-rate steps.
+  Cross feedback is ramped the same way; ping-pong and freeze switch at
+  the block.
+
+  Delay time gets a longer ramp of its own: the read head glides to the
+  new time (tape-style pitch bend) instead of jumping. Bypass is ramped
+  too, so the processor can crossfade instead of clicking.
+
+  The feedback filter cutoffs glide multiplicatively (even speed per
+  octave) and are sampled once per block; the delay line redesigns its
+  filter only while they move.
+
+  With tempo sync on, the delay target is a note division of the host
+  tempo (setHostTempo(), once per host buffer) and glides like any other
+  delay change. The tap table is rebuilt per block from the per-tap
+  time / gain / pan parameters; the default single tap at the full delay
+  is left out, so the plain echo keeps its cheaper path.
+
+  During offline renders (setOfflineRender()) with "HQ Render" on, Linear
+  interpolation is raised to Hermite and Soft saturation to Soft 2x. The
+  other modes are a choice of sound, not of quality, and are kept.
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "SharcDelayKernels.h"
+
+//==============================================================================
+class SharcParameterEngine
+{
+public:
+    struct BlockParameters
+    {
+        SharcKernelParams ramps;    // delay in samples
+        double delayTarget;         // where the delay glide is heading (samples)
+        float maxDelaySeconds;
+        float lowCutHz;             // feedback filter, see SharcFeedbackFilter
+        float highCutHz;
+        SharcTapTable taps;         // numTaps == 0: the feedback head only
+        bool freeze;                // see SharcDelayLine::setFreeze()
+        bool bypass;                // target state
+        float bypassFade;           // 0 = processed, 1 = bypassed (input only)
+        float bypassFadeStep;
+        SharcKernelIsa kernel;
+        SharcRingFormat ringFormat;
+
+        bool isFading() const noexcept { return bypassFade != 0.0f || bypassFadeStep != 0.0f; }
+        bool isFullyBypassed() const noexcept { return bypass && bypassFade >= 1.0f && bypassFadeStep == 0.0f; }
+    };
+
+    explicit SharcParameterEngine(juce::AudioProcessorValueTreeState& apvts)
+        : delay(getParameter(apvts, "delay")),
+          maxDelay(getParameter(apvts, "maxdelay")),
+          feedback(getParameter(apvts, "feedback")),
+          cross(getParameter(apvts, "cross")),
+          pingPong(getParameter(apvts, "pingpong")),
+          freeze(getParameter(apvts, "freeze")),
+          wet(getParameter(apvts, "wet")),
+          dry(getParameter(apvts, "dry")),
+          bypass(getParameter(apvts, "bypass")),
+          simd(getParameter(apvts, "mode")),
+          interp(getParameter(apvts, "interp")),
+          saturation(getParameter(apvts, "sat")),
+          lowCut(getParameter(apvts, "lowcut")),
+          highCut(getParameter(apvts, "highcut")),
+          sync(getParameter(apvts, "sync")),
+          division(getParameter(apvts, "division")),
+          numTaps(getParameter(apvts, "taps")),
+          renderHq(getParameter(apvts, "renderhq")),
+          memory(getParameter(apvts, "memory"))
+    {
+        for (int i = 0; i < SharcTapTable::maxTaps; ++i)
+        {
+            const auto prefix = "tap" + juce::String(i + 1);
+            tapTime[i] = &getParameter(apvts, (prefix + "time").toRawUTF8());
+            tapGain[i] = &getParameter(apvts, (prefix + "gain").toRawUTF8());
+            tapPan[i] = &getParameter(apvts, (prefix + "pan").toRawUTF8());
+        }
+    }
+
+    // Note values of the "division" choice, in quarter notes
+    static constexpr int numDivisions = 14;
+    static constexpr double divisionBeats[numDivisions] = {
+        0.125, 1.0 / 6.0, 0.25, 0.375, 1.0 / 3.0, 0.5, 0.75,
+        2.0 / 3.0, 1.0, 1.5, 4.0 / 3.0, 2.0, 3.0, 4.0
+    };
+
+    static juce::StringArray getDivisionNames()
+    {
+        return { "1/32", "1/16T", "1/16", "1/16D", "1/8T", "1/8", "1/8D",
+                 "1/4T", "1/4", "1/4D", "1/2T", "1/2", "1/2D", "1/1" };
+    }
+
+    // Host tempo for sync; 0 (unknown) falls back to the free delay time
+    void setHostTempo(double bpm) noexcept { hostBpm = bpm > 0.0 ? bpm : 0.0; }
+
+    // isNonRealtime(), once per host buffer
+    void setOfflineRender(bool offline) noexcept { offlineRender = offline; }
+
+    // Jumps every smoother to its current value (no ramp after a reset)
+    void prepare(double sampleRate, double rampSeconds = 0.05, double delayGlideSeconds = 0.25)
+    {
+        currentSampleRate = sampleRate;
+
+        for (auto* smoother : { &feedbackSmoother, &crossSmoother, &wetSmoother, &drySmoother, &bypassSmoother })
+            smoother->reset(sampleRate, rampSeconds);
+
+        for (auto* smoother : { &lowCutSmoother, &highCutSmoother })
+            smoother->reset(sampleRate, rampSeconds);
+
+        for (int i = 0; i < SharcTapTable::maxTaps; ++i)
+        {
+            for (auto* smoother : { &tapTimeSmoother[i], &tapGainSmoother[i], &tapPanSmoother[i] })
+                smoother->reset(sampleRate, rampSeconds);
+
+            tapTimeSmoother[i].setCurrentAndTargetValue(tapTime[i]->load());
+            tapGainSmoother[i].setCurrentAndTargetValue(tapGain[i]->load());
+            tapPanSmoother[i].setCurrentAndTargetValue(tapPan[i]->load());
+        }
+
+        delaySmoother.reset(sampleRate, delayGlideSeconds);
+        delaySmoother.setCurrentAndTargetValue(getDelayTarget());
+
+        feedbackSmoother.setCurrentAndTargetValue(feedback.load());
+        crossSmoother.setCurrentAndTargetValue(cross.load());
+        wetSmoother.setCurrentAndTargetValue(wet.load());
+        drySmoother.setCurrentAndTargetValue(dry.load());
+        bypassSmoother.setCurrentAndTargetValue(bypass.load() > 0.5f ? 1.0f : 0.0f);
+        lowCutSmoother.setCurrentAndTargetValue(lowCut.load());
+        highCutSmoother.setCurrentAndTargetValue(highCut.load());
+    }
+
+    // Reads the latest host values and advances the smoothers by one block
+    BlockParameters nextBlock(int numSamples) noexcept
+    {
+        BlockParameters block;
+        block.bypass = bypass.load() > 0.5f;
+        block.kernel = static_cast<SharcKernelIsa>(juce::roundToInt(simd.load()));
+        block.ringFormat = static_cast<SharcRingFormat>(juce::roundToInt(memory.load()));
+        block.ramps.interpolation = static_cast<SharcInterpolation>(juce::roundToInt(interp.load()));
+        block.ramps.saturation = static_cast<SharcSaturation>(juce::roundToInt(saturation.load()));
+        block.ramps.pingPong = pingPong.load() > 0.5f;
+        block.freeze = freeze.load() > 0.5f;
+
+        if (offlineRender && renderHq.load() > 0.5f)
+            raiseRenderQuality(block.ramps);
+
+        rampOverBlock(feedbackSmoother, feedback.load(), numSamples, block.ramps.feedback, block.ramps.feedbackStep);
+        rampOverBlock(crossSmoother, cross.load(), numSamples, block.ramps.cross, block.ramps.crossStep);
+        rampOverBlock(wetSmoother, wet.load(), numSamples, block.ramps.wet, block.ramps.wetStep);
+        rampOverBlock(drySmoother, dry.load(), numSamples, block.ramps.dry, block.ramps.dryStep);
+        rampOverBlock(bypassSmoother, block.bypass ? 1.0f : 0.0f, numSamples, block.bypassFade, block.bypassFadeStep);
+        block.maxDelaySeconds = maxDelay.load();
+        block.lowCutHz = advance(lowCutSmoother, lowCut.load(), numSamples);
+        block.highCutHz = advance(highCutSmoother, highCut.load(), numSamples);
+        block.delayTarget = getDelayTarget();
+        rampOverBlock(delaySmoother, block.delayTarget, numSamples, block.ramps.delay, block.ramps.delayStep);
+        nextTaps(block.taps, numSamples);
+
+        return block;
+    }
+
+private:
+    // Delay never glides past the "Max Delay" limit
+    double getDelayTarget() const noexcept
+    {
+        double seconds = delay.load();
+
+        if (sync.load() > 0.5f && hostBpm > 0.0)
+        {
+            const int index = juce::jlimit(0, numDivisions - 1, juce::roundToInt(division.load()));
+            seconds = divisionBeats[index] * 60.0 / hostBpm;
+        }
+
+        return juce::jmin(seconds, static_cast<double>(maxDelay.load())) * currentSampleRate;
+    }
+
+    static void raiseRenderQuality(SharcKernelParams& ramps) noexcept
+    {
+        if (ramps.interpolation == SharcInterpolation::linear)
+            ramps.interpolation = SharcInterpolation::hermite;
+
+        if (ramps.saturation == SharcSaturation::soft)
+            ramps.saturation = SharcSaturation::soft2x;
+    }
+
+    // Block-start values, like the cutoffs. Unused taps keep smoothing, so
+    // a tap that is switched on starts at its current setting
+    void nextTaps(SharcTapTable& taps, int numSamples) noexcept
+    {
+        const int count = juce::jlimit(1, SharcTapTable::maxTaps, juce::roundToInt(numTaps.load()));
+        taps.numTaps = count;
+
+        for (int i = 0; i < SharcTapTable::maxTaps; ++i)
+        {
+            const float ratio = advance(tapTimeSmoother[i], tapTime[i]->load(), numSamples);
+            const float gain = advance(tapGainSmoother[i], tapGain[i]->load(), numSamples);
+            const float pan = advance(tapPanSmoother[i], tapPan[i]->load(), numSamples);
+
+            if (i < count)
+                taps.setTap(i, ratio, gain, pan);
+        }
+
+        const bool plainEcho = count == 1 && taps.ratio[0] == 1.0f && taps.gain[0] == 1.0f
+                            && taps.gainLeft[0] == 1.0f && taps.gainRight[0] == 1.0f;
+
+        if (plainEcho)
+            taps.numTaps = 0;
+    }
+
+    template <typename FloatType>
+    using Smoother = juce::SmoothedValue<FloatType, juce::ValueSmoothingTypes::Linear>;
+    using FrequencySmoother = juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative>;
+
+    static std::atomic<float>& getParameter(juce::AudioProcessorValueTreeState& apvts, const char* paramID)
+    {
+        auto* value = apvts.getRawParameterValue(paramID);
+        jassert(value != nullptr); // parameter missing from createParameterLayout()
+        return *value;
+    }
+
+    // The smoother is linear, so (end - start) / numSamples is exact unless
+    // the ramp finishes mid-block, where it is a close approximation.
+    template <typename FloatType>
+    static void rampOverBlock(Smoother<FloatType>& smoother, FloatType target, int numSamples,
+        FloatType& start, FloatType& step) noexcept
+    {
+        smoother.setTargetValue(target);
+        start = smoother.getCurrentValue();
+
+        if (!smoother.isSmoothing() || numSamples <= 0)
+        {
+            step = 0;
+            return;
+        }
+
+        const FloatType end = smoother.skip(numSamples);
+        step = (end - start) / static_cast<FloatType>(numSamples);
+    }
+
+    // Value at the start of the block (the filter is redesigned per block)
+    template <typename SmootherType>
+    static float advance(SmootherType& smoother, float target, int numSamples) noexcept
+    {
+        smoother.setTargetValue(target);
+        const float current = smoother.getCurrentValue();
+        smoother.skip(numSamples);
+        return current;
+    }
+
+    std::atomic<float>& delay;
+    std::atomic<float>& maxDelay;
+    std::atomic<float>& feedback;
+    std::atomic<float>& cross;
+    std::atomic<float>& pingPong;
+    std::atomic<float>& freeze;
+    std::atomic<float>& wet;
+    std::atomic<float>& dry;
+    std::atomic<float>& bypass;
+    std::atomic<float>& simd;
+    std::atomic<float>& interp;
+    std::atomic<float>& saturation;
+    std::atomic<float>& lowCut;
+    std::atomic<float>& highCut;
+    std::atomic<float>& sync;
+    std::atomic<float>& division;
+    std::atomic<float>& numTaps;
+    std::atomic<float>& renderHq;
+    std::atomic<float>& memory;
+    std::atomic<float>* tapTime[SharcTapTable::maxTaps];
+    std::atomic<float>* tapGain[SharcTapTable::maxTaps];
+    std::atomic<float>* tapPan[SharcTapTable::maxTaps];
+
+    Smoother<float> feedbackSmoother, crossSmoother, wetSmoother, drySmoother, bypassSmoother;
+    FrequencySmoother lowCutSmoother, highCutSmoother;
+    Smoother<float> tapTimeSmoother[SharcTapTable::maxTaps];
+    Smoother<float> tapGainSmoother[SharcTapTable::maxTaps];
+    Smoother<float> tapPanSmoother[SharcTapTable::maxTaps];
+    Smoother<double> delaySmoother;     // in samples
+    double currentSampleRate = 48000.0;
+    double hostBpm = 0.0;
+    bool offlineRender = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SharcParameterEngine)
+};
@@ -0,0 +1,263 @@
+/*
+  SHARC Echo/Delay Effect Plugin - DSP Profiler
+  JUCE 8.0.11 - Per-stage block timings as lock-free histograms
+
+  processBlock times its stages with steady_clock (parameter schedule,
+  delay DSP + bypass crossfade, telemetry + metering), summed over its
+  sub-blocks, and hands them to record(). Each stage, and the whole
+  block, goes into a histogram per
+  block-size class (<= 32, 64, ... 8192, larger): log-spaced buckets a
+  quarter octave wide (~19% resolution) from 64 ns to ~1 s, plus the exact
+  maximum. Percentiles come from the buckets, so p50 / p99 are accurate to
+  a bucket; max is exact, which is what finds the xrun outliers.
+
+  The audio thread is the only writer: relaxed loads and stores, no RMW,
+  no lock. Readers (editor, export) may see a block half-recorded, which
+  only skews a count by one. reset() is a request the audio thread
+  carries out at the start of its next block.
+
+  Builds with SHARC_REALTIME_CHECKS also carry the realtime safety
+  report (SharcRealtimeChecker.h); it is reset and exported with the
+  timings.
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "SharcRealtimeChecker.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+//==============================================================================
+class SharcProfiler
+{
+public:
+    enum class Stage
+    {
+        parameters = 0,     // sub-block parameter schedule
+        dsp,                // delay line / bank, bypass crossfade
+        output,             // storage requests, telemetry, CPU meter
+        total,
+        numStages
+    };
+
+    static constexpr int numStages = static_cast<int>(Stage::numStages);
+    static constexpr int numBlockSizeClasses = 10;   // 32 << c samples
+    static constexpr int numBuckets = 96;
+    static constexpr int minimumNanos = 64;
+
+    using Clock = std::chrono::steady_clock;
+    static Clock::time_point now() noexcept { return Clock::now(); }
+
+    struct Summary
+    {
+        uint64_t count = 0;
+        double p50 = 0.0, p99 = 0.0, max = 0.0;   // microseconds
+    };
+
+    SharcProfiler() { clear(); }
+
+    //==============================================================================
+    // Audio thread: one call per host block, with the time spent in every
+    // stage except total (which is their sum)
+    void record(int numSamples, const Clock::duration (&stageTimes)[numStages - 1]) noexcept
+    {
+        if (resetRequested.load(std::memory_order_acquire))
+        {
+            clear();
+            resetRequested.store(false, std::memory_order_relaxed);
+        }
+
+        const int c = getBlockSizeClass(numSamples);
+        lastBlockSizeClass.store(c, std::memory_order_relaxed);
+
+        int64_t totalNanos = 0;
+
+        for (int s = 0; s < numStages - 1; ++s)
+        {
+            const auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(stageTimes[s]).count();
+            add(histograms[static_cast<size_t>(s * numBlockSizeClasses + c)], nanos);
+            totalNanos += nanos;
+        }
+
+        add(histograms[static_cast<size_t>(static_cast<int>(Stage::total) * numBlockSizeClasses + c)], totalNanos);
+    }
+
+    // Any thread: cleared by the audio thread before its next record()
+    void reset() noexcept
+    {
+        resetRequested.store(true, std::memory_order_release);
+        realtimeChecker.reset();
+    }
+
+    // Allocations and locks inside processBlock (SHARC_REALTIME_CHECKS builds)
+    SharcRealtimeChecker& getRealtimeChecker() noexcept { return realtimeChecker; }
+    const SharcRealtimeChecker& getRealtimeChecker() const noexcept { return realtimeChecker; }
+
+    //==============================================================================
+    // Any thread
+    Summary getSummary(Stage stage, int blockSizeClass) const noexcept
+    {
+        const auto& h = histograms[static_cast<size_t>(static_cast<int>(stage) * numBlockSizeClasses
+                                                       + juce::jlimit(0, numBlockSizeClasses - 1, blockSizeClass))];
+        std::array<uint32_t, numBuckets> counts;
+        uint64_t count = 0;
+
+        for (int b = 0; b < numBuckets; ++b)
+            count += counts[static_cast<size_t>(b)] = h.buckets[static_cast<size_t>(b)].load(std::memory_order_relaxed);
+
+        Summary summary;
+        summary.count = count;
+        summary.max = static_cast<double>(h.maxNanos.load(std::memory_order_relaxed)) * 1.0e-3;
+
+        if (count == 0)
+            return summary;
+
+        summary.p50 = juce::jmin(summary.max, percentile(counts, count, 0.50));
+        summary.p99 = juce::jmin(summary.max, percentile(counts, count, 0.99));
+        return summary;
+    }
+
+    // Class of the block size the host is using right now
+    int getLastBlockSizeClass() const noexcept { return lastBlockSizeClass.load(std::memory_order_relaxed); }
+
+    static int getBlockSizeClass(int numSamples) noexcept
+    {
+        const int n = juce::jmax(1, numSamples - 1);
+        return juce::jlimit(0, numBlockSizeClasses - 1, juce::findHighestSetBit(static_cast<juce::uint32>(n)) - 4);
+    }
+
+    static int getBlockSizeForClass(int blockSizeClass) noexcept { return 32 << blockSizeClass; }
+
+    // "512", or ">8192" for the last class
+    static juce::String getBlockSizeLabel(int blockSizeClass)
+    {
+        if (blockSizeClass >= numBlockSizeClasses - 1)
+            return ">" + juce::String(getBlockSizeForClass(numBlockSizeClasses - 2));
+
+        return juce::String(getBlockSizeForClass(blockSizeClass));
+    }
+
+    static const char* getStageName(Stage stage) noexcept
+    {
+        switch (stage)
+        {
+            case Stage::parameters: return "parameters";
+            case Stage::dsp:        return "dsp";
+            case Stage::output:     return "output";
+            case Stage::total:      return "total";
+            case Stage::numStages:  break;
+        }
+
+        return "";
+    }
+
+    //==============================================================================
+    // CSV, one row per stage and block-size class that saw any block (then
+    // the realtime safety report, if checked)
+    juce::String toCsv() const
+    {
+        juce::String csv("stage,block_size,count,p50_us,p99_us,max_us\n");
+
+        for (int s = 0; s < numStages; ++s)
+        {
+            for (int c = 0; c < numBlockSizeClasses; ++c)
+            {
+                const auto summary = getSummary(static_cast<Stage>(s), c);
+
+                if (summary.count == 0)
+                    continue;
+
+                csv << getStageName(static_cast<Stage>(s)) << ","
+                    << getBlockSizeLabel(c) << ","
+                    << juce::String(static_cast<juce::int64>(summary.count)) << ","
+                    << juce::String(summary.p50, 3) << ","
+                    << juce::String(summary.p99, 3) << ","
+                    << juce::String(summary.max, 3) << "\n";
+            }
+        }
+
+        if (SharcRealtimeChecker::isEnabled())
+            csv << "\n" << realtimeChecker.toCsv();
+
+        return csv;
+    }
+
+    bool exportCsv(const juce::File& file) const { return file.replaceWithText(toCsv()); }
+
+private:
+    struct Histogram
+    {
+        std::array<std::atomic<uint32_t>, numBuckets> buckets;
+        std::atomic<int64_t> maxNanos;
+    };
+
+    // Quarter-octave buckets: 0 below minimumNanos, then 4 per power of two
+    static int getBucket(int64_t nanos) noexcept
+    {
+        if (nanos < minimumNanos)
+            return 0;
+
+        const auto n = static_cast<juce::uint32>(juce::jmin(nanos, static_cast<int64_t>(0xffffffff)));
+        const int octave = juce::findHighestSetBit(n);
+        const int quarter = static_cast<int>((n >> (octave - 2)) & 3);
+
+        return juce::jmin(numBuckets - 1, 1 + (octave - 6) * 4 + quarter);
+    }
+
+    // Upper edge of a bucket, microseconds
+    static double getBucketLimit(int bucket) noexcept
+    {
+        if (bucket == 0)
+            return minimumNanos * 1.0e-3;
+
+        const int octave = (bucket - 1) / 4 + 6;
+        const int quarter = (bucket - 1) % 4;
+        return std::ldexp(static_cast<double>(5 + quarter), octave - 2) * 1.0e-3;
+    }
+
+    static double percentile(const std::array<uint32_t, numBuckets>& counts, uint64_t total, double q) noexcept
+    {
+        const auto rank = static_cast<uint64_t>(std::ceil(q * static_cast<double>(total)));
+        uint64_t seen = 0;
+
+        for (int b = 0; b < numBuckets; ++b)
+        {
+            seen += counts[static_cast<size_t>(b)];
+
+            if (seen >= rank)
+                return getBucketLimit(b);
+        }
+
+        return getBucketLimit(numBuckets - 1);
+    }
+
+    static void add(Histogram& h, int64_t nanos) noexcept
+    {
+        auto& bucket = h.buckets[static_cast<size_t>(getBucket(nanos))];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+        if (nanos > h.maxNanos.load(std::memory_order_relaxed))
+            h.maxNanos.store(nanos, std::memory_order_relaxed);
+    }
+
+    void clear() noexcept
+    {
+        for (auto& h : histograms)
+        {
+            for (auto& bucket : h.buckets)
+                bucket.store(0, std::memory_order_relaxed);
+
+            h.maxNanos.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    std::array<Histogram, static_cast<size_t>(numStages * numBlockSizeClasses)> histograms;
+    std::atomic<int> lastBlockSizeClass { 4 };
+    std::atomic<bool> resetRequested { false };
+    SharcRealtimeChecker realtimeChecker;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SharcProfiler)
+};
@@ -0,0 +1,324 @@
+/*
+  SHARC Echo/Delay Effect Plugin - Realtime Safety Checker (hooks)
+  JUCE 8.0.11 - See SharcRealtimeChecker.h; empty unless SHARC_REALTIME_CHECKS
+
+  Every hook counts, then forwards to the C library, or for the heap to
+  the allocator the host runs on. The per-thread state is initial-exec
+  TLS (two words), so reading it from inside malloc never allocates.
+  Nothing here may allocate, lock or log.
+*/
+
+#include "SharcRealtimeChecker.h"
+
+#if SHARC_REALTIME_CHECKS
+
+#include <cstdlib>
+#include <new>
+
+#if JUCE_LINUX || JUCE_BSD || JUCE_MAC
+ #include <dlfcn.h>
+ #include <pthread.h>
+ #define SHARC_HOOK_PTHREADS 1
+#else
+ #define SHARC_HOOK_PTHREADS 0
+#endif
+
+// malloc itself is only replaced on glibc
+#if defined(__GLIBC__)
+ #define SHARC_HOOK_MALLOC 1
+#else
+ #define SHARC_HOOK_MALLOC 0
+#endif
+
+#if defined(__GNUC__)
+ #define SHARC_THREAD_LOCAL __attribute__((tls_model("initial-exec"))) thread_local
+#else
+ #define SHARC_THREAD_LOCAL thread_local
+#endif
+
+// ELF: the hooks must be hidden, or the host's C and C++ runtimes (first
+// in the lookup order) would take the plugin's own calls, and another
+// binary could take ours. The headers have already declared these with
+// default visibility, which an attribute can't change; the assembler can.
+// Mach-O and PE bind a binary's calls to its own definitions as it is.
+#if (JUCE_LINUX || JUCE_BSD) && defined(__LP64__)
+__asm__(".hidden _Znwm\n .hidden _Znam\n .hidden _ZnwmSt11align_val_t\n .hidden _ZnamSt11align_val_t\n"
+        ".hidden _ZnwmRKSt9nothrow_t\n .hidden _ZnamRKSt9nothrow_t\n"
+        ".hidden _ZdlPv\n .hidden _ZdaPv\n .hidden _ZdlPvm\n .hidden _ZdaPvm\n"
+        ".hidden _ZdlPvRKSt9nothrow_t\n .hidden _ZdaPvRKSt9nothrow_t\n"
+        ".hidden _ZdlPvSt11align_val_t\n .hidden _ZdaPvSt11align_val_t\n"
+        ".hidden _ZdlPvmSt11align_val_t\n .hidden _ZdaPvmSt11align_val_t\n"
+        ".hidden malloc\n .hidden calloc\n .hidden realloc\n .hidden free\n"
+        ".hidden pthread_mutex_lock\n .hidden pthread_rwlock_rdlock\n .hidden pthread_rwlock_wrlock\n"
+        ".hidden pthread_cond_wait\n .hidden pthread_cond_timedwait");
+#elif JUCE_LINUX || JUCE_BSD
+ #error "SHARC_REALTIME_CHECKS: hide the operator new / delete hooks for this ABI"
+#endif
+
+namespace
+{
+    SHARC_THREAD_LOCAL SharcRealtimeChecker* currentChecker = nullptr;
+    SHARC_THREAD_LOCAL int currentSource = static_cast<int>(SharcRealtimeChecker::Source::dsp);
+
+   #if SHARC_HOOK_PTHREADS
+    // The real function, looked up on first use (dlsym allocates nothing
+    // through these hooks: they are hidden, its calls go to the host's)
+    template <typename Function>
+    Function next(std::atomic<Function>& slot, const char* name, void* handle = RTLD_NEXT) noexcept
+    {
+        auto function = slot.load(std::memory_order_acquire);
+
+        if (function == nullptr)
+        {
+            function = reinterpret_cast<Function>(dlsym(handle, name));
+            slot.store(function, std::memory_order_release);
+        }
+
+        return function;
+    }
+   #endif
+
+   #if SHARC_HOOK_MALLOC
+    // The allocator the host runs on, which may be jemalloc or tcmalloc
+    // rather than the C library's: buffers pass between the plugin and the
+    // host (and libstdc++) both ways, so each must be freed by the one that
+    // made it. RTLD_DEFAULT, not RTLD_NEXT: a dlopen'ed plugin's next
+    // object is the C library, past an allocator the host preloaded.
+    using MallocFunction = void* (*)(size_t);
+    using CallocFunction = void* (*)(size_t, size_t);
+    using ReallocFunction = void* (*)(void*, size_t);
+    using FreeFunction = void (*)(void*);
+
+    std::atomic<MallocFunction> nextMalloc { nullptr };
+    std::atomic<CallocFunction> nextCalloc { nullptr };
+    std::atomic<ReallocFunction> nextRealloc { nullptr };
+    std::atomic<FreeFunction> nextFree { nullptr };
+   #endif
+
+    void* allocate(size_t size) noexcept
+    {
+       #if SHARC_HOOK_MALLOC
+        return next(nextMalloc, "malloc", RTLD_DEFAULT)(size);
+       #else
+        return std::malloc(size);
+       #endif
+    }
+
+    void deallocate(void* p) noexcept
+    {
+       #if SHARC_HOOK_MALLOC
+        next(nextFree, "free", RTLD_DEFAULT)(p);
+       #else
+        std::free(p);
+       #endif
+    }
+
+    void* allocateAligned(size_t size, size_t alignment) noexcept
+    {
+       #if JUCE_WINDOWS
+        return _aligned_malloc(size, alignment);
+       #else
+        void* p = nullptr;
+        return posix_memalign(&p, juce::jmax(alignment, sizeof(void*)), size) == 0 ? p : nullptr;
+       #endif
+    }
+
+    void deallocateAligned(void* p) noexcept
+    {
+       #if JUCE_WINDOWS
+        _aligned_free(p);
+       #else
+        deallocate(p);
+       #endif
+    }
+
+    void* newOrThrow(size_t size)
+    {
+        SharcRealtimeChecker::note(SharcRealtimeChecker::Violation::allocation);
+
+        if (auto* p = allocate(size == 0 ? 1 : size))
+            return p;
+
+        throw std::bad_alloc();
+    }
+
+    void* newAlignedOrThrow(size_t size, std::align_val_t alignment)
+    {
+        SharcRealtimeChecker::note(SharcRealtimeChecker::Violation::allocation);
+
+        if (auto* p = allocateAligned(size == 0 ? 1 : size, static_cast<size_t>(alignment)))
+            return p;
+
+        throw std::bad_alloc();
+    }
+
+    void freeNoted(void* p) noexcept
+    {
+        if (p != nullptr)
+            SharcRealtimeChecker::note(SharcRealtimeChecker::Violation::deallocation);
+
+        deallocate(p);
+    }
+
+    void freeAlignedNoted(void* p) noexcept
+    {
+        if (p != nullptr)
+            SharcRealtimeChecker::note(SharcRealtimeChecker::Violation::deallocation);
+
+        deallocateAligned(p);
+    }
+}
+
+//==============================================================================
+void SharcRealtimeChecker::note(Violation violation) noexcept
+{
+    if (auto* checker = currentChecker)
+        ++checker->blockCounts[static_cast<size_t>(static_cast<int>(violation) * numSources + currentSource)];
+}
+
+SharcRealtimeChecker::ScopedAudioThread::ScopedAudioThread(SharcRealtimeChecker& c) noexcept
+    : checker(c), previousChecker(currentChecker), previousSource(currentSource)
+{
+    currentChecker = &checker;
+    currentSource = static_cast<int>(Source::dsp);
+}
+
+SharcRealtimeChecker::ScopedAudioThread::~ScopedAudioThread()
+{
+    // Not counted: publishing touches no heap
+    currentChecker = nullptr;
+    checker.publishBlock();
+    currentChecker = previousChecker;
+    currentSource = previousSource;
+}
+
+SharcRealtimeChecker::ScopedSource::ScopedSource(Source source) noexcept
+    : previousSource(currentSource)
+{
+    currentSource = static_cast<int>(source);
+
+    if (source == Source::prepare)
+        note(Violation::reentry);
+}
+
+SharcRealtimeChecker::ScopedSource::~ScopedSource()
+{
+    currentSource = previousSource;
+}
+
+//==============================================================================
+void* operator new(size_t size)                         { return newOrThrow(size); }
+void* operator new[](size_t size)                       { return newOrThrow(size); }
+void* operator new(size_t size, std::align_val_t a)     { return newAlignedOrThrow(size, a); }
+void* operator new[](size_t size, std::align_val_t a)   { return newAlignedOrThrow(size, a); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    SharcRealtimeChecker::note(SharcRealtimeChecker::Violation::allocation);
+    return allocate(size == 0 ? 1 : size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    SharcRealtimeChecker::note(SharcRealtimeChecker::Violation::allocation);
+    return allocate(size == 0 ? 1 : size);
+}
+
+void operator delete(void* p) noexcept                                  { freeNoted(p); }
+void operator delete[](void* p) noexcept                                { freeNoted(p); }
+void operator delete(void* p, size_t) noexcept                          { freeNoted(p); }
+void operator delete[](void* p, size_t) noexcept                        { freeNoted(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept           { freeNoted(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept         { freeNoted(p); }
+void operator delete(void* p, std::align_val_t) noexcept                { freeAlignedNoted(p); }
+void operator delete[](void* p, std::align_val_t) noexcept              { freeAlignedNoted(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept        { freeAlignedNoted(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept      { freeAlignedNoted(p); }
+
+//==============================================================================
+#if SHARC_HOOK_MALLOC
+extern "C"
+{
+    void* malloc(size_t size) noexcept
+    {
+        SharcRealtimeChecker::note(SharcRealtimeChecker::Violation::allocation);
+        return allocate(size);
+    }
+
+    void* calloc(size_t count, size_t size) noexcept
+    {
+        SharcRealtimeChecker::note(SharcRealtimeChecker::Violation::allocation);
+        return next(nextCalloc, "calloc", RTLD_DEFAULT)(count, size);
+    }
+
+    void* realloc(void* p, size_t size) noexcept
+    {
+        SharcRealtimeChecker::note(SharcRealtimeChecker::Violation::allocation);
+        return next(nextRealloc, "realloc", RTLD_DEFAULT)(p, size);
+    }
+
+    void free(void* p) noexcept
+    {
+        freeNoted(p);
+    }
+}
+#endif
+
+//==============================================================================
+#if SHARC_HOOK_PTHREADS
+namespace
+{
+    using MutexFunction = int (*)(pthread_mutex_t*);
+    using RwlockFunction = int (*)(pthread_rwlock_t*);
+    using WaitFunction = int (*)(pthread_cond_t*, pthread_mutex_t*);
+    using TimedWaitFunction = int (*)(pthread_cond_t*, pthread_mutex_t*, const struct timespec*);
+
+    std::atomic<MutexFunction> nextMutexLock { nullptr };
+    std::atomic<RwlockFunction> nextReadLock { nullptr }, nextWriteLock { nullptr };
+    std::atomic<WaitFunction> nextWait { nullptr };
+    std::atomic<TimedWaitFunction> nextTimedWait { nullptr };
+}
+
+// Declared noexcept by glibc, not by other C libraries
+#if defined(__GLIBC__)
+ #define SHARC_HOOK_NOEXCEPT noexcept
+#else
+ #define SHARC_HOOK_NOEXCEPT
+#endif
+
+extern "C"
+{
+    int pthread_mutex_lock(pthread_mutex_t* mutex) SHARC_HOOK_NOEXCEPT
+    {
+        SharcRealtimeChecker::note(SharcRealtimeChecker::Violation::lock);
+        return next(nextMutexLock, "pthread_mutex_lock")(mutex);
+    }
+
+    int pthread_rwlock_rdlock(pthread_rwlock_t* lock) SHARC_HOOK_NOEXCEPT
+    {
+        SharcRealtimeChecker::note(SharcRealtimeChecker::Violation::lock);
+        return next(nextReadLock, "pthread_rwlock_rdlock")(lock);
+    }
+
+    int pthread_rwlock_wrlock(pthread_rwlock_t* lock) SHARC_HOOK_NOEXCEPT
+    {
+        SharcRealtimeChecker::note(SharcRealtimeChecker::Violation::lock);
+        return next(nextWriteLock, "pthread_rwlock_wrlock")(lock);
+    }
+
+    int pthread_cond_wait(pthread_cond_t* condition, pthread_mutex_t* mutex)
+    {
+        SharcRealtimeChecker::note(SharcRealtimeChecker::Violation::lock);
+        return next(nextWait, "pthread_cond_wait")(condition, mutex);
+    }
+
+    int pthread_cond_timedwait(pthread_cond_t* condition, pthread_mutex_t* mutex,
+                                                     const struct timespec* time)
+    {
+        SharcRealtimeChecker::note(SharcRealtimeChecker::Violation::lock);
+        return next(nextTimedWait, "pthread_cond_timedwait")(condition, mutex, time);
+    }
+}
+#endif
+
+#endif
@@ -0,0 +1,293 @@
+/*
+  SHARC Echo/Delay Effect Plugin - Realtime Safety Checker
+  JUCE 8.0.11 - Allocations and lock calls made while processBlock runs
+
+  Build with SHARC_REALTIME_CHECKS=1 to certify a build for live use. It
+  is off by default, because the hooks add a thread-local read to every
+  allocation the plugin makes. SharcRealtimeChecker.cpp then replaces the
+  global operator new / delete. With glibc it also replaces malloc,
+  calloc, realloc and free, and on Linux and macOS it wraps the pthread
+  mutex, rwlock and condition-variable waits. The hooks are hidden
+  symbols, so they see only the calls the plugin binary makes (JUCE
+  included), never the host's.
+
+  While a ScopedAudioThread is open on a thread (process() holds one for
+  the whole block), each of those calls counts as a violation in that
+  block. It is counted under the source the code has marked with
+  ScopedSource:
+
+      parameters  parameter schedule: value lookups, SmoothedValue updates
+      dsp         delay line / bank, bypass crossfade
+      output      storage requests, telemetry, async updates
+      prepare     prepareToPlay / releaseResources called from inside
+                  processBlock (e.g. on a sample-rate change); the call
+                  itself also counts, as a re-entry
+
+  Render pool workers are not covered, only the thread in processBlock.
+
+  The totals work like SharcProfiler's: the audio thread is the only
+  writer, a reader may see a block half-recorded, and reset() takes
+  effect at the start of the next block.
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#ifndef SHARC_REALTIME_CHECKS
+ #define SHARC_REALTIME_CHECKS 0
+#endif
+
+//==============================================================================
+class SharcRealtimeChecker
+{
+public:
+    enum class Source
+    {
+        parameters = 0,
+        dsp,
+        output,
+        prepare,
+        numSources
+    };
+
+    enum class Violation
+    {
+        allocation = 0,     // operator new, malloc, calloc, realloc
+        deallocation,       // operator delete, free
+        lock,               // mutex / rwlock lock, condition-variable wait
+        reentry,            // prepareToPlay / releaseResources inside processBlock
+        numViolations
+    };
+
+    static constexpr int numSources = static_cast<int>(Source::numSources);
+    static constexpr int numViolations = static_cast<int>(Violation::numViolations);
+
+    static constexpr bool isEnabled() noexcept { return SHARC_REALTIME_CHECKS != 0; }
+
+    struct Report
+    {
+        uint64_t blocks = 0;                // checked
+        uint64_t blocksWithViolations = 0;
+        uint64_t maxPerBlock = 0;
+        uint64_t counts[numViolations][numSources] {};
+
+        uint64_t getTotal() const noexcept
+        {
+            uint64_t total = 0;
+
+            for (const auto& row : counts)
+                for (auto count : row)
+                    total += count;
+
+            return total;
+        }
+    };
+
+    SharcRealtimeChecker() { clear(); }
+
+    //==============================================================================
+    // Audio thread, around the whole of processBlock. Calls on this thread
+    // count against the block until it closes.
+    class ScopedAudioThread
+    {
+    public:
+       #if SHARC_REALTIME_CHECKS
+        explicit ScopedAudioThread(SharcRealtimeChecker& checker) noexcept;
+        ~ScopedAudioThread();
+
+    private:
+        SharcRealtimeChecker& checker;
+        SharcRealtimeChecker* previousChecker;
+        int previousSource;
+       #else
+        explicit ScopedAudioThread(SharcRealtimeChecker&) noexcept {}
+       #endif
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedAudioThread)
+    };
+
+    // The part of the block the calling thread is in, until it goes out of
+    // scope. No effect outside a ScopedAudioThread, so prepareToPlay can
+    // always hold a Source::prepare one.
+    class ScopedSource
+    {
+    public:
+       #if SHARC_REALTIME_CHECKS
+        explicit ScopedSource(Source source) noexcept;
+        ~ScopedSource();
+
+    private:
+        int previousSource;
+       #else
+        explicit ScopedSource(Source) noexcept {}
+       #endif
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedSource)
+    };
+
+    // The hooks (SharcRealtimeChecker.cpp): counts against the block open
+    // on this thread, if any
+   #if SHARC_REALTIME_CHECKS
+    static void note(Violation violation) noexcept;
+   #else
+    static void note(Violation) noexcept {}
+   #endif
+
+    //==============================================================================
+    // Any thread
+    Report getReport() const noexcept
+    {
+        Report report;
+        report.blocks = blocks.load(std::memory_order_relaxed);
+        report.blocksWithViolations = blocksWithViolations.load(std::memory_order_relaxed);
+        report.maxPerBlock = maxPerBlock.load(std::memory_order_relaxed);
+
+        for (int v = 0; v < numViolations; ++v)
+            for (int s = 0; s < numSources; ++s)
+                report.counts[v][s] = totals[static_cast<size_t>(v * numSources + s)].load(std::memory_order_relaxed);
+
+        return report;
+    }
+
+    // Any thread: cleared by the audio thread before its next block
+    void reset() noexcept { resetRequested.store(true, std::memory_order_release); }
+
+    static const char* getSourceName(Source source) noexcept
+    {
+        switch (source)
+        {
+            case Source::parameters: return "parameters";
+            case Source::dsp:        return "dsp";
+            case Source::output:     return "output";
+            case Source::prepare:    return "prepare";
+            case Source::numSources: break;
+        }
+
+        return "";
+    }
+
+    static const char* getViolationName(Violation violation) noexcept
+    {
+        switch (violation)
+        {
+            case Violation::allocation:    return "allocations";
+            case Violation::deallocation:  return "frees";
+            case Violation::lock:          return "locks";
+            case Violation::reentry:       return "reentries";
+            case Violation::numViolations: break;
+        }
+
+        return "";
+    }
+
+    // "RT-safe over 1200 blocks", or the violations and where most came from
+    juce::String getSummaryText() const
+    {
+        const auto report = getReport();
+
+        if (report.blocks == 0)
+            return "RT: no blocks checked yet";
+
+        if (report.blocksWithViolations == 0)
+            return "RT-safe over " + juce::String(static_cast<juce::int64>(report.blocks)) + " blocks";
+
+        int worstViolation = 0, worstSource = 0;
+
+        for (int v = 0; v < numViolations; ++v)
+            for (int s = 0; s < numSources; ++s)
+                if (report.counts[v][s] > report.counts[worstViolation][worstSource])
+                    worstViolation = v, worstSource = s;
+
+        return "RT: " + juce::String(static_cast<juce::int64>(report.getTotal())) + " violations in "
+             + juce::String(static_cast<juce::int64>(report.blocksWithViolations)) + " of "
+             + juce::String(static_cast<juce::int64>(report.blocks)) + " blocks (max "
+             + juce::String(static_cast<juce::int64>(report.maxPerBlock)) + " per block; most "
+             + getViolationName(static_cast<Violation>(worstViolation)) + " in "
+             + getSourceName(static_cast<Source>(worstSource)) + ")";
+    }
+
+    // CSV, one row per source, then the block counts
+    juce::String toCsv() const
+    {
+        const auto report = getReport();
+        juce::String csv("source");
+
+        for (int v = 0; v < numViolations; ++v)
+            csv << "," << getViolationName(static_cast<Violation>(v));
+
+        csv << "\n";
+
+        for (int s = 0; s < numSources; ++s)
+        {
+            csv << getSourceName(static_cast<Source>(s));
+
+            for (int v = 0; v < numViolations; ++v)
+                csv << "," << juce::String(static_cast<juce::int64>(report.counts[v][s]));
+
+            csv << "\n";
+        }
+
+        csv << "blocks_checked,blocks_with_violations,max_per_block\n"
+            << juce::String(static_cast<juce::int64>(report.blocks)) << ","
+            << juce::String(static_cast<juce::int64>(report.blocksWithViolations)) << ","
+            << juce::String(static_cast<juce::int64>(report.maxPerBlock)) << "\n";
+
+        return csv;
+    }
+
+private:
+    // Audio thread, when its ScopedAudioThread closes: adds the block's
+    // counts to the totals
+    void publishBlock() noexcept
+    {
+        if (resetRequested.load(std::memory_order_acquire))
+        {
+            clear();
+            resetRequested.store(false, std::memory_order_relaxed);
+        }
+
+        uint64_t inBlock = 0;
+
+        for (size_t i = 0; i < blockCounts.size(); ++i)
+        {
+            if (blockCounts[i] == 0)
+                continue;
+
+            inBlock += blockCounts[i];
+            totals[i].store(totals[i].load(std::memory_order_relaxed) + blockCounts[i], std::memory_order_relaxed);
+            blockCounts[i] = 0;
+        }
+
+        blocks.store(blocks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+        if (inBlock > 0)
+        {
+            blocksWithViolations.store(blocksWithViolations.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+            if (inBlock > maxPerBlock.load(std::memory_order_relaxed))
+                maxPerBlock.store(inBlock, std::memory_order_relaxed);
+        }
+    }
+
+    void clear() noexcept
+    {
+        for (auto& total : totals)
+            total.store(0, std::memory_order_relaxed);
+
+        blocks.store(0, std::memory_order_relaxed);
+        blocksWithViolations.store(0, std::memory_order_relaxed);
+        maxPerBlock.store(0, std::memory_order_relaxed);
+    }
+
+    // Written by the hooks on the audio thread only, between publishes
+    std::array<uint32_t, static_cast<size_t>(numViolations * numSources)> blockCounts {};
+
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(numViolations * numSources)> totals;
+    std::atomic<uint64_t> blocks { 0 }, blocksWithViolations { 0 }, maxPerBlock { 0 };
+    std::atomic<bool> resetRequested { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SharcRealtimeChecker)
+};
@@ -0,0 +1,193 @@
+/*
+  SHARC Echo/Delay Effect Plugin - Offline Render Pool
+  JUCE 8.0.11 - Persistent worker threads for faster-than-realtime bounces
+
+  While the host renders offline (isNonRealtime()), the processor splits
+  the bus into channel groups and runs each group's share of the host
+  buffer on its own thread. The workers are started in prepareToPlay and
+  reused for every buffer: a dispatch is a generation bump plus one notify
+  per worker, with no allocation and no lock on the calling thread.
+
+  Jobs are assigned statically (participant p runs jobs p, p + P, ...), so
+  a group's ring stays in the private caches of the same core from one
+  buffer to the next. The calling thread is participant 0 and returns
+  once every job has finished.
+
+  After a job a worker spins briefly, since the next buffer of a bounce
+  usually follows within microseconds, then sleeps, so an idle pool costs
+  nothing. Never used for realtime playback: waiting for the workers may
+  block.
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <cstdint>
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+#endif
+
+//==============================================================================
+class SharcRenderPool
+{
+public:
+    static constexpr int maxWorkers = 15;
+
+    struct Job
+    {
+        virtual ~Job() = default;
+        virtual void run(int index) noexcept = 0;
+    };
+
+    SharcRenderPool() = default;
+    ~SharcRenderPool() { stop(); }
+
+    // Message thread, audio stopped: (re)starts with numWorkers threads
+    // besides the caller. 0 stops the pool.
+    void start(int numWorkers)
+    {
+        numWorkers = juce::jlimit(0, maxWorkers, numWorkers);
+
+        if (numWorkers == workers.size())
+            return;
+
+        stop();
+
+        for (int i = 0; i < numWorkers; ++i)
+            workers.add(new Worker(*this, i + 1))->startThread();
+    }
+
+    // Message thread, audio stopped
+    void stop()
+    {
+        for (auto* worker : workers)
+            worker->signalThreadShouldExit();
+
+        workers.clear();
+    }
+
+    int getNumWorkers() const noexcept { return workers.size(); }
+
+    // Runs job.run(0 .. numJobs - 1) on the workers and the calling thread,
+    // and returns once every index has run
+    void run(Job& job, int numJobs) noexcept
+    {
+        const int participants = juce::jmin(numJobs, workers.size() + 1);
+
+        if (participants <= 1)
+        {
+            for (int i = 0; i < numJobs; ++i)
+                job.run(i);
+
+            return;
+        }
+
+        currentJob = &job;
+        currentNumJobs = numJobs;
+        currentParticipants = participants;
+        remaining.store(participants - 1, std::memory_order_relaxed);
+
+        // The caller is the only writer
+        const uint64_t next = ((dispatch.load(std::memory_order_relaxed) >> 8) + 1) << 8;
+        dispatch.store(next | static_cast<uint64_t>(participants), std::memory_order_release);
+
+        for (int i = 0; i < participants - 1; ++i)
+            workers.getUnchecked(i)->notify();
+
+        runShare(0);
+
+        // A signal left over from an earlier run only costs one more check
+        for (int spins = 0; remaining.load(std::memory_order_acquire) != 0;)
+        {
+            if (++spins < spinIterations)
+                pause();
+            else
+                finished.wait(-1);
+        }
+    }
+
+private:
+    class Worker : public juce::Thread
+    {
+    public:
+        Worker(SharcRenderPool& p, int participantIndex)
+            : juce::Thread("SHARC render " + juce::String(participantIndex)),
+              pool(p), participant(participantIndex),
+              seen(p.dispatch.load(std::memory_order_relaxed))
+        {
+        }
+
+        ~Worker() override { stopThread(1000); }
+
+        void run() override
+        {
+            while (!threadShouldExit())
+            {
+                uint64_t current = seen;
+
+                for (int spins = 0; (current = pool.dispatch.load(std::memory_order_acquire)) == seen;)
+                {
+                    if (threadShouldExit())
+                        return;
+
+                    if (++spins < spinIterations)
+                        pause();
+                    else
+                        wait(-1);
+                }
+
+                seen = current;
+
+                // Runs with fewer jobs than workers leave the rest idle. The
+                // count comes with the generation: idle workers must not
+                // read the job fields, the caller may already be refilling them
+                if (participant >= static_cast<int>(current & 0xff))
+                    continue;
+
+                pool.runShare(participant);
+
+                if (pool.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    pool.finished.signal();
+            }
+        }
+
+    private:
+        SharcRenderPool& pool;
+        const int participant;
+
+        // Taken at construction, so a dispatch issued before the thread
+        // first runs is not missed
+        uint64_t seen;
+    };
+
+    void runShare(int participant) noexcept
+    {
+        for (int i = participant; i < currentNumJobs; i += currentParticipants)
+            currentJob->run(i);
+    }
+
+    static void pause() noexcept
+    {
+       #if JUCE_INTEL
+        _mm_pause();
+       #endif
+    }
+
+    // ~20-50 us of spinning before a thread sleeps
+    static constexpr int spinIterations = 1000;
+
+    // Written by the caller before it publishes the dispatch (release),
+    // read by the participating workers after they see it (acquire)
+    Job* currentJob = nullptr;
+    int currentNumJobs = 0;
+    int currentParticipants = 0;
+
+    // Generation << 8 | number of participants
+    std::atomic<uint64_t> dispatch { 0 };
+    std::atomic<int> remaining { 0 };
+    juce::WaitableEvent finished;
+    juce::OwnedArray<Worker> workers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SharcRenderPool)
+};
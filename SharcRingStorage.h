@@ -0,0 +1,401 @@
+/*
+  SHARC Echo/Delay Effect Plugin - Ring Storage
+  JUCE 8.0.11 - Lazily grown, cheaply cleared delay memory
+
+  Backing store for SharcDelayLine (one interleaved stereo row) and
+  SharcDelayBank (one mono row per channel). Each row holds a power-of-two
+  ring plus SharcRing::guardFrames mirrored frames.
+
+  Capacity follows the delay actually in use instead of the worst case:
+  prepare() sizes the rings for the current delay, and when a longer one
+  is asked for the audio thread only records the request. The owner's
+  message thread (an offline render's own thread) allocates the bigger
+  block (service()); the audio thread
+  adopts it at the start of its next block (adoptPending()), copying the
+  history across, and hands the old block back to be freed. Until then the
+  delay is clamped to what fits. No allocation or lock on the audio thread.
+
+  A dirty high-water mark tracks how much of the ring was written since
+  the last clear, so clear() only zeroes that region.
+
+  Samples are float or, in SharcRingFormat::int16, 16-bit fixed point
+  (half the memory). Switching format goes through the same path as a
+  growth: requestFormat() records it, service() allocates a block in the
+  new format and adoptPending() converts the history into it.
+
+  Blocks come from SharcMemoryPool, shared by every instance in the
+  process; release() hands them back when the host stops playback.
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include "SharcDelayKernels.h"
+#include "SharcMemoryPool.h"
+
+//==============================================================================
+class SharcRingStorage
+{
+public:
+    static constexpr size_t storageAlignment = 64;
+
+    // Smallest ring ever allocated (~170 ms at 48 kHz), so short delays
+    // that move a little don't trigger a growth each time
+    static constexpr int minimumLength = 1 << 13;
+
+    // Interpolator taps beyond the delay itself (older-1 .. older+2)
+    static constexpr int tapFrames = 4;
+
+    SharcRingStorage() = default;
+
+    ~SharcRingStorage()
+    {
+        delete pending.exchange(nullptr);
+        delete retired.exchange(nullptr);
+    }
+
+    // Message thread, audio stopped. initialDelay / maxDelay in samples.
+    void prepare(int rows, int channelsPerRow, int initialDelay, int maxDelay,
+                 SharcRingFormat format = SharcRingFormat::float32)
+    {
+        numRows = rows;
+        channels = channelsPerRow;
+        maxLength = lengthFor(maxDelay);
+
+        delete pending.exchange(nullptr);
+        delete retired.exchange(nullptr);
+        requestedLength.store(0);
+        requestedFormat.store(format);
+
+        current.reset(new Block(numRows, channels, juce::jmin(maxLength, lengthFor(initialDelay)), format));
+        currentLength.store(current->length);
+        currentFormat.store(format);
+        dirtyFrames = 0;
+    }
+
+    // Message thread, audio stopped: returns every block to the pool.
+    // data() is null until the next prepare().
+    void release() noexcept
+    {
+        delete pending.exchange(nullptr);
+        delete retired.exchange(nullptr);
+        requestedLength.store(0);
+
+        current.reset();
+        currentLength.store(0);
+        dirtyFrames = 0;
+    }
+
+    // Null / zero until prepare() has run. data() is null for an int16
+    // ring, compactData() for a float one.
+    float* data() const noexcept { return current != nullptr ? current->data<float>() : nullptr; }
+    int16_t* compactData() const noexcept { return current != nullptr ? current->data<int16_t>() : nullptr; }
+    SharcRingFormat getFormat() const noexcept { return current != nullptr ? current->format : requestedFormat.load(); }
+    int getLength() const noexcept { return current != nullptr ? current->length : 0; }
+    int getRowStride() const noexcept { return current != nullptr ? current->rowStride : 0; }
+
+    // Longest delay (samples) the current ring can read
+    int getAvailableDelay() const noexcept { return getLength() - tapFrames; }
+
+    //==============================================================================
+    // Audio thread: asks for room for delaySamples (up to the prepare()
+    // maximum). Returns true if the ring is too short right now.
+    bool request(double delaySamples) noexcept
+    {
+        if (current == nullptr || delaySamples <= getAvailableDelay() || current->length >= maxLength)
+            return false;
+
+        const int wanted = juce::jmin(maxLength, lengthFor(static_cast<int>(std::ceil(delaySamples))));
+
+        if (wanted > requestedLength.load(std::memory_order_relaxed))
+            requestedLength.store(wanted, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    // Any thread: asks for the history in another format. Takes effect
+    // once service() and adoptPending() have run; already-written history
+    // is converted, not lost.
+    void requestFormat(SharcRingFormat format) noexcept
+    {
+        requestedFormat.store(format, std::memory_order_relaxed);
+    }
+
+    // Audio thread, before processing: swaps in a grown (or converted)
+    // block if one is ready. writeIndex stays valid. Returns true if
+    // data() / compactData() changed.
+    bool adoptPending(int writeIndex) noexcept
+    {
+        if (current == nullptr || retired.load(std::memory_order_acquire) != nullptr)
+            return false; // not prepared, or previous block not freed yet
+
+        std::unique_ptr<Block> next(pending.exchange(nullptr, std::memory_order_acq_rel));
+
+        if (next == nullptr)
+            return false;
+
+        copyHistory(*current, *next, writeIndex);
+
+        retired.store(current.release(), std::memory_order_release);
+        current = std::move(next);
+        currentLength.store(current->length, std::memory_order_release);
+        currentFormat.store(current->format, std::memory_order_release);
+        dirtyFrames = current->length;
+        return true;
+    }
+
+    // Audio thread: true if service() has work (allocate or free)
+    bool needsService() const noexcept
+    {
+        if (retired.load(std::memory_order_acquire) != nullptr)
+            return true;
+
+        return pending.load(std::memory_order_acquire) == nullptr
+            && (requestedLength.load(std::memory_order_relaxed) > currentLength.load(std::memory_order_acquire)
+                || requestedFormat.load(std::memory_order_relaxed) != currentFormat.load(std::memory_order_acquire));
+    }
+
+    // Message thread: frees the retired block, allocates a requested one
+    void service()
+    {
+        delete retired.exchange(nullptr, std::memory_order_acq_rel);
+
+        const int wanted = requestedLength.load(std::memory_order_relaxed);
+        const int length = currentLength.load(std::memory_order_acquire);
+        const auto format = requestedFormat.load(std::memory_order_relaxed);
+
+        if (length == 0 || (wanted <= length && format == currentFormat.load(std::memory_order_acquire)))
+            return;
+
+        // Grow at least 2x so a slow sweep doesn't reallocate every step; a
+        // format change alone keeps the length
+        const int target = wanted > length ? juce::jmin(maxLength, juce::jmax(wanted, 2 * length)) : length;
+
+        if (auto* waiting = pending.load(std::memory_order_acquire);
+            waiting != nullptr && waiting->length >= target && waiting->format == format)
+            return;
+
+        delete pending.exchange(new Block(numRows, channels, target, format), std::memory_order_acq_rel);
+    }
+
+    //==============================================================================
+    // Audio thread: frames the owner just wrote (write head starts at 0
+    // after a clear, so [0, dirtyFrames) covers everything written)
+    void markWritten(int numFrames) noexcept
+    {
+        if (current != nullptr)
+            dirtyFrames = juce::jmin(current->length, dirtyFrames + numFrames);
+    }
+
+    // Zeroes the written region of every row (and its guard mirror)
+    void clear() noexcept
+    {
+        if (dirtyFrames == 0 || current == nullptr)
+            return;
+
+        // All-zero bytes are 0.0f and int16 0 alike
+        const size_t frameBytes = static_cast<size_t>(channels) * current->sampleBytes;
+
+        for (int r = 0; r < numRows; ++r)
+        {
+            auto* row = static_cast<char*>(current->memory) + current->rowBytes() * static_cast<size_t>(r);
+            std::memset(row, 0, static_cast<size_t>(dirtyFrames) * frameBytes);
+            std::memset(row + static_cast<size_t>(current->length) * frameBytes, 0,
+                        static_cast<size_t>(SharcRing::guardFrames) * frameBytes);
+        }
+
+        dirtyFrames = 0;
+    }
+
+    //==============================================================================
+    // Audio thread: the numFrames frames before writeIndex, oldest first,
+    // as float frames of every row's channels in turn (rows * channels
+    // samples per frame). For state snapshots; numFrames <= getLength().
+    void readHistory(float* destination, int numFrames, int writeIndex) const noexcept
+    {
+        if (current == nullptr)
+            return;
+
+        if (current->format == SharcRingFormat::int16)
+            readHistory(current->data<int16_t>(), destination, numFrames, writeIndex);
+        else
+            readHistory(current->data<float>(), destination, numFrames, writeIndex);
+    }
+
+    // Audio thread: the reverse, the last frame landing just before
+    // writeIndex. Only the newest getLength() frames fit.
+    void writeHistory(const float* source, int numFrames, int writeIndex) noexcept
+    {
+        if (current == nullptr)
+            return;
+
+        if (current->format == SharcRingFormat::int16)
+            writeHistory(source, current->data<int16_t>(), numFrames, writeIndex);
+        else
+            writeHistory(source, current->data<float>(), numFrames, writeIndex);
+
+        dirtyFrames = current->length;
+    }
+
+private:
+    struct Block
+    {
+        Block(int rows, int channelsPerRow, int frames, SharcRingFormat f)
+            : length(frames),
+              rowStride((frames + SharcRing::guardFrames) * channelsPerRow),
+              format(f),
+              sampleBytes(f == SharcRingFormat::int16 ? sizeof(int16_t) : sizeof(float)),
+              bytes(static_cast<size_t>(rowStride) * static_cast<size_t>(rows) * sampleBytes),
+              memory(SharcMemoryPool::allocate(bytes)) {}
+
+        ~Block() { SharcMemoryPool::release(memory, bytes); }
+
+        // Null unless Sample matches the format
+        template <typename Sample>
+        Sample* data() const noexcept
+        {
+            const bool matches = std::is_same_v<Sample, int16_t> == (format == SharcRingFormat::int16);
+            return matches ? static_cast<Sample*>(memory) : nullptr;
+        }
+
+        size_t rowBytes() const noexcept { return static_cast<size_t>(rowStride) * sampleBytes; }
+
+        int length;
+        int rowStride;  // samples
+        SharcRingFormat format;
+        size_t sampleBytes;
+        size_t bytes;
+        void* memory;   // zeroed, >= storageAlignment aligned
+
+        JUCE_DECLARE_NON_COPYABLE(Block)
+    };
+
+    static int lengthFor(int delaySamples) noexcept
+    {
+        return juce::nextPowerOfTwo(juce::jmax(minimumLength, delaySamples + tapFrames));
+    }
+
+    // Same write head in both rings: frames before it keep their index,
+    // the older ones move to the end of the bigger ring
+    void copyHistory(const Block& from, Block& to, int writeIndex) noexcept
+    {
+        if (from.format == SharcRingFormat::int16)
+        {
+            if (to.format == SharcRingFormat::int16)
+                copyHistory(from.data<int16_t>(), from, to.data<int16_t>(), to, writeIndex);
+            else
+                copyHistory(from.data<int16_t>(), from, to.data<float>(), to, writeIndex);
+        }
+        else
+        {
+            if (to.format == SharcRingFormat::int16)
+                copyHistory(from.data<float>(), from, to.data<int16_t>(), to, writeIndex);
+            else
+                copyHistory(from.data<float>(), from, to.data<float>(), to, writeIndex);
+        }
+    }
+
+    // Converts on the way when the formats differ (see sharcRingSample())
+    template <typename From, typename To>
+    void copyHistory(const From* source, const Block& from, To* destination, const Block& to, int writeIndex) noexcept
+    {
+        const auto convert = [](From s)
+        {
+            if constexpr (std::is_same_v<From, To>)
+                return s;
+            else
+                return sharcRingSample<To>(sharcRingValue(s));
+        };
+
+        const size_t c = static_cast<size_t>(channels);
+        const size_t head = static_cast<size_t>(writeIndex) * c;
+        const size_t older = static_cast<size_t>(from.length - writeIndex) * c;
+
+        for (int r = 0; r < numRows; ++r)
+        {
+            const From* src = source + static_cast<size_t>(r) * static_cast<size_t>(from.rowStride);
+            To* dst = destination + static_cast<size_t>(r) * static_cast<size_t>(to.rowStride);
+
+            std::transform(src, src + head, dst, convert);
+            std::transform(src + head, src + head + older, dst + static_cast<size_t>(to.length) * c - older, convert);
+            std::copy(dst, dst + static_cast<size_t>(SharcRing::guardFrames) * c, dst + static_cast<size_t>(to.length) * c);
+        }
+    }
+
+    template <typename Sample>
+    void readHistory(const Sample* samples, float* destination, int numFrames, int writeIndex) const noexcept
+    {
+        const int mask = current->length - 1;
+        const int width = numRows * channels;
+
+        for (int r = 0; r < numRows; ++r)
+        {
+            const Sample* row = samples + static_cast<size_t>(r) * static_cast<size_t>(current->rowStride);
+
+            for (int f = 0; f < numFrames; ++f)
+            {
+                const Sample* frame = row + static_cast<size_t>((writeIndex - numFrames + f) & mask) * static_cast<size_t>(channels);
+
+                for (int c = 0; c < channels; ++c)
+                    destination[f * width + r * channels + c] = sharcRingValue(frame[c]);
+            }
+        }
+    }
+
+    // Snapshots come from a file: kept in the ring's +-1 (NaN -> +1), and
+    // rounded so an int16 ring's own codes come back unchanged
+    template <typename Sample>
+    static Sample restoredSample(float value) noexcept
+    {
+        value = std::fmax(-1.0f, std::fmin(1.0f, value));
+
+        if constexpr (std::is_same_v<Sample, int16_t>)
+            return static_cast<int16_t>(juce::roundToInt(value * sharcCompactScale));
+        else
+            return value;
+    }
+
+    template <typename Sample>
+    void writeHistory(const float* source, Sample* samples, int numFrames, int writeIndex) noexcept
+    {
+        const int mask = current->length - 1;
+        const int width = numRows * channels;
+        const int skipped = juce::jmax(0, numFrames - current->length);
+        const size_t c = static_cast<size_t>(channels);
+
+        source += static_cast<size_t>(skipped) * static_cast<size_t>(width);
+        numFrames -= skipped;
+
+        for (int r = 0; r < numRows; ++r)
+        {
+            Sample* row = samples + static_cast<size_t>(r) * static_cast<size_t>(current->rowStride);
+
+            for (int f = 0; f < numFrames; ++f)
+            {
+                Sample* frame = row + static_cast<size_t>((writeIndex - numFrames + f) & mask) * c;
+
+                for (int ch = 0; ch < channels; ++ch)
+                    frame[ch] = restoredSample<Sample>(source[f * width + r * channels + ch]);
+            }
+
+            std::copy(row, row + static_cast<size_t>(SharcRing::guardFrames) * c, row + static_cast<size_t>(current->length) * c);
+        }
+    }
+
+    std::unique_ptr<Block> current;     // audio thread (after prepare)
+    std::atomic<Block*> pending { nullptr }, retired { nullptr };
+    std::atomic<int> requestedLength { 0 }, currentLength { 0 };
+    std::atomic<SharcRingFormat> requestedFormat { SharcRingFormat::float32 },
+                                 currentFormat { SharcRingFormat::float32 };
+
+    int numRows = 1;
+    int channels = 2;
+    int maxLength = minimumLength;
+    int dirtyFrames = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SharcRingStorage)
+};
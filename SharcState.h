@@ -0,0 +1,348 @@
+/*
+  SHARC Echo/Delay Effect Plugin - Plugin State
+  JUCE 8.0.11 - Compact binary state, optional delay history snapshot
+
+  getStateInformation / setStateInformation write and read a small
+  chunked binary format instead of ValueTree -> XML -> binary. A session
+  with hundreds of instances no longer builds and parses an XML document
+  per instance, and a restore does not go through replaceState: each value
+  is set on its parameter, so the audio thread picks it up through
+  SharcParameterEngine and its smoothers like any automation move.
+
+  Layout (little-endian):
+
+      uint32 magic ("SHRC"), int32 version
+      chunks: uint32 tag, int32 payload size, payload
+
+      "PARM"  int32 count, then count x { UTF-8 ID, 0-terminated; float
+              value, denormalised }
+      "HIST"  int32 channels, int32 frames, frames x channels float
+              (the delay history, oldest frame first; optional)
+
+  Readers skip chunks they don't know, so a newer version stays loadable
+  as long as it keeps the ones above. Values are stored by ID and in the
+  parameter's own units, so parameters may be added or their ranges
+  changed. Blobs without the magic are the XML states of earlier builds.
+
+  SharcHistoryExchange moves a history snapshot between the message thread
+  (state save / load) and the audio thread, which owns the ring. The audio
+  thread only copies into or out of a buffer the message thread allocated;
+  it never allocates, frees or waits. The message thread's waits for it
+  come out of one budget shared by every instance in the process, so
+  saving a session of hundreds of instances blocks for 50 ms at most.
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// Build with SHARC_BINARY_STATE=0 to save the XML state of earlier builds
+// instead; both are always read
+#ifndef SHARC_BINARY_STATE
+ #define SHARC_BINARY_STATE 1
+#endif
+
+// Chunk tag, first character in the lowest byte
+constexpr juce::uint32 sharcFourCC(char a, char b, char c, char d) noexcept
+{
+    return static_cast<juce::uint32>(static_cast<unsigned char>(a))
+         | static_cast<juce::uint32>(static_cast<unsigned char>(b)) << 8
+         | static_cast<juce::uint32>(static_cast<unsigned char>(c)) << 16
+         | static_cast<juce::uint32>(static_cast<unsigned char>(d)) << 24;
+}
+
+//==============================================================================
+class SharcStateFormat
+{
+public:
+    static constexpr int version = 1;
+
+    // Delay history, frames of numChannels samples
+    struct History
+    {
+        int numChannels = 0;
+        int maxFrames = 0;      // capacity of `frames`, in frames
+        int numFrames = 0;
+        std::vector<float> frames;
+
+        History(int channels, int capacity)
+            : numChannels(channels), maxFrames(capacity),
+              frames(static_cast<size_t>(channels) * static_cast<size_t>(capacity)) {}
+    };
+
+    struct Value
+    {
+        juce::String id;
+        float value;
+    };
+
+    // Every parameter with an ID, plus the history if there is one
+    static void write(juce::MemoryBlock& destData, const juce::Array<juce::AudioProcessorParameter*>& parameters,
+                      const History* history)
+    {
+        juce::MemoryOutputStream out(destData, false);
+        out.writeInt(static_cast<int>(magic));
+        out.writeInt(version);
+
+        const auto parametersStart = beginChunk(out, parametersTag);
+        int count = 0;
+
+        for (auto* parameter : parameters)
+            if (dynamic_cast<juce::RangedAudioParameter*>(parameter) != nullptr)
+                ++count;
+
+        out.writeInt(count);
+
+        for (auto* parameter : parameters)
+        {
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            {
+                out.writeString(ranged->paramID);
+                out.writeFloat(ranged->convertFrom0to1(ranged->getValue()));
+            }
+        }
+
+        endChunk(out, parametersStart);
+
+        if (history != nullptr && history->numFrames > 0)
+        {
+            const auto historyStart = beginChunk(out, historyTag);
+            out.writeInt(history->numChannels);
+            out.writeInt(history->numFrames);
+
+            const int numSamples = history->numChannels * history->numFrames;
+
+            for (int i = 0; i < numSamples; ++i)
+                out.writeFloat(history->frames[static_cast<size_t>(i)]);
+
+            endChunk(out, historyStart);
+        }
+    }
+
+    // False if the data is not this format (try the XML state instead).
+    // history is only set if the state holds one.
+    static bool read(const void* data, int sizeInBytes, std::vector<Value>& values, std::unique_ptr<History>& history)
+    {
+        if (data == nullptr || sizeInBytes < 8)
+            return false;
+
+        juce::MemoryInputStream in(data, static_cast<size_t>(sizeInBytes), false);
+
+        if (static_cast<juce::uint32>(in.readInt()) != magic || in.readInt() < 1)
+            return false;
+
+        while (in.getNumBytesRemaining() >= 8)
+        {
+            const auto tag = static_cast<juce::uint32>(in.readInt());
+            const auto size = static_cast<juce::int64>(in.readInt());
+
+            if (size < 0 || size > in.getNumBytesRemaining())
+                break; // truncated: keep what was read
+
+            const auto next = in.getPosition() + size;
+
+            if (tag == parametersTag)
+            {
+                const int count = in.readInt();
+
+                for (int i = 0; i < count && in.getPosition() < next; ++i)
+                {
+                    auto id = in.readString();
+                    const float value = in.readFloat();
+                    values.push_back({ std::move(id), value });
+                }
+            }
+            else if (tag == historyTag)
+            {
+                const int channels = in.readInt();
+                const int frames = in.readInt();
+
+                if (channels > 0 && frames > 0
+                    && static_cast<juce::int64>(channels) * frames * static_cast<juce::int64>(sizeof(float)) <= next - in.getPosition())
+                {
+                    history = std::make_unique<History>(channels, frames);
+                    history->numFrames = frames;
+
+                    for (auto& sample : history->frames)
+                        sample = in.readFloat();
+                }
+            }
+
+            in.setPosition(next);
+        }
+
+        return true;
+    }
+
+private:
+    static constexpr juce::uint32 magic = sharcFourCC('S', 'H', 'R', 'C');
+    static constexpr juce::uint32 parametersTag = sharcFourCC('P', 'A', 'R', 'M');
+    static constexpr juce::uint32 historyTag = sharcFourCC('H', 'I', 'S', 'T');
+
+    // Tag and a size placeholder; returns where the payload starts
+    static juce::int64 beginChunk(juce::MemoryOutputStream& out, juce::uint32 tag)
+    {
+        out.writeInt(static_cast<int>(tag));
+        out.writeInt(0);
+        return out.getPosition();
+    }
+
+    static void endChunk(juce::MemoryOutputStream& out, juce::int64 payloadStart)
+    {
+        const auto end = out.getPosition();
+        out.setPosition(payloadStart - 4);
+        out.writeInt(static_cast<int>(end - payloadStart));
+        out.setPosition(end);
+    }
+};
+
+//==============================================================================
+class SharcHistoryExchange
+{
+public:
+    using History = SharcStateFormat::History;
+
+    SharcHistoryExchange() = default;
+
+    ~SharcHistoryExchange()
+    {
+        delete pending.exchange(nullptr);
+        delete retired.exchange(nullptr);
+    }
+
+    // Message thread: asks the audio thread for its history and waits for
+    // it, out of the shared wait budget. Null if the ring is empty
+    // (asleep), audio is not running or the budget ran out first.
+    std::unique_ptr<History> capture(int numChannels, int maxFrames)
+    {
+        if (!active.load(std::memory_order_acquire) || numChannels <= 0 || maxFrames <= 0)
+            return {};
+
+        auto history = std::make_unique<History>(numChannels, maxFrames);
+        captured.store(nullptr, std::memory_order_relaxed);
+        request.store(history.get(), std::memory_order_release);
+
+        auto& budget = getWaitBudget();
+        const auto start = juce::Time::getMillisecondCounter();
+        bool withdrawn = false;
+
+        if (!waitForCapture(history.get(), budget.claim(start)))
+        {
+            // Not taken yet: withdraw it, the audio thread never sees it.
+            // Otherwise it is being copied right now; wait for the end.
+            if (auto* expected = history.get(); request.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel))
+                withdrawn = true;
+            else
+                waitForCapture(history.get(), -1);
+        }
+
+        budget.charge(start, juce::Time::getMillisecondCounter());
+
+        if (withdrawn || history->numFrames == 0)
+            return {};
+
+        return history;
+    }
+
+    // Message thread: the audio thread puts this history back into the
+    // ring at its next block (a newer call replaces one not yet taken)
+    void restore(std::unique_ptr<History> history)
+    {
+        delete pending.exchange(history.release(), std::memory_order_acq_rel);
+    }
+
+    // Audio thread, at the start of a block: answers a capture, applies a
+    // restore. Returns true if a restored history is waiting for release().
+    template <typename Engine>
+    bool service(Engine& engine, int numChannels) noexcept
+    {
+        if (auto* history = request.exchange(nullptr, std::memory_order_acq_rel))
+        {
+            history->numFrames = history->numChannels == numChannels ? engine.copyHistory(history->frames.data(), history->maxFrames)
+                                                                     : 0;
+            captured.store(history, std::memory_order_release);
+        }
+
+        // One restore at a time: the previous one must have been freed
+        if (retired.load(std::memory_order_acquire) == nullptr)
+        {
+            if (auto* history = pending.exchange(nullptr, std::memory_order_acq_rel))
+            {
+                // A different layout can't be mapped back: dropped
+                if (history->numChannels == numChannels)
+                    engine.restoreHistory(history->frames.data(), history->numFrames);
+
+                retired.store(history, std::memory_order_release);
+            }
+        }
+
+        active.store(!engine.isAsleep(), std::memory_order_release);
+        return retired.load(std::memory_order_relaxed) != nullptr;
+    }
+
+    // Message thread: frees a history the audio thread has restored
+    void release()
+    {
+        delete retired.exchange(nullptr, std::memory_order_acq_rel);
+    }
+
+private:
+    // Message thread: polls for the audio thread's answer (a plain store,
+    // so the audio side never touches a lock). -1 waits forever.
+    bool waitForCapture(const History* history, int timeoutMs) const
+    {
+        const auto start = juce::Time::getMillisecondCounter();
+
+        while (captured.load(std::memory_order_acquire) != history)
+        {
+            if (timeoutMs >= 0 && juce::Time::getMillisecondCounter() - start >= static_cast<juce::uint32>(timeoutMs))
+                return false;
+
+            juce::Thread::sleep(1);
+        }
+
+        return true;
+    }
+
+    // A host saves a session with one getStateInformation per instance,
+    // back to back, so the captures of one save share maxWaitMs between
+    // them. The budget refills once no capture has run for maxWaitMs, i.e.
+    // at the next save. Relaxed atomics: captures on two threads at once
+    // can only overspend it by one wait.
+    struct WaitBudget
+    {
+        static constexpr juce::uint32 maxWaitMs = 50;
+        std::atomic<juce::uint32> leftMs { maxWaitMs };
+        std::atomic<juce::uint32> lastCaptureMs { 0 };
+
+        int claim(juce::uint32 now) noexcept
+        {
+            if (now - lastCaptureMs.load(std::memory_order_relaxed) >= maxWaitMs)
+                leftMs.store(maxWaitMs, std::memory_order_relaxed);
+
+            return static_cast<int>(leftMs.load(std::memory_order_relaxed));
+        }
+
+        void charge(juce::uint32 start, juce::uint32 end) noexcept
+        {
+            const auto left = leftMs.load(std::memory_order_relaxed);
+            leftMs.store(left > end - start ? left - (end - start) : 0, std::memory_order_relaxed);
+            lastCaptureMs.store(end, std::memory_order_relaxed);
+        }
+    };
+
+    static WaitBudget& getWaitBudget() noexcept
+    {
+        static WaitBudget budget;
+        return budget;
+    }
+
+    std::atomic<History*> request { nullptr };
+    std::atomic<History*> captured { nullptr };     // the last request answered
+    std::atomic<History*> pending { nullptr }, retired { nullptr };
+    std::atomic<bool> active { false };     // last block had a tail to save
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SharcHistoryExchange)
+};
@@ -0,0 +1,137 @@
+/*
+  SHARC Echo/Delay Effect Plugin - Telemetry
+  JUCE 8.0.11 - Audio-to-UI level frames over a wait-free SPSC FIFO
+
+  processBlock decimates its input and output to one frame per ~5 ms
+  (peak and RMS across all channels) and pushes finished frames into a
+  juce::AbstractFifo: one writer (audio thread), one reader (the editor's
+  timer). A push into a full FIFO drops the frame instead of waiting.
+
+  Collection only runs while an editor is open (setEnabled), so with no
+  UI the audio thread pays one relaxed load per block.
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cmath>
+
+//==============================================================================
+struct SharcTelemetryFrame
+{
+    float inputPeak = 0.0f;
+    float inputRms = 0.0f;
+    float outputPeak = 0.0f;
+    float outputRms = 0.0f;
+};
+
+//==============================================================================
+class SharcTelemetry
+{
+public:
+    static constexpr int capacity = 1024;           // ~5 s of frames
+    static constexpr double frameSeconds = 0.005;
+
+    SharcTelemetry() = default;
+
+    // Message thread, audio stopped
+    void prepare(double sampleRate) noexcept
+    {
+        frameLength = juce::jmax(1, juce::roundToInt(sampleRate * frameSeconds));
+        pendingInput = pendingOutput = Accumulator();
+        pendingSamples = 0;
+    }
+
+    // Message thread: the editor turns collection on while it is open
+    void setEnabled(bool shouldCollect) noexcept { enabled.store(shouldCollect, std::memory_order_relaxed); }
+    bool isEnabled() const noexcept { return enabled.load(std::memory_order_relaxed); }
+
+    //==============================================================================
+    // Audio thread, before processing (the buffer is processed in place)
+    template <typename SampleType>
+    void addInput(const juce::AudioBuffer<SampleType>& buffer, int numSamples) noexcept
+    {
+        pendingInput.add(buffer, numSamples);
+    }
+
+    // Audio thread, after processing: closes the frame once it spans
+    // frameSeconds. Frames are whole blocks, so large blocks make longer
+    // frames rather than splitting.
+    template <typename SampleType>
+    void addOutput(const juce::AudioBuffer<SampleType>& buffer, int numSamples) noexcept
+    {
+        pendingOutput.add(buffer, numSamples);
+        pendingSamples += numSamples;
+
+        if (pendingSamples < frameLength)
+            return;
+
+        SharcTelemetryFrame frame;
+        frame.inputPeak = pendingInput.peak;
+        frame.inputRms = pendingInput.getRms();
+        frame.outputPeak = pendingOutput.peak;
+        frame.outputRms = pendingOutput.getRms();
+
+        const auto scope = fifo.write(1);
+
+        if (scope.blockSize1 > 0)
+            frames[static_cast<size_t>(scope.startIndex1)] = frame;
+
+        pendingInput = pendingOutput = Accumulator();
+        pendingSamples = 0;
+    }
+
+    //==============================================================================
+    // Reader: copies up to maxFrames of the oldest frames, returns how many
+    int pop(SharcTelemetryFrame* dest, int maxFrames) noexcept
+    {
+        int count = 0;
+        const auto scope = fifo.read(juce::jmin(maxFrames, fifo.getNumReady()));
+        scope.forEach([&](int index) { dest[count++] = frames[static_cast<size_t>(index)]; });
+        return count;
+    }
+
+    // Reader: drops whatever queued up while nobody was reading
+    void discardPending() noexcept
+    {
+        const auto scope = fifo.read(fifo.getNumReady());
+        juce::ignoreUnused(scope);
+    }
+
+private:
+    struct Accumulator
+    {
+        float peak = 0.0f;
+        double sumOfSquares = 0.0;
+        int count = 0;
+
+        template <typename SampleType>
+        void add(const juce::AudioBuffer<SampleType>& buffer, int numSamples) noexcept
+        {
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            {
+                const auto rms = static_cast<float>(buffer.getRMSLevel(ch, 0, numSamples));
+                peak = juce::jmax(peak, static_cast<float>(buffer.getMagnitude(ch, 0, numSamples)));
+                sumOfSquares += static_cast<double>(rms) * rms * numSamples;
+                count += numSamples;
+            }
+        }
+
+        float getRms() const noexcept
+        {
+            return count > 0 ? static_cast<float>(std::sqrt(sumOfSquares / count)) : 0.0f;
+        }
+    };
+
+    juce::AbstractFifo fifo { capacity };
+    std::array<SharcTelemetryFrame, capacity> frames {};
+    std::atomic<bool> enabled { false };
+
+    // Audio thread only
+    Accumulator pendingInput, pendingOutput;
+    int pendingSamples = 0;
+    int frameLength = 240;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SharcTelemetry)
+};
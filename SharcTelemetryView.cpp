@@ -0,0 +1,191 @@
+/*
+  SHARC Echo/Delay Effect Plugin - Telemetry View Implementation
+  JUCE 8.0.11
+*/
+
+#include "SharcTelemetryView.h"
+
+namespace
+{
+    const juce::Colour panelColour(0xff0a0d1a);
+    const juce::Colour gridColour(0xff4a5a6a);
+    const juce::Colour inputColour(0xff3a6a8a);
+    const juce::Colour outputColour(0xff40c0ff);
+    const juce::Colour tailColour(0xffffa040);
+
+    constexpr int maxTailEchoes = 64;
+    constexpr float silentLevel = 1.0e-5f;    // below half a pixel at any height
+}
+
+//==============================================================================
+SharcTelemetryView::SharcTelemetryView()
+{
+    setOpaque(true);
+}
+
+void SharcTelemetryView::resized()
+{
+    auto bounds = getLocalBounds().reduced(4);
+    tailArea = bounds.removeFromRight(bounds.getWidth() / 3);
+    bounds.removeFromRight(6);
+    historyArea = bounds;
+
+    // Software images so the trace can be scrolled in place
+    trace = juce::Image(juce::Image::ARGB, juce::jmax(1, historyArea.getWidth()), juce::jmax(1, historyArea.getHeight()),
+                        true, juce::SoftwareImageType());
+    silentColumns = trace.getWidth();
+
+    renderBackground();
+    renderTail();
+}
+
+//==============================================================================
+bool SharcTelemetryView::update(SharcTelemetry& telemetry)
+{
+    const int count = telemetry.pop(incoming.data(), static_cast<int>(incoming.size()));
+    int lastAudible = -1;
+
+    for (int i = 0; i < count; ++i)
+        if (incoming[static_cast<size_t>(i)].inputPeak > silentLevel || incoming[static_cast<size_t>(i)].outputPeak > silentLevel)
+            lastAudible = i;
+
+    if (count == 0 || (lastAudible < 0 && silentColumns >= trace.getWidth()))
+        return false;
+
+    silentColumns = lastAudible < 0 ? silentColumns + count : count - 1 - lastAudible;
+
+    drawColumns(incoming.data(), count);
+    repaint(historyArea);
+    return true;
+}
+
+bool SharcTelemetryView::setTail(float delaySeconds, float feedback, float floorDb)
+{
+    if (delaySeconds == tailDelaySeconds && feedback == tailFeedback && floorDb == tailFloorDb)
+        return false;
+
+    // The grid lines follow the floor
+    if (floorDb != tailFloorDb)
+    {
+        tailFloorDb = floorDb;
+        renderBackground();
+    }
+
+    tailDelaySeconds = delaySeconds;
+    tailFeedback = feedback;
+
+    renderTail();
+    repaint(tailArea);
+    return true;
+}
+
+void SharcTelemetryView::paint(juce::Graphics& g)
+{
+    g.drawImageAt(background, 0, 0);
+    g.drawImageAt(trace, historyArea.getX(), historyArea.getY());
+    g.drawImageAt(tail, tailArea.getX(), tailArea.getY());
+}
+
+//==============================================================================
+void SharcTelemetryView::renderBackground()
+{
+    background = juce::Image(juce::Image::RGB, juce::jmax(1, getWidth()), juce::jmax(1, getHeight()), true);
+    juce::Graphics g(background);
+
+    g.fillAll(juce::Colour(0xff1a1d2a));
+    g.setColour(panelColour);
+    g.fillRect(historyArea);
+    g.fillRect(tailArea);
+
+    // Envelope centre line, decay lines every 20 dB above the floor
+    g.setColour(gridColour.withAlpha(0.4f));
+    g.drawHorizontalLine(historyArea.getCentreY(), static_cast<float>(historyArea.getX()), static_cast<float>(historyArea.getRight()));
+
+    for (float db = -20.0f; db > tailFloorDb; db -= 20.0f)
+    {
+        const int y = tailArea.getY() + juce::roundToInt(tailArea.getHeight() * db / tailFloorDb);
+        g.drawHorizontalLine(y, static_cast<float>(tailArea.getX()), static_cast<float>(tailArea.getRight()));
+    }
+
+    g.setColour(juce::Colours::grey);
+    g.setFont(juce::FontOptions(9.0f));
+    g.drawText("IN / OUT", historyArea.reduced(4, 2), juce::Justification::topLeft);
+    g.drawText("DECAY", tailArea.reduced(4, 2), juce::Justification::topRight);
+}
+
+void SharcTelemetryView::renderTail()
+{
+    tail = juce::Image(juce::Image::ARGB, juce::jmax(1, tailArea.getWidth()), juce::jmax(1, tailArea.getHeight()), true);
+
+    if (tailDelaySeconds <= 0.0f)
+        return;
+
+    juce::Graphics g(tail);
+    const float w = static_cast<float>(tail.getWidth());
+    const float h = static_cast<float>(tail.getHeight());
+
+    // Echo k arrives at k * delay with gain feedback^(k - 1); show until
+    // it falls below the floor
+    int echoes = 1;
+
+    if (tailFeedback > 0.0f)
+        echoes = juce::jlimit(1, maxTailEchoes, 1 + static_cast<int>(tailFloorDb / juce::Decibels::gainToDecibels(tailFeedback, -200.0f)));
+
+    juce::Path curve;
+    g.setColour(tailColour);
+
+    for (int k = 1; k <= echoes; ++k)
+    {
+        const float level = juce::Decibels::gainToDecibels(std::pow(tailFeedback, static_cast<float>(k - 1)), tailFloorDb);
+        const float x = w * static_cast<float>(k) / static_cast<float>(echoes + 1);
+        const float y = h * level / tailFloorDb;
+
+        g.drawVerticalLine(juce::roundToInt(x), y, h);
+
+        if (k == 1)
+            curve.startNewSubPath(x, y);
+        else
+            curve.lineTo(x, y);
+    }
+
+    g.setColour(tailColour.withAlpha(0.5f));
+    g.strokePath(curve, juce::PathStrokeType(1.0f));
+
+    g.setColour(juce::Colours::grey);
+    g.setFont(juce::FontOptions(9.0f));
+    g.drawText(juce::String(tailDelaySeconds * static_cast<float>(echoes + 1), 1) + " s", tail.getBounds().reduced(4, 2), juce::Justification::bottomRight);
+}
+
+// Scrolls the trace left by numFrames pixels and draws the new columns
+void SharcTelemetryView::drawColumns(const SharcTelemetryFrame* frames, int numFrames)
+{
+    const int w = trace.getWidth();
+    const int h = trace.getHeight();
+    const int skip = juce::jmax(0, numFrames - w);
+    const int newColumns = numFrames - skip;
+
+    if (newColumns < w)
+        trace.moveImageSection(0, 0, newColumns, 0, w - newColumns, h);
+
+    trace.clear({ w - newColumns, 0, newColumns, h });
+
+    juce::Graphics g(trace);
+    const float mid = static_cast<float>(h) * 0.5f;
+
+    for (int i = 0; i < newColumns; ++i)
+    {
+        const auto& frame = frames[skip + i];
+        const int x = w - newColumns + i;
+
+        auto drawSpan = [&](float level, juce::Colour colour)
+        {
+            const float extent = mid * juce::jmin(1.0f, level);
+            g.setColour(colour);
+            g.drawVerticalLine(x, mid - extent, mid + extent);
+        };
+
+        drawSpan(frame.inputPeak, inputColour);
+        drawSpan(frame.outputPeak, outputColour.withAlpha(0.6f));
+        drawSpan(frame.outputRms, outputColour);
+    }
+}
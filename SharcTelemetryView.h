@@ -0,0 +1,55 @@
+/*
+  SHARC Echo/Delay Effect Plugin - Telemetry View
+  JUCE 8.0.11
+
+  Scrolling input/output level envelope (one pixel column per telemetry
+  frame) next to the predicted feedback decay of the current settings.
+  Drawn from three cached images:
+  - background: panel, grid and labels, rebuilt in resized()
+  - trace: the envelope, scrolled in place; only new columns are drawn
+  - tail: the decay stems, rebuilt when delay, feedback or floor change
+  paint() only blits them. The view is opaque, so its repaints never
+  reach the editor behind it, and it skips repainting a blank trace
+  while the input stays silent.
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "SharcTelemetry.h"
+
+//==============================================================================
+class SharcTelemetryView : public juce::Component
+{
+public:
+    SharcTelemetryView();
+
+    // Message thread (editor timer): drains the FIFO and repaints the
+    // trace. Returns false (no repaint) if nothing visible changed: no
+    // frames, or silence over an already blank trace.
+    bool update(SharcTelemetry& telemetry);
+
+    // Predicted echo decay down to floorDb (the processor's tail estimate);
+    // redrawn only when the values change (returns true then)
+    bool setTail(float delaySeconds, float feedback, float floorDb);
+
+    void paint(juce::Graphics&) override;
+    void resized() override;
+
+private:
+    void renderBackground();
+    void renderTail();
+    void drawColumns(const SharcTelemetryFrame* frames, int numFrames);
+
+    juce::Image background, trace, tail;
+    juce::Rectangle<int> historyArea, tailArea;
+
+    std::array<SharcTelemetryFrame, SharcTelemetry::capacity> incoming;
+    float tailDelaySeconds = -1.0f;
+    float tailFeedback = -1.0f;
+    float tailFloorDb = -96.0f;     // "Tail Floor" default
+
+    // Columns drawn since the last audible one; >= trace width = blank
+    int silentColumns = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SharcTelemetryView)
+};